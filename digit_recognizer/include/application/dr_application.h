@@ -9,6 +9,4 @@ void dr_application_close();
 
 void dr_application_start();
 
-bool dr_application_mnist_to_dataset(const char* images, const char* labels, const char* dataset);
-
 #endif // DR_APPLICATION_H
\ No newline at end of file
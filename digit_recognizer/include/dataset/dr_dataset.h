@@ -0,0 +1,63 @@
+#ifndef DR_DATASET_H
+#define DR_DATASET_H
+
+#include <stdbool.h>
+#include <general/dr_utils.h>
+#include <general/dr_random.h>
+
+#define DR_DATASET_LABELS_COUNT 10
+
+// the smallest capacity allocated by the first addition
+#define DR_DATASET_MIN_CAPACITY 16
+
+// the number of consecutive images kept together by dr_dataset_order_shuffle_blocks, 200 KB of MNIST images
+#define DR_DATASET_SHUFFLE_BLOCK_SIZE 256
+
+// the order of the images in every epoch
+typedef enum {
+    dr_dataset_order_sequential,
+    dr_dataset_order_shuffle,       // <- every image can go after any other one
+    dr_dataset_order_shuffle_blocks // <- the images are gathered from a few blocks at once, which is cache-friendly
+} dr_dataset_order;
+
+// growable set of labeled 8-bit images: the storage doubles when it's full, so adding is O(1) amortized.
+// The pixels of the i-th image are pixels[i * image_size ... (i + 1) * image_size - 1]
+typedef struct {
+    size_t image_size;
+    size_t count;
+    size_t capacity;
+    unsigned char* pixels;
+    unsigned char* labels;
+    size_t labels_counts[DR_DATASET_LABELS_COUNT]; // labels_counts[label] - the number of images with the label
+} dr_dataset;
+
+dr_dataset dr_dataset_create(const size_t image_size);
+
+void dr_dataset_free(dr_dataset* dataset);
+
+// removes all the images, the memory is kept for the next ones
+void dr_dataset_clear(dr_dataset* dataset);
+
+// makes room for capacity images at once, does nothing if there is enough
+void dr_dataset_unchecked_reserve(dr_dataset* dataset, const size_t capacity);
+
+void dr_dataset_reserve(dr_dataset* dataset, const size_t capacity);
+
+void dr_dataset_unchecked_add(dr_dataset* dataset, const unsigned char* pixels, const unsigned char label);
+
+void dr_dataset_add(dr_dataset* dataset, const unsigned char* pixels, const unsigned char label);
+
+const unsigned char* dr_dataset_unchecked_image(const dr_dataset dataset, const size_t index);
+
+const unsigned char* dr_dataset_image(const dr_dataset dataset, const size_t index);
+
+// permutes the indices of the images for the next epoch, indices go in order before the first call
+void dr_dataset_shuffle_indices(
+    const dr_dataset_order order, dr_random* random, size_t* indices, const size_t count);
+
+// appends count images of the converted MNIST file (the number of images, rows and columns as native uint32,
+// then all the pixels and all the labels), returns false if the file can't be read or doesn't match
+// the image size of the dataset. The original IDX files are loaded by dr_dataset_load_idx
+bool dr_dataset_load_mnist(dr_dataset* dataset, const char* file_path, const size_t count);
+
+#endif // DR_DATASET_H
\ No newline at end of file
@@ -0,0 +1,66 @@
+#ifndef DR_DATASET_LOADER_H
+#define DR_DATASET_LOADER_H
+
+#include "dr_dataset.h"
+#include <general/dr_thread.h>
+
+// one batch is trained while the next one is prepared
+#define DR_DATASET_LOADER_BATCHES_COUNT 2
+#define DR_DATASET_LOADER_ALIGNMENT 64
+
+typedef struct {
+    DR_FLOAT_TYPE* pixels; // <- batch_size * image_size converted pixels, aligned to DR_DATASET_LOADER_ALIGNMENT
+    DR_FLOAT_TYPE* outputs_elements;
+    const DR_FLOAT_TYPE** inputs;  // inputs[i] - the pixels of the i-th image
+    const DR_FLOAT_TYPE** outputs; // outputs[i] - the expected output of the i-th image (1 for its label, else 0)
+    size_t count;
+    size_t epoch;
+} dr_dataset_batch;
+
+// The producer thread converts the images of the dataset batch by batch, epoch after epoch, and hands the
+// batches to the consumer through a single producer / single consumer ring. The ring has no locks:
+// the producer only writes produced_count, the consumer only writes consumed_count, the batch
+// produced_count % DR_DATASET_LOADER_BATCHES_COUNT is free while produced_count - consumed_count is less than
+// DR_DATASET_LOADER_BATCHES_COUNT. Only a side that finds the ring full (the producer) or empty (the consumer)
+// sets its waiting flag and sleeps on its wakeup semaphore, the other side posts it after publishing its count
+// if the flag is set. The images of the dataset must not be changed until the loader is freed.
+typedef struct {
+    dr_dataset dataset;
+    DR_FLOAT_TYPE scale;
+    size_t batch_size;
+    size_t epochs_count;
+    dr_dataset_order order;
+    dr_random random;
+    size_t* indices; // <- the order of the images in the current epoch, only the producer uses it
+    dr_dataset_batch batches[DR_DATASET_LOADER_BATCHES_COUNT];
+    dr_atomic_size_t produced_count;
+    dr_atomic_size_t consumed_count;
+    dr_atomic_size_t finished;
+    dr_atomic_size_t stopping;
+    dr_atomic_size_t producer_waiting;
+    dr_atomic_size_t consumer_waiting;
+    dr_semaphore_t producer_wakeup;
+    dr_semaphore_t consumer_wakeup;
+    dr_thread_id_t thread_id;
+    dr_thread_handle_t thread_handle;
+} dr_dataset_loader;
+
+// the pixels are multiplied by scale, the last batch of an epoch can be smaller than batch_size.
+// The images are permuted before every epoch according to order by the generator created from seed
+dr_dataset_loader* dr_dataset_loader_unchecked_create(const dr_dataset dataset, const size_t batch_size,
+    const DR_FLOAT_TYPE scale, const size_t epochs_count, const dr_dataset_order order, const uint64_t seed);
+
+dr_dataset_loader* dr_dataset_loader_create(const dr_dataset dataset, const size_t batch_size,
+    const DR_FLOAT_TYPE scale, const size_t epochs_count, const dr_dataset_order order, const uint64_t seed);
+
+// stops the producer thread if it hasn't finished
+void dr_dataset_loader_free(dr_dataset_loader* loader);
+
+// waits for the next batch, returns NULL when all the epochs have been produced.
+// The batch stays valid until dr_dataset_loader_release
+const dr_dataset_batch* dr_dataset_loader_acquire(dr_dataset_loader* loader);
+
+// gives the acquired batch back to the producer
+void dr_dataset_loader_release(dr_dataset_loader* loader);
+
+#endif // DR_DATASET_LOADER_H
\ No newline at end of file
@@ -0,0 +1,23 @@
+#ifndef DR_IDX_H
+#define DR_IDX_H
+
+#include "dr_dataset.h"
+
+// the files of the original MNIST: the big endian header (the magic, the number of items, the sizes of
+// the dimensions), then the unsigned 8-bit items
+#define DR_IDX_IMAGES_MAGIC 0x00000803
+#define DR_IDX_LABELS_MAGIC 0x00000801
+
+// the size of a single read, the items are read straight to the memory of the dataset
+#define DR_IDX_CHUNK_SIZE (64 * 1024)
+
+// true if the gzip compressed files can be read (the library is built with zlib)
+bool dr_idx_gzip_supported();
+
+// appends the first count images of the IDX images file and their labels from the IDX labels file.
+// The files can be gzip compressed if dr_idx_gzip_supported. Returns false if a file can't be read,
+// the images don't match the image size of the dataset or there are less than count of them
+bool dr_dataset_load_idx(
+    dr_dataset* dataset, const char* images_file_path, const char* labels_file_path, const size_t count);
+
+#endif // DR_IDX_H
\ No newline at end of file
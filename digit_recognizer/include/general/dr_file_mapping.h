@@ -0,0 +1,22 @@
+#ifndef DR_FILE_MAPPING_H
+#define DR_FILE_MAPPING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// read-only view of a whole file, the pages are shared with every other process mapping the same file
+typedef struct {
+    const void* data;
+    size_t size;
+#ifdef _WIN32
+    void* file_handle;
+    void* mapping_handle;
+#endif // _WIN32
+} dr_file_mapping;
+
+// returns false if the file can't be opened, is empty or can't be mapped
+bool dr_file_mapping_open(dr_file_mapping* mapping, const char* file_path);
+
+void dr_file_mapping_close(dr_file_mapping* mapping);
+
+#endif // DR_FILE_MAPPING_H
\ No newline at end of file
@@ -0,0 +1,40 @@
+#ifndef DR_METRICS_H
+#define DR_METRICS_H
+
+#include "dr_thread.h"
+
+// the progress of the training published for the other threads
+typedef struct {
+    size_t epoch;         // <- from 0
+    size_t epochs_count;
+    size_t images_count;  // <- trained since the start
+    double error;         // <- the average error of the last trained images
+    double images_per_second;
+} dr_training_metrics;
+
+#define DR_METRICS_WORDS_COUNT ((sizeof(dr_training_metrics) + sizeof(size_t) - 1) / sizeof(size_t))
+
+// Seqlock: a single writer publishes the snapshots, any number of readers copy them without locks.
+// The sequence is odd while the writer copies a snapshot, a reader retries if the sequence was odd
+// or has changed during its copy, so it never gets a torn snapshot and never blocks the writer.
+typedef struct {
+    dr_atomic_size_t sequence;
+    dr_atomic_size_t words[DR_METRICS_WORDS_COUNT];
+    double publish_interval; // <- seconds
+    double last_publish_time;
+} dr_metrics_channel;
+
+// the throttled publications come at most every publish_interval seconds
+void dr_metrics_channel_init(dr_metrics_channel* channel, const double publish_interval);
+
+// the writer only
+void dr_metrics_channel_publish(dr_metrics_channel* channel, const dr_training_metrics* metrics);
+
+// the writer only, skips the snapshot if the last one is younger than the publish interval,
+// returns true if the snapshot has been published
+bool dr_metrics_channel_publish_throttled(dr_metrics_channel* channel, const dr_training_metrics* metrics);
+
+// any thread, the metrics are zero until the first publication
+void dr_metrics_channel_read(const dr_metrics_channel* channel, dr_training_metrics* metrics);
+
+#endif // DR_METRICS_H
\ No newline at end of file
@@ -0,0 +1,88 @@
+#ifndef DR_PARALLEL_H
+#define DR_PARALLEL_H
+
+#include "dr_thread_pool.h"
+#include "dr_random.h"
+
+// the capacity of the deque of every worker, a fork into the full deque runs the task at once
+#define DR_PARALLEL_DEQUE_CAPACITY 1024
+
+// the failed attempts to find a task before the worker goes to sleep
+#define DR_PARALLEL_SPIN_COUNT 64
+
+// the task is owned by the thread that forks it and lives until the join, usually on its stack
+typedef struct dr_parallel_task {
+    dr_task_function function;
+    void* data;
+    dr_atomic_size_t done;
+    struct dr_parallel_task* next; // <- the queue of the tasks forked by the threads outside the scheduler
+} dr_parallel_task;
+
+struct dr_parallel_scheduler;
+
+// Chase-Lev deque: the owner pushes and takes the tasks at the bottom, the thieves steal them from the top
+typedef struct {
+    struct dr_parallel_scheduler* scheduler;
+    dr_parallel_task* volatile* tasks; // <- ring buffer of DR_PARALLEL_DEQUE_CAPACITY
+    dr_atomic_size_t top;
+    dr_atomic_size_t bottom;
+    dr_random random; // <- chooses the victims
+} dr_parallel_worker;
+
+// Work-stealing fork/join scheduler. A forked task goes to the deque of the current worker, the idle workers
+// steal the oldest (the largest) tasks of the others. A thread joining a task that hasn't finished runs
+// the other tasks in the meantime, so the nested parallel loops (a parallel GEMM inside a parallel training
+// step) share the same workers instead of oversubscribing the cores or waiting on each other.
+// The threads outside the scheduler fork the tasks into a shared queue and help the workers when they join.
+typedef struct dr_parallel_scheduler {
+    size_t workers_count;
+    dr_parallel_worker* workers;
+    dr_thread_id_t* threads_ids;
+    dr_thread_handle_t* threads_handles;
+    dr_mutex_t mutex; // <- guards the queue of the outside tasks
+    dr_parallel_task* outside_first;
+    dr_parallel_task* outside_last;
+    dr_atomic_size_t outside_count;
+    dr_atomic_size_t steal_counter; // <- chooses the victims of the outside threads
+    dr_semaphore_t semaphore;
+    dr_atomic_size_t sleeping_count;
+    dr_atomic_size_t stopping;
+} dr_parallel_scheduler;
+
+// workers_count threads besides the calling one, 0 is allowed (the joining threads run every task)
+dr_parallel_scheduler* dr_parallel_scheduler_create(const size_t workers_count);
+
+// every forked task must be joined before
+void dr_parallel_scheduler_free(dr_parallel_scheduler* scheduler);
+
+// the scheduler shared by the library, created on the first call with dr_thread_hardware_concurrency() - 1
+// workers
+dr_parallel_scheduler* dr_parallel_scheduler_get_default();
+
+// replaces the default scheduler (NULL brings back the lazy creation) and returns the previous one (can be NULL),
+// it has to be called when nothing runs on the default scheduler, the previous scheduler isn't freed
+dr_parallel_scheduler* dr_parallel_scheduler_set_default(dr_parallel_scheduler* scheduler);
+
+void dr_parallel_task_init(dr_parallel_task* task, dr_task_function function, void* data);
+
+bool dr_parallel_task_done(const dr_parallel_task* task);
+
+// the task may run on any worker from now on, it has to be joined
+void dr_parallel_unchecked_fork(dr_parallel_scheduler* scheduler, dr_parallel_task* task);
+
+void dr_parallel_fork(dr_parallel_scheduler* scheduler, dr_parallel_task* task);
+
+// runs the task itself if nobody has stolen it, otherwise runs the other tasks until it's done
+void dr_parallel_unchecked_join(dr_parallel_scheduler* scheduler, dr_parallel_task* task);
+
+void dr_parallel_join(dr_parallel_scheduler* scheduler, dr_parallel_task* task);
+
+// the range is halved recursively: one half is forked, the other one runs on the current thread,
+// the halves of at most grain_size elements are passed to function
+void dr_parallel_unchecked_for(dr_parallel_scheduler* scheduler, const size_t begin, const size_t end,
+    const size_t grain_size, dr_parallel_for_function function, void* data);
+
+void dr_parallel_for(dr_parallel_scheduler* scheduler, const size_t begin, const size_t end,
+    const size_t grain_size, dr_parallel_for_function function, void* data);
+
+#endif // DR_PARALLEL_H
\ No newline at end of file
@@ -0,0 +1,28 @@
+#ifndef DR_RANDOM_H
+#define DR_RANDOM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// xoshiro256** generator, every thread owns its state, so no locks are needed.
+// The same seed gives the same sequence on every platform
+typedef struct {
+    uint64_t state[4];
+} dr_random;
+
+dr_random dr_random_create(const uint64_t seed);
+
+uint64_t dr_random_next(dr_random* random);
+
+// uniform in [0, bound), bound must not be zero
+size_t dr_random_below(dr_random* random, const size_t bound);
+
+// Fisher-Yates permutation of the indices in place
+void dr_random_shuffle(dr_random* random, size_t* indices, const size_t count);
+
+// permutes the blocks of block_size indices and the indices inside every block. The blocks stay the same,
+// so if the indices go in order at the start, every block refers to the consecutive items in memory.
+// The last block is shorter if count isn't a multiple of block_size, it is permuted only inside
+void dr_random_shuffle_blocks(dr_random* random, size_t* indices, const size_t count, const size_t block_size);
+
+#endif // DR_RANDOM_H
\ No newline at end of file
@@ -0,0 +1,237 @@
+#ifndef DR_THREAD_H
+#define DR_THREAD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef _WIN32
+  typedef uint32_t dr_thread_id_t;
+  typedef uint32_t dr_thread_function_result_t;
+  typedef void*    dr_thread_handle_t;
+  typedef void*    dr_mutex_t;
+  typedef void*    dr_barrier_t;
+  typedef void*    dr_semaphore_t;
+#else
+  #include <pthread.h>
+  typedef pthread_t       dr_thread_id_t;
+  typedef void*           dr_thread_function_result_t;
+  typedef int             dr_thread_handle_t;
+  typedef pthread_mutex_t dr_mutex_t;
+  typedef struct {
+      pthread_mutex_t mutex;
+      pthread_cond_t condition;
+      size_t count;
+      size_t waiting;
+      size_t generation;
+  } dr_barrier_t;
+  typedef struct {
+      pthread_mutex_t mutex;
+      pthread_cond_t condition;
+      size_t count;
+  } dr_semaphore_t;
+#endif // _WIN32
+
+#ifdef _WIN32
+  #define DR_WINAPI __stdcall
+#else
+  #define DR_WINAPI
+#endif // _WIN32
+
+typedef dr_thread_function_result_t(DR_WINAPI *dr_thread_function_t)(void*);
+
+// every thread has its own instance of the static variable
+#ifdef _MSC_VER
+  #define DR_THREAD_LOCAL __declspec(thread)
+#else
+  #define DR_THREAD_LOCAL __thread
+#endif // _MSC_VER
+
+// the value shared between threads without locks, it is accessed only with the dr_atomic functions
+typedef volatile size_t dr_atomic_size_t;
+
+#ifdef _MSC_VER
+  #include <intrin.h>
+#endif // _MSC_VER
+
+#if defined(_MSC_VER) && !defined(_M_IX86) && !defined(_M_X64)
+// arm reorders plain loads and stores, so the acquire and release need a barrier
+static inline void dr_thread_details_barrier(void) {
+# ifdef _M_ARM64
+    __dmb(_ARM64_BARRIER_ISH);
+# else
+    __dmb(_ARM_BARRIER_ISH);
+# endif // _M_ARM64
+}
+
+// __iso_volatile accesses don't depend on the /volatile:ms semantics
+static inline size_t dr_thread_details_load(const volatile void* atomic) {
+# ifdef _WIN64
+    return (size_t)__iso_volatile_load64((const volatile __int64*)atomic);
+# else
+    return (size_t)__iso_volatile_load32((const volatile __int32*)atomic);
+# endif // _WIN64
+}
+
+static inline void dr_thread_details_store(volatile void* atomic, const size_t value) {
+# ifdef _WIN64
+    __iso_volatile_store64((volatile __int64*)atomic, (__int64)value);
+# else
+    __iso_volatile_store32((volatile __int32*)atomic, (__int32)value);
+# endif // _WIN64
+}
+#endif // _MSC_VER && !_M_IX86 && !_M_X64
+
+// the writes made before the release store are visible to the thread that has read the value with the acquire load
+static inline size_t dr_atomic_load_acquire(const dr_atomic_size_t* atomic) {
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+    // volatile accesses have the acquire and release semantics on x86 and x64
+    const size_t value = *atomic;
+    _ReadWriteBarrier();
+    return value;
+#elif defined(_MSC_VER)
+    const size_t value = dr_thread_details_load(atomic);
+    dr_thread_details_barrier();
+    return value;
+#else
+    return __atomic_load_n(atomic, __ATOMIC_ACQUIRE);
+#endif // _MSC_VER
+}
+
+static inline void dr_atomic_store_release(dr_atomic_size_t* atomic, const size_t value) {
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+    _ReadWriteBarrier();
+    *atomic = value;
+#elif defined(_MSC_VER)
+    dr_thread_details_barrier();
+    dr_thread_details_store(atomic, value);
+#else
+    __atomic_store_n(atomic, value, __ATOMIC_RELEASE);
+#endif // _MSC_VER
+}
+
+static inline void* dr_atomic_load_pointer_acquire(void* const volatile* atomic) {
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+    void* const value = *atomic;
+    _ReadWriteBarrier();
+    return value;
+#elif defined(_MSC_VER)
+    void* const value = (void*)dr_thread_details_load(atomic);
+    dr_thread_details_barrier();
+    return value;
+#else
+    return __atomic_load_n(atomic, __ATOMIC_ACQUIRE);
+#endif // _MSC_VER
+}
+
+static inline void dr_atomic_store_pointer_release(void* volatile* atomic, void* value) {
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+    _ReadWriteBarrier();
+    *atomic = value;
+#elif defined(_MSC_VER)
+    dr_thread_details_barrier();
+    dr_thread_details_store(atomic, (size_t)value);
+#else
+    __atomic_store_n(atomic, value, __ATOMIC_RELEASE);
+#endif // _MSC_VER
+}
+
+// returns the value before the addition, sequentially consistent
+static inline size_t dr_atomic_fetch_add(dr_atomic_size_t* atomic, const size_t value) {
+#if defined(_MSC_VER) && defined(_WIN64)
+    return (size_t)_InterlockedExchangeAdd64((volatile __int64*)atomic, (__int64)value);
+#elif defined(_MSC_VER)
+    return (size_t)_InterlockedExchangeAdd((volatile long*)atomic, (long)value);
+#else
+    return __atomic_fetch_add(atomic, value, __ATOMIC_SEQ_CST);
+#endif // _MSC_VER
+}
+
+// stores the value and returns the previous one, sequentially consistent
+static inline size_t dr_atomic_exchange(dr_atomic_size_t* atomic, const size_t value) {
+#if defined(_MSC_VER) && defined(_WIN64)
+    return (size_t)_InterlockedExchange64((volatile __int64*)atomic, (__int64)value);
+#elif defined(_MSC_VER)
+    return (size_t)_InterlockedExchange((volatile long*)atomic, (long)value);
+#else
+    return __atomic_exchange_n(atomic, value, __ATOMIC_SEQ_CST);
+#endif // _MSC_VER
+}
+
+// stores desired if the value equals expected, sequentially consistent
+static inline bool dr_atomic_compare_exchange(dr_atomic_size_t* atomic, size_t expected, const size_t desired) {
+#if defined(_MSC_VER) && defined(_WIN64)
+    return (size_t)_InterlockedCompareExchange64(
+        (volatile __int64*)atomic, (__int64)desired, (__int64)expected) == expected;
+#elif defined(_MSC_VER)
+    return (size_t)_InterlockedCompareExchange((volatile long*)atomic, (long)desired, (long)expected) == expected;
+#else
+    return __atomic_compare_exchange_n(atomic, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#endif // _MSC_VER
+}
+
+static inline bool dr_atomic_compare_exchange_pointer(void* volatile* atomic, void* expected, void* desired) {
+#ifdef _MSC_VER
+    return _InterlockedCompareExchangePointer(atomic, desired, expected) == expected;
+#else
+    return __atomic_compare_exchange_n(atomic, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#endif // _MSC_VER
+}
+
+// sequentially consistent fence: the store before it can't be reordered with the load after it
+static inline void dr_atomic_thread_fence() {
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+    _ReadWriteBarrier();
+    _mm_mfence();
+#elif defined(_MSC_VER)
+    dr_thread_details_barrier();
+#else
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+#endif // _MSC_VER
+}
+
+dr_thread_handle_t dr_thread_create(dr_thread_id_t* thread_id, dr_thread_function_t thread_function);
+
+dr_thread_handle_t dr_thread_create_with_data(
+    dr_thread_id_t* thread_id, dr_thread_function_t thread_function, void* data);
+
+bool dr_check_thread_handle(const dr_thread_handle_t thread_handle);
+
+bool dr_thread_join(dr_thread_handle_t thread_handle, dr_thread_id_t thread_id);
+
+bool dr_thread_close(dr_thread_handle_t thread_handle);
+
+// gives the rest of the time slice to the other threads
+void dr_thread_yield();
+
+// the number of the logical processors, at least 1
+size_t dr_thread_hardware_concurrency();
+
+dr_mutex_t dr_mutex_create();
+
+bool dr_check_mutex(const dr_mutex_t mutex);
+
+bool dr_mutex_lock(dr_mutex_t* mutex);
+
+bool dr_mutex_unlock(dr_mutex_t* mutex);
+
+bool dr_mutex_close(dr_mutex_t mutex);
+
+// the barrier releases the waiting threads when count threads have reached it, it can be reused
+bool dr_barrier_create(dr_barrier_t* barrier, const size_t count);
+
+bool dr_barrier_wait(dr_barrier_t* barrier);
+
+bool dr_barrier_close(dr_barrier_t* barrier);
+
+// counting semaphore: wait blocks while the count is zero, then decrements it
+bool dr_semaphore_create(dr_semaphore_t* semaphore, const size_t count);
+
+bool dr_semaphore_wait(dr_semaphore_t* semaphore);
+
+// adds count to the count of the semaphore, releasing up to count waiting threads
+bool dr_semaphore_post(dr_semaphore_t* semaphore, const size_t count);
+
+bool dr_semaphore_close(dr_semaphore_t* semaphore);
+
+#endif // DR_THREAD_H
\ No newline at end of file
@@ -0,0 +1,77 @@
+#ifndef DR_THREAD_POOL_H
+#define DR_THREAD_POOL_H
+
+#include "dr_thread.h"
+
+// the initial capacity of the tasks queue, it grows twice when it's full
+#define DR_THREAD_POOL_MIN_TASKS_CAPACITY 64
+
+typedef void(*dr_task_function)(void* data);
+
+// for i in [begin, end) split into chunks, each call gets a chunk
+typedef void(*dr_parallel_for_function)(void* data, const size_t begin, const size_t end);
+
+// set when the task has finished, the owner keeps the future alive until then
+typedef struct {
+    dr_atomic_size_t done;
+} dr_future;
+
+typedef struct {
+    dr_task_function function;
+    void* data;
+    dr_future* future;
+} dr_task;
+
+// Persistent workers taking the tasks from a FIFO queue. The semaphore counts the queued tasks,
+// the waiting threads (dr_future_wait, dr_thread_pool_parallel_for) run the queued tasks themselves,
+// so the tasks can submit and wait for other tasks without deadlocks. The pool is meant for independent tasks
+// with futures, the nested fork/join loops (GEMM, training) run on the work-stealing scheduler of dr_parallel.h
+typedef struct {
+    size_t threads_count;
+    dr_thread_id_t* threads_ids;
+    dr_thread_handle_t* threads_handles;
+    dr_mutex_t mutex;
+    dr_semaphore_t semaphore;
+    dr_task* tasks; // <- ring buffer
+    size_t tasks_capacity;
+    size_t tasks_begin;
+    size_t tasks_count;
+    bool stopping;
+} dr_thread_pool;
+
+// threads_count workers besides the calling thread, 0 is allowed (the waiting threads run all the tasks)
+dr_thread_pool* dr_thread_pool_create(const size_t threads_count);
+
+// runs the queued tasks and stops the workers
+void dr_thread_pool_free(dr_thread_pool* pool);
+
+// the pool shared by the library, created on the first call with dr_thread_hardware_concurrency() - 1 workers,
+// so together with the calling thread every processor is busy
+dr_thread_pool* dr_thread_pool_get_default();
+
+// future can be NULL
+void dr_thread_pool_unchecked_submit(
+    dr_thread_pool* pool, dr_task_function function, void* data, dr_future* future);
+
+void dr_thread_pool_submit(dr_thread_pool* pool, dr_task_function function, void* data, dr_future* future);
+
+// runs a single queued task if there is one, returns false if the queue is empty
+bool dr_thread_pool_run_pending_task(dr_thread_pool* pool);
+
+void dr_future_init(dr_future* future);
+
+bool dr_future_ready(const dr_future* future);
+
+// runs the queued tasks of the pool until the task of the future has finished
+void dr_future_wait(dr_future* future, dr_thread_pool* pool);
+
+// calls function on the chunks of grain_size (the last one can be smaller) from the workers and
+// the calling thread, returns when every chunk is done. The chunks are taken one by one, so the faster
+// threads take more of them
+void dr_thread_pool_unchecked_parallel_for(dr_thread_pool* pool, const size_t begin, const size_t end,
+    const size_t grain_size, dr_parallel_for_function function, void* data);
+
+void dr_thread_pool_parallel_for(dr_thread_pool* pool, const size_t begin, const size_t end,
+    const size_t grain_size, dr_parallel_for_function function, void* data);
+
+#endif // DR_THREAD_POOL_H
\ No newline at end of file
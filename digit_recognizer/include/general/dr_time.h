@@ -0,0 +1,7 @@
+#ifndef DR_TIME_H
+#define DR_TIME_H
+
+// monotonic time in seconds from an unspecified point, only the differences make sense
+double dr_time_seconds();
+
+#endif // DR_TIME_H
\ No newline at end of file
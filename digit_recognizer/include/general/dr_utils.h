@@ -6,6 +6,7 @@
 #include <string.h>
 #include <stdarg.h>
 #include <assert.h>
+#include <stdint.h>
 
 #define DR_FLOAT_TYPE float
 #define DR_STR_BUFFER_SIZE 256
@@ -13,7 +14,7 @@
 static inline void dr_print_error(const char* format, ...) {
     va_list args;
     va_start(args, format);
-    fprintf(stderr, format, args);
+    vfprintf(stderr, format, args);
     va_end(args);
 }
 
@@ -57,6 +58,25 @@ static inline void* dr_realloc(void* ptr, const size_t size) {
 
 #define DR_ARRAY_LENGTH(array) (sizeof(array) / sizeof(*array))
 
+// alignment is a power of two, the memory is freed by dr_aligned_free
+static inline void* dr_aligned_malloc(const size_t size, const size_t alignment) {
+    // the pointer returned by DR_MALLOC is stored right before the aligned block
+    unsigned char* ptr = (unsigned char*)DR_MALLOC(size + alignment - 1 + sizeof(void*));
+    if (!ptr) {
+        return NULL;
+    }
+    const uintptr_t aligned_address = ((uintptr_t)(ptr + sizeof(void*)) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    void** aligned_ptr = (void**)aligned_address;
+    aligned_ptr[-1] = ptr;
+    return aligned_ptr;
+}
+
+static inline void dr_aligned_free(void* ptr) {
+    if (ptr) {
+        DR_FREE(((void**)ptr)[-1]);
+    }
+}
+
 static inline size_t dr_size_t_len(size_t number) {
     size_t len = 0;
     do {
@@ -77,10 +77,27 @@ void dr_matrix_unchecked_dot_write(const dr_matrix left, const dr_matrix right,
 
 void dr_matrix_dot_write(const dr_matrix left, const dr_matrix right, dr_matrix result);
 
+// result = alpha * op(left) * op(right) + beta * result, where op(X) is X or X^T (read in place, without a copy)
+void dr_matrix_unchecked_dot_write_ex(const dr_matrix left, const bool left_transposed,
+    const dr_matrix right, const bool right_transposed,
+    const DR_FLOAT_TYPE alpha, const DR_FLOAT_TYPE beta, dr_matrix result);
+
+void dr_matrix_dot_write_ex(const dr_matrix left, const bool left_transposed,
+    const dr_matrix right, const bool right_transposed,
+    const DR_FLOAT_TYPE alpha, const DR_FLOAT_TYPE beta, dr_matrix result);
+
 dr_matrix dr_matrix_unchecked_dot_create(const dr_matrix left, const dr_matrix right);
 
 dr_matrix dr_matrix_dot_create(const dr_matrix left, const dr_matrix right);
 
+void dr_matrix_unchecked_gemv_write(const dr_matrix matrix, const dr_matrix vector, dr_matrix result);
+
+void dr_matrix_gemv_write(const dr_matrix matrix, const dr_matrix vector, dr_matrix result);
+
+dr_matrix dr_matrix_unchecked_gemv_create(const dr_matrix matrix, const dr_matrix vector);
+
+dr_matrix dr_matrix_gemv_create(const dr_matrix matrix, const dr_matrix vector);
+
 void dr_matrix_unchecked_scale_write(const dr_matrix matrix, const DR_FLOAT_TYPE value, dr_matrix result);
 
 void dr_matrix_scale_write(const dr_matrix matrix, const DR_FLOAT_TYPE value, dr_matrix result);
@@ -0,0 +1,69 @@
+#ifndef DR_MATRIX_KERNELS_H
+#define DR_MATRIX_KERNELS_H
+
+#include <stdbool.h>
+#include <general/dr_utils.h>
+
+typedef enum {
+    dr_matrix_kernels_isa_scalar,
+    dr_matrix_kernels_isa_sse2,
+    dr_matrix_kernels_isa_avx2,
+    dr_matrix_kernels_isa_avx512
+} dr_matrix_kernels_isa;
+
+typedef void(*dr_matrix_kernel_fill)(DR_FLOAT_TYPE* result, const DR_FLOAT_TYPE value, const size_t size);
+typedef void(*dr_matrix_kernel_binary)(
+    const DR_FLOAT_TYPE* left, const DR_FLOAT_TYPE* right, DR_FLOAT_TYPE* result, const size_t size);
+typedef void(*dr_matrix_kernel_scale)(
+    const DR_FLOAT_TYPE* array, const DR_FLOAT_TYPE value, DR_FLOAT_TYPE* result, const size_t size);
+typedef DR_FLOAT_TYPE(*dr_matrix_kernel_dot)(const DR_FLOAT_TYPE* left, const DR_FLOAT_TYPE* right, const size_t size);
+// result += alpha * array
+typedef void(*dr_matrix_kernel_axpy)(
+    const DR_FLOAT_TYPE alpha, const DR_FLOAT_TYPE* array, DR_FLOAT_TYPE* result, const size_t size);
+// result = bytes * scale, converts the unsigned 8-bit pixels of the datasets
+typedef void(*dr_matrix_kernel_bytes_to_floats)(
+    const unsigned char* bytes, const DR_FLOAT_TYPE scale, DR_FLOAT_TYPE* result, const size_t size);
+// result = f(array) for the activation functions of the neural networks and their derivatives (result can be array),
+// the vector kernels compute exp with a polynomial, sigmoid and tanh are within 1e-6 of the exact values
+typedef void(*dr_matrix_kernel_unary)(const DR_FLOAT_TYPE* array, DR_FLOAT_TYPE* result, const size_t size);
+
+// the register tile of the GEMM micro-kernel
+#define DR_MATRIX_KERNELS_GEMM_MR 4
+#define DR_MATRIX_KERNELS_GEMM_NR 8
+// tile (MR x NR, row by row) = packed_A (MR rows stored column by column) * packed_B (NR columns stored row by row)
+typedef void(*dr_matrix_kernel_gemm_tile)(
+    const size_t kc, const DR_FLOAT_TYPE* packed_A, const DR_FLOAT_TYPE* packed_B, DR_FLOAT_TYPE* tile);
+
+typedef struct {
+    dr_matrix_kernels_isa isa;
+    dr_matrix_kernel_fill fill;
+    dr_matrix_kernel_binary multiplication;
+    dr_matrix_kernel_binary addition;
+    dr_matrix_kernel_binary subtraction;
+    dr_matrix_kernel_scale scale;
+    dr_matrix_kernel_dot dot;
+    dr_matrix_kernel_axpy axpy;
+    dr_matrix_kernel_gemm_tile gemm_tile;
+    dr_matrix_kernel_bytes_to_floats bytes_to_floats;
+    dr_matrix_kernel_unary sigmoid;
+    dr_matrix_kernel_unary sigmoid_derivative; // <- of the sigmoid outputs, as the other derivatives
+    dr_matrix_kernel_unary tanh;
+    dr_matrix_kernel_unary tanh_derivative;
+    dr_matrix_kernel_unary relu;
+    dr_matrix_kernel_unary relu_derivative;
+} dr_matrix_kernels;
+
+// the best instruction set supported by the CPU (and the compiler) the library was built with
+dr_matrix_kernels_isa dr_matrix_kernels_detect_isa();
+
+bool dr_matrix_kernels_isa_supported(const dr_matrix_kernels_isa isa);
+
+const char* dr_matrix_kernels_isa_to_string(const dr_matrix_kernels_isa isa);
+
+// forces the kernels of the specified instruction set, returns false if the CPU doesn't support it
+bool dr_matrix_kernels_select(const dr_matrix_kernels_isa isa);
+
+// kernels are selected on the first call according to dr_matrix_kernels_detect_isa
+const dr_matrix_kernels* dr_matrix_kernels_get();
+
+#endif // DR_MATRIX_KERNELS_H
\ No newline at end of file
@@ -3,8 +3,11 @@
 
 #include <math.h>
 #include "dr_matrix.h"
+#include <general/dr_file_mapping.h>
 
 typedef DR_FLOAT_TYPE(*dr_activation_function)(DR_FLOAT_TYPE);
+// applies an activation function (or a derivative) to the whole array, result can be values
+typedef void(*dr_activation_function_array)(const DR_FLOAT_TYPE* values, DR_FLOAT_TYPE* result, const size_t size);
 typedef char*(*dr_activation_function_to_string_callback)(const dr_activation_function);
 typedef dr_activation_function(*dr_activation_function_from_string_callback)(const char*);
 
@@ -15,29 +18,94 @@ typedef struct {
     dr_matrix* connections;
     dr_activation_function* activation_functions;
     dr_activation_function* activation_functions_derivatives;
+    dr_file_mapping* mapping; // not NULL if the connections are a read-only view of a file
 } dr_neural_network;
 
+// activations of a single inference, the weights are only read, so any number of threads can predict
+// with the same neural network at once, each with its own context
+typedef struct {
+    size_t layers_count;
+    dr_matrix* layers;
+} dr_inference_context;
+
+typedef struct {
+    size_t images_count;
+    size_t threads_count;
+    double seconds;
+    double images_per_second;
+} dr_prediction_stats;
+
+// buffers used by back propagation, allocated once for the topology of the network,
+// so the training steps do no heap allocations
+typedef struct {
+    size_t layers_count;
+    dr_matrix* errors; // errors[i] - the error of layers[i], errors[0] is not used
+    DR_FLOAT_TYPE* output;
+} dr_training_workspace;
+
+// buffers used by the mini-batch training: layers[i] and errors[i] are height x batch_size matrices,
+// the j-th column holds the values of the j-th sample of the batch
+typedef struct {
+    size_t layers_count;
+    size_t batch_size;
+    dr_matrix* layers;
+    dr_matrix* errors; // errors[0] is not used
+} dr_batch_workspace;
+
 static const char DR_NEURAL_NETWORK_BEGIN_STR[] = "DR_NEURAL_NETWORK_BEGIN";
 static const char DR_NEURAL_NETWORK_END_STR[]   = "DR_NEURAL_NETWORK_END";
 
+// binary format, all the numbers are little-endian:
+// magic (4 bytes), version (u32), element size in bytes (u32), layers count (u32), layers sizes (u32 each),
+// activation function and activation function derivative ids of every connection (u32 each), then the elements
+// of every connection row by row, each connection starts at an offset aligned to DR_NEURAL_NETWORK_BINARY_ALIGNMENT
+static const char DR_NEURAL_NETWORK_BINARY_MAGIC[] = "DRNN";
+#define DR_NEURAL_NETWORK_BINARY_VERSION   1
+#define DR_NEURAL_NETWORK_BINARY_ALIGNMENT 64
+
+// stable ids of the default activation functions, used by the binary format
+typedef enum {
+    dr_activation_function_id_none,
+    dr_activation_function_id_sigmoid,
+    dr_activation_function_id_sigmoid_derivative,
+    dr_activation_function_id_tanh,
+    dr_activation_function_id_tanh_derivative,
+    dr_activation_function_id_relu,
+    dr_activation_function_id_relu_derivative
+} dr_activation_function_id;
+
 static const char DR_SIGMOID_STR[] = "DR_SIGMOID";
 DR_FLOAT_TYPE dr_sigmoid(const DR_FLOAT_TYPE value);
 
+// exp is approximated by a polynomial in the vector kernels, the results are within 1e-6 of dr_sigmoid
+void dr_sigmoid_array(const DR_FLOAT_TYPE* values, DR_FLOAT_TYPE* result, const size_t size);
+
 static const char DR_SIGMOID_DERIVATIVE_STR[] = "DR_SIGMOID_DERIVATIVE";
 DR_FLOAT_TYPE dr_sigmoid_derivative(const DR_FLOAT_TYPE value);
 
+void dr_sigmoid_derivative_array(const DR_FLOAT_TYPE* values, DR_FLOAT_TYPE* result, const size_t size);
+
 static const char DR_TANH_STR[] = "DR_TANH";
 DR_FLOAT_TYPE dr_tanh(const DR_FLOAT_TYPE value);
 
+// within 1e-6 of dr_tanh
+void dr_tanh_array(const DR_FLOAT_TYPE* values, DR_FLOAT_TYPE* result, const size_t size);
+
 static const char DR_TANH_DERIVATIVE_STR[] = "DR_TANH_DERIVATIVE";
 DR_FLOAT_TYPE dr_tanh_derivative(const DR_FLOAT_TYPE value);
 
+void dr_tanh_derivative_array(const DR_FLOAT_TYPE* values, DR_FLOAT_TYPE* result, const size_t size);
+
 static const char DR_RELU_STR[] = "DR_RELU";
 DR_FLOAT_TYPE dr_relu(const DR_FLOAT_TYPE value);
 
+void dr_relu_array(const DR_FLOAT_TYPE* values, DR_FLOAT_TYPE* result, const size_t size);
+
 static const char DR_RELU_DERIVATIVE_STR[] = "DR_RELU_DERIVATIVE";
 DR_FLOAT_TYPE dr_relu_derivative(const DR_FLOAT_TYPE value);
 
+void dr_relu_derivative_array(const DR_FLOAT_TYPE* values, DR_FLOAT_TYPE* result, const size_t size);
+
 char* dr_default_activation_function_to_string(const dr_activation_function activation_function);
 
 dr_activation_function dr_default_activation_function_from_string(const char* string);
@@ -46,6 +114,15 @@ char* dr_default_activation_function_derivative_to_string(const dr_activation_fu
 
 dr_activation_function dr_default_activation_function_derivative_from_string(const char* string);
 
+// works for the activation functions and their derivatives, returns dr_activation_function_id_none for unknown ones
+dr_activation_function_id dr_default_activation_function_to_id(const dr_activation_function activation_function);
+
+dr_activation_function dr_default_activation_function_from_id(const dr_activation_function_id id);
+
+// the array version of a default activation function or derivative, the neural network applies the layers with it,
+// returns NULL for the other functions, they are applied element by element
+dr_activation_function_array dr_default_activation_function_to_array(const dr_activation_function activation_function);
+
 bool dr_neural_network_valid(const dr_neural_network neural_network);
 
 dr_neural_network dr_neural_network_create(
@@ -77,6 +154,13 @@ void dr_neural_network_unchecked_set_input(dr_neural_network neural_network, con
 
 void dr_neural_network_set_input(dr_neural_network neural_network, const DR_FLOAT_TYPE* input);
 
+// the input layer = input * scale, the 8-bit pixels of a dataset are converted while they are copied
+void dr_neural_network_unchecked_set_input_bytes(
+    dr_neural_network neural_network, const unsigned char* input, const DR_FLOAT_TYPE scale);
+
+void dr_neural_network_set_input_bytes(
+    dr_neural_network neural_network, const unsigned char* input, const DR_FLOAT_TYPE scale);
+
 void dr_neural_network_unchecked_get_output(const dr_neural_network neural_network, DR_FLOAT_TYPE* output);
 
 void dr_neural_network_get_output(const dr_neural_network neural_network, DR_FLOAT_TYPE* output);
@@ -85,12 +169,64 @@ void dr_neural_network_unchecked_forward_propagation(dr_neural_network neural_ne
 
 void dr_neural_network_forward_propagation(dr_neural_network neural_network);
 
+dr_training_workspace dr_training_workspace_unchecked_create(const dr_neural_network neural_network);
+
+dr_training_workspace dr_training_workspace_create(const dr_neural_network neural_network);
+
+bool dr_training_workspace_compatible(
+    const dr_training_workspace training_workspace, const dr_neural_network neural_network);
+
+void dr_training_workspace_free(dr_training_workspace* training_workspace);
+
+void dr_neural_network_unchecked_back_propagation_workspace(dr_neural_network neural_network,
+    dr_training_workspace training_workspace, const DR_FLOAT_TYPE learning_rate, const DR_FLOAT_TYPE* output_errors);
+
+void dr_neural_network_back_propagation_workspace(dr_neural_network neural_network,
+    dr_training_workspace training_workspace, const DR_FLOAT_TYPE learning_rate, const DR_FLOAT_TYPE* output_errors);
+
 void dr_neural_network_unchecked_back_propagation(
     dr_neural_network neural_network, const DR_FLOAT_TYPE learning_rate, const DR_FLOAT_TYPE* output_errors);
 
 void dr_neural_network_back_propagation(
     dr_neural_network neural_network, const DR_FLOAT_TYPE learning_rate, const DR_FLOAT_TYPE* output_errors);
 
+// one SGD step on a single sample, returns the sum of the output errors (target - output)
+DR_FLOAT_TYPE dr_neural_network_unchecked_train_sample(dr_neural_network neural_network,
+    dr_training_workspace training_workspace, const DR_FLOAT_TYPE learning_rate,
+    const DR_FLOAT_TYPE* train_input, const DR_FLOAT_TYPE* train_output);
+
+DR_FLOAT_TYPE dr_neural_network_train_sample(dr_neural_network neural_network,
+    dr_training_workspace training_workspace, const DR_FLOAT_TYPE learning_rate,
+    const DR_FLOAT_TYPE* train_input, const DR_FLOAT_TYPE* train_output);
+
+// train_sample with an 8-bit input, which is multiplied by input_scale when it is set to the input layer
+DR_FLOAT_TYPE dr_neural_network_unchecked_train_sample_bytes(dr_neural_network neural_network,
+    dr_training_workspace training_workspace, const DR_FLOAT_TYPE learning_rate,
+    const unsigned char* train_input, const DR_FLOAT_TYPE input_scale, const DR_FLOAT_TYPE* train_output);
+
+DR_FLOAT_TYPE dr_neural_network_train_sample_bytes(dr_neural_network neural_network,
+    dr_training_workspace training_workspace, const DR_FLOAT_TYPE learning_rate,
+    const unsigned char* train_input, const DR_FLOAT_TYPE input_scale, const DR_FLOAT_TYPE* train_output);
+
+dr_batch_workspace dr_batch_workspace_unchecked_create(
+    const dr_neural_network neural_network, const size_t batch_size);
+
+dr_batch_workspace dr_batch_workspace_create(const dr_neural_network neural_network, const size_t batch_size);
+
+bool dr_batch_workspace_compatible(const dr_batch_workspace batch_workspace, const dr_neural_network neural_network);
+
+void dr_batch_workspace_free(dr_batch_workspace* batch_workspace);
+
+// one step on train_count (<= batch_size) samples: forward and backward propagation are done for the whole batch
+// at once and the weights updates of the samples are averaged, returns the sum of the output errors
+DR_FLOAT_TYPE dr_neural_network_unchecked_train_batch(dr_neural_network neural_network,
+    dr_batch_workspace batch_workspace, const DR_FLOAT_TYPE learning_rate,
+    const DR_FLOAT_TYPE** train_inputs, const DR_FLOAT_TYPE** train_outputs, const size_t train_count);
+
+DR_FLOAT_TYPE dr_neural_network_train_batch(dr_neural_network neural_network,
+    dr_batch_workspace batch_workspace, const DR_FLOAT_TYPE learning_rate,
+    const DR_FLOAT_TYPE** train_inputs, const DR_FLOAT_TYPE** train_outputs, const size_t train_count);
+
 void dr_neural_network_unchecked_train(
     dr_neural_network neural_network, const DR_FLOAT_TYPE learning_rate, const size_t epochs,
     const DR_FLOAT_TYPE** trains_inputs, const DR_FLOAT_TYPE** trains_outputs, const size_t train_count);
@@ -99,12 +235,64 @@ void dr_neural_network_train(
     dr_neural_network neural_network, const DR_FLOAT_TYPE learning_rate, const size_t epochs,
     const DR_FLOAT_TYPE** train_inputs, const DR_FLOAT_TYPE** train_outputs, const size_t train_count);
 
+// writes the sums of the weights updates over the batch into gradients (one matrix per connection),
+// the connections are not changed: W += learning_rate / train_count * gradients gives the train_batch step
+DR_FLOAT_TYPE dr_neural_network_unchecked_batch_gradients_write(const dr_neural_network neural_network,
+    dr_batch_workspace batch_workspace, const DR_FLOAT_TYPE** train_inputs, const DR_FLOAT_TYPE** train_outputs,
+    const size_t train_count, dr_matrix* gradients);
+
+DR_FLOAT_TYPE dr_neural_network_batch_gradients_write(const dr_neural_network neural_network,
+    dr_batch_workspace batch_workspace, const DR_FLOAT_TYPE** train_inputs, const DR_FLOAT_TYPE** train_outputs,
+    const size_t train_count, dr_matrix* gradients);
+
+void dr_neural_network_unchecked_train_batched(
+    dr_neural_network neural_network, const DR_FLOAT_TYPE learning_rate, const size_t epochs, const size_t batch_size,
+    const DR_FLOAT_TYPE** train_inputs, const DR_FLOAT_TYPE** train_outputs, const size_t train_count);
+
+void dr_neural_network_train_batched(
+    dr_neural_network neural_network, const DR_FLOAT_TYPE learning_rate, const size_t epochs, const size_t batch_size,
+    const DR_FLOAT_TYPE** train_inputs, const DR_FLOAT_TYPE** train_outputs, const size_t train_count);
+
 void dr_neural_network_unchecked_prediction_write(
     const dr_neural_network neural_network, const DR_FLOAT_TYPE* input, DR_FLOAT_TYPE* prediction);
 
 void dr_neural_network_prediction_write(
     const dr_neural_network neural_network, const DR_FLOAT_TYPE* input, DR_FLOAT_TYPE* prediction);
 
+dr_inference_context dr_inference_context_unchecked_create(const dr_neural_network neural_network);
+
+dr_inference_context dr_inference_context_create(const dr_neural_network neural_network);
+
+bool dr_inference_context_compatible(
+    const dr_inference_context inference_context, const dr_neural_network neural_network);
+
+void dr_inference_context_free(dr_inference_context* inference_context);
+
+// unlike dr_neural_network_prediction_write doesn't touch the layers of the neural network
+void dr_neural_network_unchecked_prediction_write_context(const dr_neural_network neural_network,
+    dr_inference_context inference_context, const DR_FLOAT_TYPE* input, DR_FLOAT_TYPE* prediction);
+
+void dr_neural_network_prediction_write_context(const dr_neural_network neural_network,
+    dr_inference_context inference_context, const DR_FLOAT_TYPE* input, DR_FLOAT_TYPE* prediction);
+
+// inputs - count inputs one after another, outputs - count outputs one after another,
+// the samples are propagated in chunks, each layer of a chunk is a single GEMM, a zero count does nothing
+void dr_neural_network_unchecked_predict_batch(const dr_neural_network neural_network,
+    const DR_FLOAT_TYPE* inputs, const size_t count, DR_FLOAT_TYPE* outputs);
+
+void dr_neural_network_predict_batch(const dr_neural_network neural_network,
+    const DR_FLOAT_TYPE* inputs, const size_t count, DR_FLOAT_TYPE* outputs);
+
+// the samples are split into threads_count parts run on the default parallel scheduler (the calling thread helps),
+// stats can be NULL
+void dr_neural_network_unchecked_predict_batch_parallel(const dr_neural_network neural_network,
+    const DR_FLOAT_TYPE* inputs, const size_t count, DR_FLOAT_TYPE* outputs,
+    const size_t threads_count, dr_prediction_stats* stats);
+
+void dr_neural_network_predict_batch_parallel(const dr_neural_network neural_network,
+    const DR_FLOAT_TYPE* inputs, const size_t count, DR_FLOAT_TYPE* outputs,
+    const size_t threads_count, dr_prediction_stats* stats);
+
 DR_FLOAT_TYPE* dr_neural_network_unchecked_prediction_create(
     const dr_neural_network neural_network, const DR_FLOAT_TYPE* input);
 
@@ -124,6 +312,18 @@ dr_neural_network dr_neural_network_load_from_file_custom_activation_function_tr
 
 dr_neural_network dr_neural_network_load_from_file(const char* file_path);
 
+bool dr_neural_network_save_to_binary_file(const dr_neural_network neural_network, const char* file_path);
+
+// returns a not valid neural network if the file is missing, truncated or has another version or element size
+dr_neural_network dr_neural_network_load_from_binary_file(const char* file_path);
+
+// maps the binary file read-only and points the connections into the mapping without copying the weights,
+// so the processes mapping the same file share its pages. The weights can't be changed, a copy
+// (dr_neural_network_copy_create) has to be used for training. dr_neural_network_free unmaps the file.
+dr_neural_network dr_neural_network_load_mmap(const char* file_path);
+
+bool dr_neural_network_convert_text_file_to_binary_file(const char* text_file_path, const char* binary_file_path);
+
 void dr_neural_network_print(const dr_neural_network neural_network);
 
 void dr_neural_network_print_name(const dr_neural_network neural_network, const char* name);
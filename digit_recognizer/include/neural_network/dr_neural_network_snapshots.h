@@ -0,0 +1,50 @@
+#ifndef DR_NEURAL_NETWORK_SNAPSHOTS_H
+#define DR_NEURAL_NETWORK_SNAPSHOTS_H
+
+#include "dr_neural_network.h"
+#include <general/dr_thread.h>
+
+#define DR_NEURAL_NETWORK_SNAPSHOTS_COUNT 3
+
+// set in the shared index when the snapshot behind it hasn't been taken by the reader yet
+#define DR_NEURAL_NETWORK_SNAPSHOTS_FRESH ((size_t)4)
+
+// Triple buffer of the weights: the training thread copies the weights into its back snapshot and swaps it
+// with the shared one, the reader swaps its front snapshot with the shared one if it's fresh. Only the index
+// of the shared snapshot is exchanged atomically, so neither side waits for the other or copies under a lock
+// and the front snapshot stays immutable until the next acquire. A single writer and a single reader.
+typedef struct {
+    dr_neural_network snapshots[DR_NEURAL_NETWORK_SNAPSHOTS_COUNT];
+    size_t back_index;       // <- the writer only
+    size_t front_index;      // <- the reader only
+    dr_atomic_size_t shared; // <- the index of the shared snapshot and DR_NEURAL_NETWORK_SNAPSHOTS_FRESH
+    double publish_interval; // <- seconds
+    double last_publish_time;
+} dr_neural_network_snapshots;
+
+// every snapshot starts as a copy of the neural network,
+// the throttled publications come at most every publish_interval seconds
+dr_neural_network_snapshots* dr_neural_network_snapshots_unchecked_create(
+    const dr_neural_network neural_network, const double publish_interval);
+
+dr_neural_network_snapshots* dr_neural_network_snapshots_create(
+    const dr_neural_network neural_network, const double publish_interval);
+
+void dr_neural_network_snapshots_free(dr_neural_network_snapshots* snapshots);
+
+// the writer only, the neural network must have the topology of the snapshots
+void dr_neural_network_snapshots_unchecked_publish(
+    dr_neural_network_snapshots* snapshots, const dr_neural_network neural_network);
+
+void dr_neural_network_snapshots_publish(
+    dr_neural_network_snapshots* snapshots, const dr_neural_network neural_network);
+
+// the writer only, skips the weights if the last snapshot is younger than the publish interval,
+// returns true if the weights have been published
+bool dr_neural_network_snapshots_publish_throttled(
+    dr_neural_network_snapshots* snapshots, const dr_neural_network neural_network);
+
+// the reader only, returns the latest published snapshot, it's valid and unchanged until the next acquire
+dr_neural_network dr_neural_network_snapshots_acquire(dr_neural_network_snapshots* snapshots);
+
+#endif // DR_NEURAL_NETWORK_SNAPSHOTS_H
\ No newline at end of file
@@ -0,0 +1,64 @@
+#ifndef DR_TRAINER_H
+#define DR_TRAINER_H
+
+#include "dr_neural_network.h"
+#include <general/dr_parallel.h>
+
+typedef enum {
+    dr_trainer_mode_synchronous,
+    dr_trainer_mode_hogwild
+} dr_trainer_mode;
+
+// Every batch is split into threads_count parts run as the tasks of the default parallel scheduler,
+// so the GEMMs inside the parts share the same workers.
+// synchronous: each part computes its gradients into its own buffers, the gradients are summed pairwise
+// in log2(threads_count) levels, row by row in parallel, and the weights are updated with their average once
+// per batch (the result is the same as of the batched training).
+// hogwild: each part runs SGD sample by sample with its own activations and updates the shared connections
+// without any locks, the updates of different parts may overwrite each other.
+typedef struct {
+    dr_neural_network neural_network;
+    dr_trainer_mode mode;
+    size_t threads_count;
+    size_t batch_size;
+    dr_batch_workspace* workspaces;
+    dr_matrix** gradients; // gradients[part][connection], NULL in the hogwild mode
+    DR_FLOAT_TYPE* errors;
+
+    // the batch being trained
+    DR_FLOAT_TYPE learning_rate;
+    const DR_FLOAT_TYPE** train_inputs;
+    const DR_FLOAT_TYPE** train_outputs;
+    size_t train_count;
+} dr_trainer;
+
+// the trainer updates the connections of the neural network in place
+dr_trainer* dr_trainer_unchecked_create(
+    const dr_neural_network neural_network, const size_t batch_size, const size_t threads_count);
+
+dr_trainer* dr_trainer_create(
+    const dr_neural_network neural_network, const size_t batch_size, const size_t threads_count);
+
+// batch_size is the maximum number of samples passed to dr_trainer_train_batch at once
+dr_trainer* dr_trainer_unchecked_create_hogwild(
+    const dr_neural_network neural_network, const size_t batch_size, const size_t threads_count);
+
+dr_trainer* dr_trainer_create_hogwild(
+    const dr_neural_network neural_network, const size_t batch_size, const size_t threads_count);
+
+void dr_trainer_free(dr_trainer* trainer);
+
+// returns the sum of the output errors of the batch
+DR_FLOAT_TYPE dr_trainer_unchecked_train_batch(dr_trainer* trainer, const DR_FLOAT_TYPE learning_rate,
+    const DR_FLOAT_TYPE** train_inputs, const DR_FLOAT_TYPE** train_outputs, const size_t train_count);
+
+DR_FLOAT_TYPE dr_trainer_train_batch(dr_trainer* trainer, const DR_FLOAT_TYPE learning_rate,
+    const DR_FLOAT_TYPE** train_inputs, const DR_FLOAT_TYPE** train_outputs, const size_t train_count);
+
+void dr_trainer_unchecked_train(dr_trainer* trainer, const DR_FLOAT_TYPE learning_rate, const size_t epochs,
+    const DR_FLOAT_TYPE** train_inputs, const DR_FLOAT_TYPE** train_outputs, const size_t train_count);
+
+void dr_trainer_train(dr_trainer* trainer, const DR_FLOAT_TYPE learning_rate, const size_t epochs,
+    const DR_FLOAT_TYPE** train_inputs, const DR_FLOAT_TYPE** train_outputs, const size_t train_count);
+
+#endif // DR_TRAINER_H
\ No newline at end of file
@@ -1,12 +1,19 @@
 #include <application/dr_application.h>
 #include <application/dr_gui.h>
-#include <application/dr_thread.h>
+#include <general/dr_thread.h>
+#include <general/dr_metrics.h>
+#include <general/dr_time.h>
+#include <dataset/dr_dataset_loader.h>
+#include <dataset/dr_idx.h>
 #include <neural_network/dr_neural_network.h>
+#include <neural_network/dr_trainer.h>
+#include <neural_network/dr_neural_network_snapshots.h>
 #include <limits.h>
 
 // #define DR_APPLICATION_SAVE_USER_NEURAL_NETWORK
-#define DR_APPLICATION_SAVE_USER_NEURAL_NETWORK_PATH       "user_neural_network.txt"
-#define DR_APPLICATION_LOAD_PRETRAINED_NEURAL_NETWORK_PATH "assets/pretrained_neural_network.txt"
+#define DR_APPLICATION_SAVE_USER_NEURAL_NETWORK_PATH              "user_neural_network.txt"
+#define DR_APPLICATION_LOAD_PRETRAINED_NEURAL_NETWORK_PATH        "assets/pretrained_neural_network.txt"
+#define DR_APPLICATION_LOAD_PRETRAINED_NEURAL_NETWORK_BINARY_PATH "assets/pretrained_neural_network.bin"
 
 #define DR_APPLICATION_WINDOW_WIDTH          800
 #define DR_APPLICATION_WINDOW_HEIGHT         600
@@ -18,12 +25,15 @@
 #define DR_APPLICATION_DIGITS_COUNT          10
 #define DR_APPLICATION_TEXT_FORMAT_PRECISION "%.4f"
 
+#define DR_APPLICATION_MNIST_IMAGES_PATH          "assets/train-images-idx3-ubyte"
+#define DR_APPLICATION_MNIST_LABELS_PATH          "assets/train-labels-idx1-ubyte"
 #define DR_APPLICATION_MNIST_DATASET_PATH         "assets/dataset.bin"
 #define DR_APPLICATION_MNIST_DATASET_MAX_COUNT    60000
 #define DR_APPLICATION_CANVAS_RESOLUTION_WIDTH    28
 #define DR_APPLICATION_CANVAS_RESOLUTION_HEIGHT   28
 #define DR_APPLICATION_CANVAS_PIXELS_COUNT        (DR_APPLICATION_CANVAS_RESOLUTION_WIDTH *\
     DR_APPLICATION_CANVAS_RESOLUTION_HEIGHT)
+#define DR_APPLICATION_PIXEL_SCALE                ((DR_FLOAT_TYPE)(1.0 / 255.0))
 #define DR_APPLICATION_CANVAS_WIDTH               300
 #define DR_APPLICATION_CANVAS_HEIGHT              300
 #define DR_APPLICATION_CANVAS_DRAW_COLOR          CLITERAL(Color){ 255, 255, 255, 230 }
@@ -36,6 +46,12 @@
 #define DR_APPLICATION_TRAINING_TANH_STR    "tanh"
 #define DR_APPLICATION_TRAINING_RELU_STR    "ReLU"
 
+#define DR_APPLICATION_TRAINING_MAX_BATCH_SIZE     1024
+#define DR_APPLICATION_TRAINING_MAX_THREADS_COUNT  64
+#define DR_APPLICATION_TRAINING_HOGWILD_CHUNK_SIZE 1024
+#define DR_APPLICATION_TRAINING_METRICS_INTERVAL   0.005
+#define DR_APPLICATION_TRAINING_SNAPSHOT_INTERVAL  0.1
+
 typedef enum {
     dr_application_tab_dataset,
     dr_application_tab_training,
@@ -46,16 +62,15 @@ typedef enum {
 Vector2 window_size              = { DR_APPLICATION_WINDOW_WIDTH, DR_APPLICATION_WINDOW_HEIGHT };
 dr_application_tab current_tab   = dr_application_tab_dataset;
 dr_neural_network user_neural_network       = { 0 };
+// the weights of the user neural network published by the training thread for the predictions
+dr_neural_network_snapshots* user_neural_network_snapshots = NULL;
 dr_neural_network pretrained_neural_network = { 0 };
 
 // dataset
 RenderTexture2D dataset_canvas_rtexture = { 0 };
 Vector2 dataset_canvas_last_point       = { -1 };
 char dataset_status_bar_str_buffer[DR_STR_BUFFER_SIZE]   = DR_APPLICATION_DIGIT_RECOGNIZER_STR;
-size_t dataset_digits_count_total                        = 0;
-size_t dataset_digits_count[DR_APPLICATION_DIGITS_COUNT] = { 0 };
-DR_FLOAT_TYPE* dataset_digits_pixels                     = NULL;
-unsigned char* dataset_digits_labels                     = NULL;
+dr_dataset dataset                                       = { 0 }; // <- 8-bit, converted when fed to the network
 bool dataset_attempt_to_load_mnist        = false;
 bool dataset_attempt_to_load_mnist_failed = false;
 int dataset_count_to_load_mnist               = 100;
@@ -72,19 +87,29 @@ bool training_controller_dropbox_edit = false;
 size_t training_hidden_layers_count   = 0;
 char** training_hidden_layers_info    = NULL;
 DR_FLOAT_TYPE training_learning_rate  = 0.01;
-size_t training_current_epoch = 0;
 size_t training_count_epochs  = 1000;
 bool training_epochs_spinner_edit = false;
+size_t training_batch_size        = 1;
+bool training_batch_spinner_edit  = false;
+size_t training_threads_count       = 1;
+bool training_threads_spinner_edit  = false;
+bool training_hogwild               = false;
+bool training_shuffle_blocks        = false;
 bool training_attempt_to_start_training_failed = false;
-bool training_process_active     = false;
-bool training_procces_finished   = false;
+dr_atomic_size_t training_process_active   = false; // <- cleared by the gui to stop the training thread
+dr_atomic_size_t training_procces_finished = false;
 bool training_proccess_stopped   = false;
 bool training_neural_network_updated  = false;
-DR_FLOAT_TYPE training_error          = 0;
-size_t training_current_dataset_index = 0;
+size_t* training_dataset_indices      = NULL; // <- the order of the images in the current epoch
+dr_random training_random             = { 0 };
 dr_thread_id_t training_thread_id         = { 0 };
 dr_thread_handle_t training_thread_handle = 0;
-dr_mutex_t training_mutex                 = { 0 };
+dr_metrics_channel training_metrics_channel = { 0 }; // <- published by the training thread, read by the gui
+dr_training_metrics training_metrics         = { 0 }; // <- the snapshot of the current frame
+dr_training_workspace training_workspace  = { 0 };
+dr_batch_workspace training_batch_workspace     = { 0 };
+dr_trainer* training_trainer                    = NULL;
+dr_dataset_loader* training_loader              = NULL; // <- prepares the next batch while the current one trains
 
 // prediction
 RenderTexture2D prediction_canvas_rtexture = { 0 };
@@ -118,105 +143,44 @@ void dr_application_canvas_get_pixels(const RenderTexture2D canvas, DR_FLOAT_TYP
     UnloadImage(canvas_image);
 }
 
-//////////////////////////////////////////////////////////////////////////////////////////////////////////////// DATASET
-
-size_t dr_application_dataset_add_memory(const size_t count) {
-    const size_t new_digits_count_total = dataset_digits_count_total + count;
-
-    DR_FLOAT_TYPE* reallocated_pixels = (DR_FLOAT_TYPE*)DR_REALLOC(
-        dataset_digits_pixels, sizeof(DR_FLOAT_TYPE) * new_digits_count_total * DR_APPLICATION_CANVAS_PIXELS_COUNT);
-    DR_ASSERT_MSG(reallocated_pixels, "new pixels reallocate error for the application dataset");
-
-    unsigned char* reallocated_results = (unsigned char*)DR_REALLOC(
-        dataset_digits_labels, sizeof(unsigned char) * new_digits_count_total);
-    DR_ASSERT_MSG(reallocated_results, "results reallocate error for the application dataset");
-
-    dataset_digits_pixels  = reallocated_pixels;
-    dataset_digits_labels = reallocated_results;
-
-    return new_digits_count_total;
+void dr_application_canvas_get_pixels_bytes(const RenderTexture2D canvas, unsigned char* pixels) {
+    Image canvas_image = LoadImageFromTexture(canvas.texture);
+    for (size_t y = DR_APPLICATION_CANVAS_RESOLUTION_HEIGHT; y > 0; --y) {
+        for (size_t x = 0; x < DR_APPLICATION_CANVAS_RESOLUTION_WIDTH; ++x) {
+            const Color pixel_color = GetImageColor(canvas_image, x, y - 1);
+            *pixels = (unsigned char)((pixel_color.r + pixel_color.g + pixel_color.b + 1) / 3);
+            ++pixels;
+        }
+    }
+    UnloadImage(canvas_image);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////// DATASET
+
 void dr_application_dataset_add_digit(const unsigned char digit) {
     DR_ASSERT_MSG(digit >= 0 && digit <= 9, "attempt to add a not correct digit to the application dataset");
 
-    const size_t new_digits_count_total = dr_application_dataset_add_memory(1);
-    DR_FLOAT_TYPE* new_pixels = dataset_digits_pixels + dataset_digits_count_total * DR_APPLICATION_CANVAS_PIXELS_COUNT;
-    dr_application_canvas_get_pixels(dataset_canvas_rtexture, new_pixels);
-    dataset_digits_count_total = new_digits_count_total;
-    dataset_digits_labels[dataset_digits_count_total - 1] = digit;
-    ++dataset_digits_count[digit];
+    unsigned char pixels[DR_APPLICATION_CANVAS_PIXELS_COUNT];
+    dr_application_canvas_get_pixels_bytes(dataset_canvas_rtexture, pixels);
+    dr_dataset_add(&dataset, pixels, digit);
 }
 
 bool dr_application_dataset_load_mnist(const size_t count) {
-    FILE* file = fopen(DR_APPLICATION_MNIST_DATASET_PATH, "rb");
-    if (!file) {
-        return false;
-    }
-
-    uint32_t header[3] = { 0 };
-    (void) fread(header, sizeof(header), 1, file);
-
-    if (count > header[0]) {
-        dr_print_error("Attempt to load more MNIST images than there are");
-        fclose(file);
-        return false;
-    }
-
-    if (header[1] != DR_APPLICATION_CANVAS_RESOLUTION_HEIGHT ||
-        header[2] != DR_APPLICATION_CANVAS_RESOLUTION_WIDTH) {
-        dr_print_error("Mismatch application canvas resolution and MNSIT images resolution\n");
-        fclose(file);
-        return false;
-    }
-
-    const size_t new_digits_count_total = dr_application_dataset_add_memory(count);
-    DR_FLOAT_TYPE* new_pixels = dataset_digits_pixels + dataset_digits_count_total * DR_APPLICATION_CANVAS_PIXELS_COUNT;
-    unsigned char* new_results = dataset_digits_labels + dataset_digits_count_total; 
-
-    const size_t pixels_count_total = count * DR_APPLICATION_CANVAS_PIXELS_COUNT;
-    const DR_FLOAT_TYPE* new_pixels_end = new_pixels + pixels_count_total;
-    for (; new_pixels != new_pixels_end; ++new_pixels) {
-        unsigned char pixel = 0;
-        (void) fread(&pixel, sizeof(unsigned char), 1, file);
-        *new_pixels = (float)pixel / 255.0f;
-    }
-
-    fseek(file, sizeof(header) + sizeof(unsigned char) * header[0] * DR_APPLICATION_CANVAS_PIXELS_COUNT, SEEK_SET);
-
-    const unsigned char* new_results_end = new_results + count;
-    for (; new_results != new_results_end; ++new_results) {
-        unsigned char digit = 0;
-        (void) fread(&digit, sizeof(unsigned char), 1, file);
-        *new_results = digit;
-        ++dataset_digits_count[digit];
+    // the original files are read directly, the converted dataset file is left for the old installations
+    if (dr_idx_gzip_supported() && dr_dataset_load_idx(&dataset,
+        DR_APPLICATION_MNIST_IMAGES_PATH".gz", DR_APPLICATION_MNIST_LABELS_PATH".gz", count)) {
+        return true;
     }
-
-    dataset_digits_count_total = new_digits_count_total;
-
-    fclose(file);
-
-    return true;
+    return dr_dataset_load_idx(&dataset, DR_APPLICATION_MNIST_IMAGES_PATH, DR_APPLICATION_MNIST_LABELS_PATH, count) ||
+        dr_dataset_load_mnist(&dataset, DR_APPLICATION_MNIST_DATASET_PATH, count);
 }
 
 void dr_application_dataset_clear() {
-    if (dataset_digits_count_total == 0) {
-        return;
-    }
-
-    for (size_t i = 0; i < DR_APPLICATION_DIGITS_COUNT; ++i) {
-        dataset_digits_count[i] = 0;
-    }
-
-    DR_FREE(dataset_digits_pixels);
-    dataset_digits_pixels = NULL;
-    DR_FREE(dataset_digits_labels);
-    dataset_digits_labels = NULL;
-    dataset_digits_count_total = 0;
+    dr_dataset_clear(&dataset);
 }
 
 void dr_application_dataset_tab() {
-    const bool dataset_empty = dataset_digits_count_total == 0;
+    const bool dataset_empty = dataset.count == 0;
 
     // work area
     Rectangle work_area = { 0 };
@@ -323,7 +287,7 @@ void dr_application_dataset_tab() {
         DR_APPLICATION_CANVAS_DRAW_COLOR, DR_APPLICATION_CANVAS_ERASE_COLOR, dataset_canvas_last_point);
 
     const int clicked_digit = dr_gui_numeric_buttons_row(
-        numeric_buttons_bounds, DR_APPLICATION_DIGITS_COUNT, dataset_digits_count);
+        numeric_buttons_bounds, DR_APPLICATION_DIGITS_COUNT, dataset.labels_counts);
     if (clicked_digit >= 0) {
         dr_application_dataset_add_digit(clicked_digit);
         dr_application_canvas_clear(dataset_canvas_rtexture);
@@ -511,49 +475,133 @@ void dr_application_neural_network_create() {
     user_neural_network = dr_neural_network_create(
         layers_sizes, layers_count, activation_functions, activation_function_derivatives);
     dr_neural_network_randomize_weights(user_neural_network, -1, 1);
+    user_neural_network_snapshots =
+        dr_neural_network_snapshots_create(user_neural_network, DR_APPLICATION_TRAINING_SNAPSHOT_INTERVAL);
 
     DR_FREE(layers_sizes);
     DR_FREE(activation_functions);
     DR_FREE(activation_function_derivatives);
 }
 
-void dr_application_train_neural_network_current_data() {
-    DR_ASSERT_MSG(training_current_dataset_index >= 0 && training_current_dataset_index < dataset_digits_count_total,
-        "dataset index to train out of range the dataset in the application");
+DR_FLOAT_TYPE dr_application_train_neural_network_image(const size_t dataset_index) {
+    DR_ASSERT_MSG(dataset_index < dataset.count, "dataset index to train out of range the dataset in the application");
 
-    DR_FLOAT_TYPE real_output[DR_APPLICATION_DIGITS_COUNT]     = { 0 };
+    const unsigned char* input = dr_dataset_image(dataset, dataset_index);
     DR_FLOAT_TYPE expected_output[DR_APPLICATION_DIGITS_COUNT] = { 0 };
-    DR_FLOAT_TYPE error_output[DR_APPLICATION_DIGITS_COUNT]    = { 0 };
-    expected_output[dataset_digits_labels[training_current_dataset_index]] = 1;
-    dr_neural_network_set_input(user_neural_network,
-        dataset_digits_pixels + training_current_dataset_index * DR_APPLICATION_CANVAS_PIXELS_COUNT);
-    dr_neural_network_forward_propagation(user_neural_network);
-    dr_neural_network_get_output(user_neural_network, real_output);
-    DR_FLOAT_TYPE error_sum = 0;
-    for (size_t i = 0; i < DR_APPLICATION_DIGITS_COUNT; ++i) {
-        error_output[i] = expected_output[i] - real_output[i];
-        error_sum += error_output[i];
+    expected_output[dataset.labels[dataset_index]] = 1;
+    const DR_FLOAT_TYPE error_sum = dr_neural_network_train_sample_bytes(user_neural_network, training_workspace,
+        training_learning_rate, input, DR_APPLICATION_PIXEL_SCALE, expected_output);
+    return fabs(error_sum);
+}
+
+DR_FLOAT_TYPE dr_application_train_neural_network_batch(const dr_dataset_batch* batch) {
+    const DR_FLOAT_TYPE error_sum = training_trainer ?
+        dr_trainer_train_batch(
+            training_trainer, training_learning_rate, batch->inputs, batch->outputs, batch->count) :
+        dr_neural_network_train_batch(user_neural_network, training_batch_workspace,
+            training_learning_rate, batch->inputs, batch->outputs, batch->count);
+    return fabs(error_sum) / batch->count;
+}
+
+// the gui reads the progress and the weights from the snapshots, so the training loop never waits for it
+void dr_application_training_publish(dr_training_metrics* metrics, const double start_time,
+    const DR_FLOAT_TYPE error, const size_t images_count, const bool force) {
+    const double seconds = dr_time_seconds() - start_time;
+    metrics->error             = error;
+    metrics->images_count     += images_count;
+    metrics->images_per_second = seconds > 0 ? metrics->images_count / seconds : 0;
+    if (force) {
+        dr_metrics_channel_publish(&training_metrics_channel, metrics);
+        dr_neural_network_snapshots_publish(user_neural_network_snapshots, user_neural_network);
+    } else {
+        dr_metrics_channel_publish_throttled(&training_metrics_channel, metrics);
+        dr_neural_network_snapshots_publish_throttled(user_neural_network_snapshots, user_neural_network);
     }
-    dr_mutex_lock(&training_mutex);
-    training_error = fabs(error_sum);
-    dr_mutex_unlock(&training_mutex);
-    dr_neural_network_back_propagation(user_neural_network, training_learning_rate, error_output);
 }
 
 dr_thread_function_result_t DR_WINAPI dr_application_train_neural_network_other_thread(void* data) {
-    training_error = 0;
-    while (training_process_active && training_current_epoch < training_count_epochs) {
-        if (training_current_dataset_index >= dataset_digits_count_total) {
-            training_current_dataset_index = 0;
-            ++training_current_epoch;
+    dr_training_metrics metrics = { 0 };
+    metrics.epochs_count = training_count_epochs;
+    const double start_time = dr_time_seconds();
+    dr_metrics_channel_publish(&training_metrics_channel, &metrics);
+
+    // the parts of the trainer and the GEMMs inside them run on the default scheduler,
+    // so it gets the threads of the setting for the training (the calling thread is one of them)
+    dr_parallel_scheduler* training_scheduler = dr_parallel_scheduler_create(training_threads_count - 1);
+    dr_parallel_scheduler* previous_scheduler = dr_parallel_scheduler_set_default(training_scheduler);
+
+    // the images are shuffled every epoch, the blocks keep the gathers of the batches close in memory
+    const dr_dataset_order order =
+        training_shuffle_blocks ? dr_dataset_order_shuffle_blocks : dr_dataset_order_shuffle;
+    const uint64_t seed = (uint64_t)time(NULL);
+    const bool batched = training_batch_size > 1 || training_threads_count > 1 || training_hogwild;
+    if (batched) {
+        // the hogwild workers train sample by sample, the chunk only sets how often the progress is updated
+        const size_t batch_capacity =
+            training_hogwild ? DR_APPLICATION_TRAINING_HOGWILD_CHUNK_SIZE : training_batch_size;
+        if (training_hogwild) {
+            training_trainer =
+                dr_trainer_create_hogwild(user_neural_network, batch_capacity, training_threads_count);
+        } else if (training_threads_count > 1) {
+            training_trainer = dr_trainer_create(user_neural_network, batch_capacity, training_threads_count);
+        } else {
+            training_batch_workspace = dr_batch_workspace_create(user_neural_network, batch_capacity);
+        }
+        training_loader = dr_dataset_loader_create(
+            dataset, batch_capacity, DR_APPLICATION_PIXEL_SCALE, training_count_epochs, order, seed);
+    } else {
+        training_workspace = dr_training_workspace_create(user_neural_network);
+        training_random    = dr_random_create(seed);
+        training_dataset_indices = (size_t*)DR_MALLOC(sizeof(size_t) * dataset.count);
+        DR_ASSERT_MSG(training_dataset_indices, "application dataset indices alloc error");
+        for (size_t i = 0; i < dataset.count; ++i) {
+            training_dataset_indices[i] = i;
+        }
+        dr_dataset_shuffle_indices(order, &training_random, training_dataset_indices, dataset.count);
+    }
+
+    DR_FLOAT_TYPE error = 0;
+    if (batched) {
+        const dr_dataset_batch* batch = NULL;
+        while (dr_atomic_load_acquire(&training_process_active) &&
+            (batch = dr_dataset_loader_acquire(training_loader))) {
+            metrics.epoch = batch->epoch;
+            error = dr_application_train_neural_network_batch(batch);
+            dr_application_training_publish(&metrics, start_time, error, batch->count, false);
+            dr_dataset_loader_release(training_loader);
+        }
+    } else {
+        size_t dataset_index = 0;
+        while (dr_atomic_load_acquire(&training_process_active) && metrics.epoch < training_count_epochs) {
+            if (dataset_index >= dataset.count) {
+                dataset_index = 0;
+                ++metrics.epoch;
+                dr_dataset_shuffle_indices(order, &training_random, training_dataset_indices, dataset.count);
+                continue;
+            }
+            error = dr_application_train_neural_network_image(training_dataset_indices[dataset_index]);
+            dr_application_training_publish(&metrics, start_time, error, 1, false);
+            ++dataset_index;
+        }
+    }
+    dr_application_training_publish(&metrics, start_time, error, 0, true);
+
+    if (batched) {
+        dr_dataset_loader_free(training_loader);
+        training_loader = NULL;
+        if (training_trainer) {
+            dr_trainer_free(training_trainer);
+            training_trainer = NULL;
+        } else {
+            dr_batch_workspace_free(&training_batch_workspace);
         }
-        dr_application_train_neural_network_current_data();
-        ++training_current_dataset_index;
+    } else {
+        dr_training_workspace_free(&training_workspace);
+        DR_FREE(training_dataset_indices);
+        training_dataset_indices = NULL;
     }
-    training_process_active   = false;
-    training_procces_finished = true;
-    training_current_dataset_index = 0;
-    training_current_epoch = 0;
+    dr_parallel_scheduler_set_default(previous_scheduler);
+    dr_parallel_scheduler_free(training_scheduler);
 
 #ifdef DR_APPLICATION_SAVE_USER_NEURAL_NETWORK
     if (!dr_neural_network_save_to_file(user_neural_network, DR_APPLICATION_SAVE_USER_NEURAL_NETWORK_PATH)) {
@@ -561,6 +609,8 @@ dr_thread_function_result_t DR_WINAPI dr_application_train_neural_network_other_
     }
 #endif // DR_APPLICATION_SAVE_USER_NEURAL_NETOWRK
 
+    dr_atomic_store_release(&training_procces_finished, true);
+    dr_atomic_store_release(&training_process_active, false);
     return 0;
 }
 
@@ -755,8 +805,8 @@ void dr_application_training_tab_hidden_layers(const Rectangle work_area) {
     // settings element
     Vector2 train_settings_element_size = { 0 };
     train_settings_element_size.x = train_settings_bounds.width;
-    train_settings_element_size.y = train_settings_bounds.height / 4;
-    const float train_settings_height = train_settings_element_size.y * 3;
+    train_settings_element_size.y = train_settings_bounds.height / 8;
+    const float train_settings_height = train_settings_element_size.y * 7;
 
     // slider learning rate
     Rectangle learning_rate_slider_bounds = { 0 };
@@ -774,10 +824,38 @@ void dr_application_training_tab_hidden_layers(const Rectangle work_area) {
     epochs_value_box_bounds.width  = train_settings_element_size.x;
     epochs_value_box_bounds.height = train_settings_element_size.y;
 
+    // value box batch size
+    Rectangle batch_value_box_bounds = { 0 };
+    batch_value_box_bounds.x = epochs_value_box_bounds.x;
+    batch_value_box_bounds.y = epochs_value_box_bounds.y + epochs_value_box_bounds.height;
+    batch_value_box_bounds.width  = train_settings_element_size.x;
+    batch_value_box_bounds.height = train_settings_element_size.y;
+
+    // value box threads count
+    Rectangle threads_value_box_bounds = { 0 };
+    threads_value_box_bounds.x = batch_value_box_bounds.x;
+    threads_value_box_bounds.y = batch_value_box_bounds.y + batch_value_box_bounds.height;
+    threads_value_box_bounds.width  = train_settings_element_size.x;
+    threads_value_box_bounds.height = train_settings_element_size.y;
+
+    // check box hogwild
+    Rectangle hogwild_check_box_bounds = { 0 };
+    hogwild_check_box_bounds.x = threads_value_box_bounds.x;
+    hogwild_check_box_bounds.y = threads_value_box_bounds.y + threads_value_box_bounds.height;
+    hogwild_check_box_bounds.width  = train_settings_element_size.y;
+    hogwild_check_box_bounds.height = train_settings_element_size.y;
+
+    // check box shuffle in blocks
+    Rectangle shuffle_blocks_check_box_bounds = { 0 };
+    shuffle_blocks_check_box_bounds.x = hogwild_check_box_bounds.x;
+    shuffle_blocks_check_box_bounds.y = hogwild_check_box_bounds.y + hogwild_check_box_bounds.height;
+    shuffle_blocks_check_box_bounds.width  = train_settings_element_size.y;
+    shuffle_blocks_check_box_bounds.height = train_settings_element_size.y;
+
     // button
     Rectangle train_button_bounds = { 0 };
-    train_button_bounds.x = epochs_value_box_bounds.x;
-    train_button_bounds.y = epochs_value_box_bounds.y + epochs_value_box_bounds.height;
+    train_button_bounds.x = threads_value_box_bounds.x;
+    train_button_bounds.y = shuffle_blocks_check_box_bounds.y + shuffle_blocks_check_box_bounds.height;
     train_button_bounds.width  = train_settings_element_size.x;
     train_button_bounds.height = train_settings_element_size.y;
 
@@ -802,16 +880,28 @@ void dr_application_training_tab_hidden_layers(const Rectangle work_area) {
         (int*)&training_count_epochs, 1, INT_MAX, training_epochs_spinner_edit)) {
         training_epochs_spinner_edit = !training_epochs_spinner_edit;
     }
+    if (GuiSpinner(batch_value_box_bounds, "Batch ",
+        (int*)&training_batch_size, 1, DR_APPLICATION_TRAINING_MAX_BATCH_SIZE, training_batch_spinner_edit)) {
+        training_batch_spinner_edit = !training_batch_spinner_edit;
+    }
+    if (GuiSpinner(threads_value_box_bounds, "Threads ",
+        (int*)&training_threads_count, 1, DR_APPLICATION_TRAINING_MAX_THREADS_COUNT, training_threads_spinner_edit)) {
+        training_threads_spinner_edit = !training_threads_spinner_edit;
+    }
+    training_hogwild = GuiCheckBox(hogwild_check_box_bounds, "Hogwild (lock-free updates)", training_hogwild);
+    training_shuffle_blocks =
+        GuiCheckBox(shuffle_blocks_check_box_bounds, "Shuffle in blocks", training_shuffle_blocks);
     if (GuiButton(train_button_bounds, "Train")) {
-        if (dataset_digits_count_total == 0) {
+        if (dataset.count == 0) {
             training_attempt_to_start_training_failed = true;
             return;
         }
 
-        training_process_active = true;
+        dr_atomic_store_release(&training_process_active, true);
         if (user_neural_network.layers_count == 0) {
             dr_application_neural_network_create();
         } else if (training_neural_network_updated) {
+            dr_neural_network_snapshots_free(user_neural_network_snapshots);
             dr_neural_network_free(&user_neural_network);
             dr_application_neural_network_create();
             training_neural_network_updated = false;
@@ -877,18 +967,18 @@ void dr_application_training_tab_training_process(const Rectangle work_area) {
     const int window_box_res  = GuiWindowBox(window_box_bounds, "Neural network training process");
     const int stop_button_res = GuiButton(stop_button_bounds, "Stop");
     if (stop_button_res || window_box_res) {
-        training_process_active = false;
+        dr_atomic_store_release(&training_process_active, false);
         const bool thread_join_result = dr_thread_join(training_thread_handle, training_thread_id);
         DR_ASSERT_MSG(thread_join_result, "thread join error when training the neural network in the application");
         training_proccess_stopped = true;
         return;
     }
 
-    GuiLabel(label_error_bounds, TextFormat("%s: "DR_APPLICATION_TEXT_FORMAT_PRECISION, "Error", training_error));
+    GuiLabel(label_error_bounds, TextFormat("%s: "DR_APPLICATION_TEXT_FORMAT_PRECISION", %.0f images/s",
+        "Error", training_metrics.error, training_metrics.images_per_second));
 
-    training_current_epoch = GuiProgressBar(
-        progress_bar_bounds, TextFormat("%zu ", training_current_epoch), TextFormat(" %zu", training_count_epochs),
-        training_current_epoch, 0, training_count_epochs);
+    GuiProgressBar(progress_bar_bounds, TextFormat("%zu ", training_metrics.epoch),
+        TextFormat(" %zu", training_metrics.epochs_count), training_metrics.epoch, 0, training_metrics.epochs_count);
 }
 
 void dr_application_training_tab() {
@@ -907,6 +997,10 @@ void dr_application_training_tab() {
     message_box_bounds.y = work_area.y + work_area.height / 2 - message_box_bounds.height / 2;
 
     // gui
+    // the settings can't be changed while the training thread runs, even for the frame the tab is switched in
+    if (dr_atomic_load_acquire(&training_process_active)) {
+        GuiLock();
+    }
     dr_application_training_tab_hidden_layers(work_area);
 
     if (training_attempt_to_start_training_failed) {
@@ -922,7 +1016,9 @@ void dr_application_training_tab() {
         return;
     }
     
-    if (training_process_active) {
+    // a single consistent snapshot per frame
+    dr_metrics_channel_read(&training_metrics_channel, &training_metrics);
+    if (dr_atomic_load_acquire(&training_process_active)) {
         GuiUnlock();
         dr_gui_dim(work_area);
         dr_application_training_tab_training_process(work_area);
@@ -931,22 +1027,23 @@ void dr_application_training_tab() {
         GuiUnlock();
         dr_gui_dim(work_area);
         const char* message = TextFormat(
-            "Neural network training stopped with a last error: "DR_APPLICATION_TEXT_FORMAT_PRECISION, training_error);
+            "Neural network training stopped with a last error: "DR_APPLICATION_TEXT_FORMAT_PRECISION,
+            training_metrics.error);
         const int message_box_result = GuiMessageBox(message_box_bounds, "Stopped", message, "Ok");
         if (message_box_result == 0 || message_box_result == 1) {
             training_proccess_stopped = false;
-            training_procces_finished   = false;
+            dr_atomic_store_release(&training_procces_finished, false);
         } else {
             GuiLock();
         }
-    } else if (training_procces_finished) {
+    } else if (dr_atomic_load_acquire(&training_procces_finished)) {
         GuiUnlock();
         dr_gui_dim(work_area);
         const char* message = TextFormat("The neural network has been successfully trained with a last error: "
-            DR_APPLICATION_TEXT_FORMAT_PRECISION, training_error);
+            DR_APPLICATION_TEXT_FORMAT_PRECISION, training_metrics.error);
         const int message_box_result = GuiMessageBox(message_box_bounds, "Success", message, "Ok");
         if (message_box_result >= 0) {
-            training_procces_finished = false;
+            dr_atomic_store_release(&training_procces_finished, false);
         } else {
             GuiLock();
         }
@@ -1128,11 +1225,13 @@ void dr_application_prediction_tab() {
         prediction_show = true;
         DR_FLOAT_TYPE pixels[DR_APPLICATION_CANVAS_PIXELS_COUNT] = { 0 };
         dr_application_canvas_get_pixels(prediction_canvas_rtexture, pixels);
-        if (prediction_use_my_neural_network) {
-            dr_neural_network_prediction_write(user_neural_network, pixels, prediction_probs);
-        } else {
-            dr_neural_network_prediction_write(pretrained_neural_network, pixels, prediction_probs);
-        }
+        // the activations live in the context, so the prediction doesn't write into the network,
+        // the user neural network is taken from the latest snapshot, so it works during the training as well
+        const dr_neural_network neural_network = prediction_use_my_neural_network ?
+            dr_neural_network_snapshots_acquire(user_neural_network_snapshots) : pretrained_neural_network;
+        dr_inference_context inference_context = dr_inference_context_create(neural_network);
+        dr_neural_network_prediction_write_context(neural_network, inference_context, pixels, prediction_probs);
+        dr_inference_context_free(&inference_context);
         prediction_max_prob = -1;
         for (size_t i = 0; i < DR_APPLICATION_DIGITS_COUNT; ++i) {
             const DR_FLOAT_TYPE curr_prob = prediction_probs[i];
@@ -1177,6 +1276,13 @@ void dr_application_prediction_tab() {
 }
 
 void dr_application_draw() {
+    // during the training only the prediction tab works besides the training process window,
+    // the dataset is read by the training thread
+    const bool training_active = dr_atomic_load_acquire(&training_process_active);
+    if (training_active && current_tab == dr_application_tab_prediction) {
+        GuiUnlock();
+    }
+
     switch (current_tab) {
     case dr_application_tab_dataset:
         dr_application_dataset_tab();
@@ -1193,7 +1299,17 @@ void dr_application_draw() {
     }
 
     const Rectangle tab_rect = { 0, 0, window_size.x / DR_APPLICATION_TAB_COUNT, DR_APPLICATION_TAB_HEIGHT };
-    current_tab = GuiToggleGroup(tab_rect, "Dataset;Trainig;Prediction", current_tab);
+    const bool gui_was_locked = GuiIsLocked();
+    if (training_active) {
+        GuiUnlock();
+    }
+    const dr_application_tab selected_tab = GuiToggleGroup(tab_rect, "Dataset;Trainig;Prediction", current_tab);
+    if (gui_was_locked) {
+        GuiLock();
+    }
+    if (!training_active || selected_tab != dr_application_tab_dataset) {
+        current_tab = selected_tab;
+    }
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////// APPLICATION
@@ -1218,13 +1334,13 @@ void dr_application_create() {
     GuiSetStyle(DEFAULT, TEXT_SPACING, 2);
 
     // dataset
+    dataset = dr_dataset_create(DR_APPLICATION_CANVAS_PIXELS_COUNT);
     dataset_canvas_rtexture = LoadRenderTexture(
         DR_APPLICATION_CANVAS_RESOLUTION_WIDTH, DR_APPLICATION_CANVAS_RESOLUTION_HEIGHT);
     dr_application_canvas_clear(dataset_canvas_rtexture);
 
     // training
-    training_mutex = dr_mutex_create();
-    DR_ASSERT_MSG(dr_check_mutex(training_mutex), "error to create training mutex");
+    dr_metrics_channel_init(&training_metrics_channel, DR_APPLICATION_TRAINING_METRICS_INTERVAL);
     dr_application_training_add_hidden_layer(DR_APPLICATION_CANVAS_PIXELS_COUNT, DR_APPLICATION_TRAINING_SIGMOID_STR);
     dr_application_training_add_hidden_layer(DR_APPLICATION_CANVAS_PIXELS_COUNT, DR_APPLICATION_TRAINING_SIGMOID_STR); 
 
@@ -1234,7 +1350,17 @@ void dr_application_create() {
     dr_application_canvas_clear(prediction_canvas_rtexture);
 
     // application
-    pretrained_neural_network = dr_neural_network_load_from_file(DR_APPLICATION_LOAD_PRETRAINED_NEURAL_NETWORK_PATH);
+    // the binary model is mapped without copying (the pretrained network is only used for the predictions),
+    // it is converted from the text one on the first start
+    pretrained_neural_network = dr_neural_network_load_mmap(DR_APPLICATION_LOAD_PRETRAINED_NEURAL_NETWORK_BINARY_PATH);
+    if (!dr_neural_network_valid(pretrained_neural_network)) {
+        pretrained_neural_network =
+            dr_neural_network_load_from_file(DR_APPLICATION_LOAD_PRETRAINED_NEURAL_NETWORK_PATH);
+        if (dr_neural_network_valid(pretrained_neural_network) && !dr_neural_network_save_to_binary_file(
+            pretrained_neural_network, DR_APPLICATION_LOAD_PRETRAINED_NEURAL_NETWORK_BINARY_PATH)) {
+            dr_print_error("Error to save the binary pretrained neural network\n");
+        }
+    }
     if (!dr_neural_network_valid(pretrained_neural_network)) {
         dr_print_error("Error to load the pretrained neural network\n");
     }
@@ -1242,8 +1368,8 @@ void dr_application_create() {
 
 void dr_application_close() {
     // training
-    if (training_process_active) {
-        training_process_active = false;
+    if (dr_atomic_load_acquire(&training_process_active)) {
+        dr_atomic_store_release(&training_process_active, false);
         const bool thread_join_result = dr_thread_join(training_thread_handle, training_thread_id);
         DR_ASSERT_MSG(thread_join_result, "thread join error when closing the application");
     }
@@ -1252,11 +1378,8 @@ void dr_application_close() {
         dr_print_error("Training thread close error in the application");
     }
 
-    if (!dr_mutex_close(training_mutex)) {
-        dr_print_error("Training mutex close error in the application");
-    }
-
     dr_application_training_hidden_layers_info_clear();
+    dr_neural_network_snapshots_free(user_neural_network_snapshots);
     if (dr_neural_network_valid(user_neural_network)) {
         dr_neural_network_free(&user_neural_network);
     }
@@ -1265,7 +1388,7 @@ void dr_application_close() {
     }
 
     // dataset
-    dr_application_dataset_clear();
+    dr_dataset_free(&dataset);
     UnloadRenderTexture(dataset_canvas_rtexture);
 
     // prediction
@@ -1273,104 +1396,4 @@ void dr_application_close() {
 
     // raylib window
     CloseWindow();
-}
-
-bool dr_is_cpu_low_endian() {
-    const int16_t number = 1;
-    return ((const unsigned char*)&number)[0] == 1;
-}
-
-void dr_swap_bytes(unsigned char* left, unsigned char* right) {
-    unsigned char temp = *left;
-    *left  = *right;
-    *right = temp;
-}
-
-uint32_t dr_reverse_bytes_32(uint32_t value) {
-    unsigned char* bytes = (unsigned char*)&value;
-    dr_swap_bytes(bytes, bytes + 3);
-    dr_swap_bytes(bytes + 1, bytes + 2);
-    return *((uint32_t*)bytes);
-}
-
-bool dr_application_mnist_to_dataset(const char* images, const char* labels, const char* dataset) {
-    const bool cpu_low_endian = dr_is_cpu_low_endian();
-
-    FILE* file_dataset = fopen(dataset, "wb");
-    if (!file_dataset) {
-        dr_print_error("Open file dataset error\n");
-        return false;
-    }
-
-    // IMAGES
-    FILE* file_images = fopen(images, "rb");
-    if (!file_images) {
-        dr_print_error("Open file images error\n");
-        fclose(file_dataset);
-        return false;
-    }
-
-    // read images header
-    uint32_t file_images_header[4] = { 0 };
-    (void) fread(file_images_header, sizeof(file_images_header), 1, file_images);
-    if (cpu_low_endian) {
-        for (size_t i = 0; i < DR_ARRAY_LENGTH(file_images_header); ++i) {
-            file_images_header[i] = dr_reverse_bytes_32(file_images_header[i]);
-        }
-    }
-    const uint32_t number_of_images  = file_images_header[1];
-    const uint32_t number_of_rows    = file_images_header[2];
-    const uint32_t number_of_columns = file_images_header[3];
-
-    // write dataset header
-    fwrite(&number_of_images, sizeof(uint32_t), 1, file_dataset);
-    fwrite(&number_of_rows, sizeof(uint32_t), 1, file_dataset);
-    fwrite(&number_of_columns, sizeof(uint32_t), 1, file_dataset);
-
-    // read images pixels
-    const size_t number_of_pixels_total = number_of_rows * number_of_columns * number_of_images;
-    const size_t pixels_buffer_size = sizeof(unsigned char) * number_of_pixels_total;
-    unsigned char* pixels_buffer = (unsigned char*)DR_MALLOC(pixels_buffer_size);
-    (void) fread(pixels_buffer, pixels_buffer_size, 1, file_images);
-    fclose(file_images);
-
-    // write pixels to dataset
-    fwrite(pixels_buffer, pixels_buffer_size, 1, file_dataset);
-    DR_FREE(pixels_buffer);
-
-    // LABELS
-    FILE* file_labels = fopen(labels, "rb");
-    if (!file_labels) {
-        dr_print_error("Open file labels error\n");
-        fclose(file_dataset);
-        return false;
-    }
-
-    // read labels header
-    uint32_t file_labels_header[2] = { 0 };
-    (void) fread(file_labels_header, sizeof(file_labels_header), 1, file_labels);
-    if (cpu_low_endian) {
-        for (size_t i = 0; i < 2; ++i) {
-            file_labels_header[i] = dr_reverse_bytes_32(file_labels_header[i]);
-        }
-    }
-    if (number_of_images != file_labels_header[1]) {
-        dr_print_error("The number of elements in file labels does not equal to the number of images in file images");
-        fclose(file_labels);
-        fclose(file_dataset);
-        return false;
-    }
-
-    // read labels
-    const size_t labels_buffer_size = sizeof(unsigned char) * number_of_images;
-    unsigned char* labels_buffer = (unsigned char*)DR_MALLOC(labels_buffer_size);
-    (void) fread(labels_buffer, labels_buffer_size, 1, file_labels);
-    fclose(file_labels);
-
-    // write labels to dataset
-    fwrite(labels_buffer, labels_buffer_size, 1, file_dataset);
-    DR_FREE(labels_buffer);
-    fclose(file_dataset);
-
-    return true;
 }
\ No newline at end of file
@@ -0,0 +1,144 @@
+#include <dataset/dr_dataset.h>
+#include <general/dr_file_mapping.h>
+#include <stdint.h>
+
+dr_dataset dr_dataset_create(const size_t image_size) {
+    DR_ASSERT_MSG(image_size > 0, "attempt to create a dataset of empty images");
+    dr_dataset dataset = { 0 };
+    dataset.image_size = image_size;
+    return dataset;
+}
+
+void dr_dataset_free(dr_dataset* dataset) {
+    DR_FREE(dataset->pixels);
+    DR_FREE(dataset->labels);
+    const size_t image_size = dataset->image_size;
+    memset(dataset, 0, sizeof(dr_dataset));
+    dataset->image_size = image_size;
+}
+
+void dr_dataset_clear(dr_dataset* dataset) {
+    dataset->count = 0;
+    memset(dataset->labels_counts, 0, sizeof(dataset->labels_counts));
+}
+
+void dr_dataset_unchecked_reserve(dr_dataset* dataset, const size_t capacity) {
+    if (capacity <= dataset->capacity) {
+        return;
+    }
+
+    unsigned char* reallocated_pixels = (unsigned char*)DR_REALLOC(
+        dataset->pixels, sizeof(unsigned char) * capacity * dataset->image_size);
+    DR_ASSERT_MSG(reallocated_pixels, "pixels reallocate error for the dataset");
+    unsigned char* reallocated_labels = (unsigned char*)DR_REALLOC(dataset->labels, sizeof(unsigned char) * capacity);
+    DR_ASSERT_MSG(reallocated_labels, "labels reallocate error for the dataset");
+
+    dataset->pixels   = reallocated_pixels;
+    dataset->labels   = reallocated_labels;
+    dataset->capacity = capacity;
+}
+
+void dr_dataset_reserve(dr_dataset* dataset, const size_t capacity) {
+    DR_ASSERT_MSG(dataset, "attempt to reserve memory for a NULL dataset");
+    DR_ASSERT_MSG(dataset->image_size > 0, "attempt to reserve memory for a not created dataset");
+    dr_dataset_unchecked_reserve(dataset, capacity);
+}
+
+void dr_dataset_unchecked_add(dr_dataset* dataset, const unsigned char* pixels, const unsigned char label) {
+    if (dataset->count == dataset->capacity) {
+        const size_t doubled_capacity = dataset->capacity * 2;
+        dr_dataset_unchecked_reserve(
+            dataset, doubled_capacity < DR_DATASET_MIN_CAPACITY ? DR_DATASET_MIN_CAPACITY : doubled_capacity);
+    }
+    memcpy(dataset->pixels + dataset->count * dataset->image_size, pixels, sizeof(unsigned char) * dataset->image_size);
+    dataset->labels[dataset->count] = label;
+    ++dataset->labels_counts[label];
+    ++dataset->count;
+}
+
+void dr_dataset_add(dr_dataset* dataset, const unsigned char* pixels, const unsigned char label) {
+    DR_ASSERT_MSG(dataset, "attempt to add an image to a NULL dataset");
+    DR_ASSERT_MSG(dataset->image_size > 0, "attempt to add an image to a not created dataset");
+    DR_ASSERT_MSG(pixels, "attempt to add NULL pixels to a dataset");
+    DR_ASSERT_MSG(label < DR_DATASET_LABELS_COUNT, "attempt to add an image with a not correct label to a dataset");
+    dr_dataset_unchecked_add(dataset, pixels, label);
+}
+
+const unsigned char* dr_dataset_unchecked_image(const dr_dataset dataset, const size_t index) {
+    return dataset.pixels + index * dataset.image_size;
+}
+
+const unsigned char* dr_dataset_image(const dr_dataset dataset, const size_t index) {
+    DR_ASSERT_MSG(index < dataset.count, "attempt to get an image out of range of the dataset");
+    return dr_dataset_unchecked_image(dataset, index);
+}
+
+void dr_dataset_shuffle_indices(
+    const dr_dataset_order order, dr_random* random, size_t* indices, const size_t count) {
+    if (order == dr_dataset_order_shuffle) {
+        dr_random_shuffle(random, indices, count);
+    } else if (order == dr_dataset_order_shuffle_blocks) {
+        dr_random_shuffle_blocks(random, indices, count, DR_DATASET_SHUFFLE_BLOCK_SIZE);
+    }
+}
+
+bool dr_dataset_load_mnist(dr_dataset* dataset, const char* file_path, const size_t count) {
+    DR_ASSERT_MSG(dataset, "attempt to load MNIST to a NULL dataset");
+    DR_ASSERT_MSG(dataset->image_size > 0, "attempt to load MNIST to a not created dataset");
+    DR_ASSERT_MSG(file_path, "attempt to load MNIST to a dataset with NULL file_path");
+
+    // the file is mapped, so the pixels and the labels are copied in bulk without stdio calls
+    dr_file_mapping mapping;
+    if (!dr_file_mapping_open(&mapping, file_path)) {
+        return false;
+    }
+
+    uint32_t header[3] = { 0 };
+    if (mapping.size < sizeof(header)) {
+        dr_print_error("The MNIST dataset file is too small\n");
+        dr_file_mapping_close(&mapping);
+        return false;
+    }
+    memcpy(header, mapping.data, sizeof(header));
+
+    if (count > header[0]) {
+        dr_print_error("Attempt to load more MNIST images than there are\n");
+        dr_file_mapping_close(&mapping);
+        return false;
+    }
+
+    if ((size_t)header[1] * header[2] != dataset->image_size) {
+        dr_print_error("Mismatch dataset image size and MNIST images resolution\n");
+        dr_file_mapping_close(&mapping);
+        return false;
+    }
+
+    const size_t images_size = (size_t)header[0] * dataset->image_size;
+    if (mapping.size < sizeof(header) + images_size + header[0]) {
+        dr_print_error("The MNIST dataset file is truncated\n");
+        dr_file_mapping_close(&mapping);
+        return false;
+    }
+    const unsigned char* images = (const unsigned char*)mapping.data + sizeof(header);
+    const unsigned char* labels = images + images_size;
+
+    for (size_t i = 0; i < count; ++i) {
+        if (labels[i] >= DR_DATASET_LABELS_COUNT) {
+            dr_print_error("The MNIST dataset file contains a not correct label\n");
+            dr_file_mapping_close(&mapping);
+            return false;
+        }
+    }
+
+    dr_dataset_unchecked_reserve(dataset, dataset->count + count);
+    memcpy(dataset->pixels + dataset->count * dataset->image_size, images, count * dataset->image_size);
+    memcpy(dataset->labels + dataset->count, labels, count);
+    for (size_t i = 0; i < count; ++i) {
+        ++dataset->labels_counts[labels[i]];
+    }
+    dataset->count += count;
+
+    dr_file_mapping_close(&mapping);
+
+    return true;
+}
\ No newline at end of file
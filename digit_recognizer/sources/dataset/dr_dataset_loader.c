@@ -0,0 +1,181 @@
+#include <dataset/dr_dataset_loader.h>
+#include <neural_network/dr_matrix_kernels.h>
+
+static inline void dr_dataset_loader_details_fill_batch(
+    const dr_dataset_loader* loader, dr_dataset_batch* batch, const size_t first_index, const size_t epoch) {
+    const size_t rest = loader->dataset.count - first_index;
+    batch->count = rest < loader->batch_size ? rest : loader->batch_size;
+    batch->epoch = epoch;
+
+    const dr_matrix_kernel_bytes_to_floats bytes_to_floats = dr_matrix_kernels_get()->bytes_to_floats;
+    const size_t image_size = loader->dataset.image_size;
+    memset(batch->outputs_elements, 0, sizeof(DR_FLOAT_TYPE) * batch->count * DR_DATASET_LABELS_COUNT);
+    for (size_t i = 0; i < batch->count; ++i) {
+        const size_t index = loader->indices[first_index + i];
+        bytes_to_floats(dr_dataset_unchecked_image(loader->dataset, index),
+            loader->scale, batch->pixels + i * image_size, image_size);
+        batch->outputs_elements[i * DR_DATASET_LABELS_COUNT + loader->dataset.labels[index]] = 1;
+    }
+}
+
+// called after the count the other side waits for is published: the fence orders that store before the load
+// of the waiting flag, the other side stores the flag before it rechecks the count, so one of them sees the other
+static inline void dr_dataset_loader_details_wake(dr_atomic_size_t* waiting, dr_semaphore_t* wakeup) {
+    dr_atomic_thread_fence();
+    if (dr_atomic_exchange(waiting, false)) {
+        dr_semaphore_post(wakeup, 1);
+    }
+}
+
+static dr_thread_function_result_t DR_WINAPI dr_dataset_loader_details_thread(void* data) {
+    dr_dataset_loader* loader = (dr_dataset_loader*)data;
+    size_t produced_count = 0;
+    for (size_t epoch = 0; epoch < loader->epochs_count && loader->dataset.count > 0; ++epoch) {
+        dr_dataset_shuffle_indices(loader->order, &loader->random, loader->indices, loader->dataset.count);
+        for (size_t first_index = 0; first_index < loader->dataset.count; first_index += loader->batch_size) {
+            // sleeps only while all the batches are taken by the consumer
+            while (produced_count - dr_atomic_load_acquire(&loader->consumed_count) ==
+                DR_DATASET_LOADER_BATCHES_COUNT) {
+                if (dr_atomic_load_acquire(&loader->stopping)) {
+                    return 0;
+                }
+                dr_atomic_store_release(&loader->producer_waiting, true);
+                dr_atomic_thread_fence();
+                if (produced_count - dr_atomic_load_acquire(&loader->consumed_count) ==
+                    DR_DATASET_LOADER_BATCHES_COUNT && !dr_atomic_load_acquire(&loader->stopping)) {
+                    dr_semaphore_wait(&loader->producer_wakeup);
+                }
+            }
+            if (dr_atomic_load_acquire(&loader->stopping)) {
+                return 0;
+            }
+
+            dr_dataset_loader_details_fill_batch(loader,
+                loader->batches + produced_count % DR_DATASET_LOADER_BATCHES_COUNT, first_index, epoch);
+            dr_atomic_store_release(&loader->produced_count, ++produced_count);
+            dr_dataset_loader_details_wake(&loader->consumer_waiting, &loader->consumer_wakeup);
+        }
+    }
+    dr_atomic_store_release(&loader->finished, true);
+    dr_dataset_loader_details_wake(&loader->consumer_waiting, &loader->consumer_wakeup);
+    return 0;
+}
+
+dr_dataset_loader* dr_dataset_loader_unchecked_create(const dr_dataset dataset, const size_t batch_size,
+    const DR_FLOAT_TYPE scale, const size_t epochs_count, const dr_dataset_order order, const uint64_t seed) {
+    dr_dataset_loader* loader = (dr_dataset_loader*)DR_MALLOC(sizeof(dr_dataset_loader));
+    DR_ASSERT_MSG(loader, "alloc dataset loader error");
+    loader->dataset        = dataset;
+    loader->scale          = scale;
+    loader->batch_size     = batch_size;
+    loader->epochs_count   = epochs_count;
+    loader->order          = order;
+    loader->random         = dr_random_create(seed);
+    loader->produced_count = 0;
+    loader->consumed_count = 0;
+    loader->finished         = false;
+    loader->stopping         = false;
+    loader->producer_waiting = false;
+    loader->consumer_waiting = false;
+
+    const bool producer_wakeup_create_result = dr_semaphore_create(&loader->producer_wakeup, 0);
+    DR_ASSERT_MSG(producer_wakeup_create_result, "dataset loader producer wakeup semaphore create error");
+    (void)producer_wakeup_create_result;
+    const bool consumer_wakeup_create_result = dr_semaphore_create(&loader->consumer_wakeup, 0);
+    DR_ASSERT_MSG(consumer_wakeup_create_result, "dataset loader consumer wakeup semaphore create error");
+    (void)consumer_wakeup_create_result;
+
+    // one more index, so an empty dataset doesn't allocate zero bytes
+    loader->indices = (size_t*)DR_MALLOC(sizeof(size_t) * (dataset.count + 1));
+    DR_ASSERT_MSG(loader->indices, "alloc dataset loader indices error");
+    for (size_t i = 0; i < dataset.count; ++i) {
+        loader->indices[i] = i;
+    }
+
+    for (size_t i = 0; i < DR_DATASET_LOADER_BATCHES_COUNT; ++i) {
+        dr_dataset_batch* batch = loader->batches + i;
+        batch->pixels = (DR_FLOAT_TYPE*)dr_aligned_malloc(
+            sizeof(DR_FLOAT_TYPE) * batch_size * dataset.image_size, DR_DATASET_LOADER_ALIGNMENT);
+        DR_ASSERT_MSG(batch->pixels, "alloc dataset loader batch pixels error");
+        batch->outputs_elements =
+            (DR_FLOAT_TYPE*)DR_MALLOC(sizeof(DR_FLOAT_TYPE) * batch_size * DR_DATASET_LABELS_COUNT);
+        DR_ASSERT_MSG(batch->outputs_elements, "alloc dataset loader batch outputs error");
+        batch->inputs = (const DR_FLOAT_TYPE**)DR_MALLOC(sizeof(DR_FLOAT_TYPE*) * batch_size);
+        DR_ASSERT_MSG(batch->inputs, "alloc dataset loader batch inputs pointers error");
+        batch->outputs = (const DR_FLOAT_TYPE**)DR_MALLOC(sizeof(DR_FLOAT_TYPE*) * batch_size);
+        DR_ASSERT_MSG(batch->outputs, "alloc dataset loader batch outputs pointers error");
+        for (size_t j = 0; j < batch_size; ++j) {
+            batch->inputs[j]  = batch->pixels + j * dataset.image_size;
+            batch->outputs[j] = batch->outputs_elements + j * DR_DATASET_LABELS_COUNT;
+        }
+        batch->count = 0;
+        batch->epoch = 0;
+    }
+
+    loader->thread_handle =
+        dr_thread_create_with_data(&loader->thread_id, dr_dataset_loader_details_thread, loader);
+    DR_ASSERT_MSG(dr_check_thread_handle(loader->thread_handle), "dataset loader thread create error");
+
+    return loader;
+}
+
+dr_dataset_loader* dr_dataset_loader_create(const dr_dataset dataset, const size_t batch_size,
+    const DR_FLOAT_TYPE scale, const size_t epochs_count, const dr_dataset_order order, const uint64_t seed) {
+    DR_ASSERT_MSG(dataset.image_size > 0, "attempt to create a loader for a not created dataset");
+    DR_ASSERT_MSG(batch_size > 0, "attempt to create a dataset loader with zero batch size");
+    DR_ASSERT_MSG(order >= dr_dataset_order_sequential && order <= dr_dataset_order_shuffle_blocks,
+        "attempt to create a dataset loader with an unknown order");
+    return dr_dataset_loader_unchecked_create(dataset, batch_size, scale, epochs_count, order, seed);
+}
+
+void dr_dataset_loader_free(dr_dataset_loader* loader) {
+    if (!loader) {
+        return;
+    }
+
+    dr_atomic_store_release(&loader->stopping, true);
+    dr_dataset_loader_details_wake(&loader->producer_waiting, &loader->producer_wakeup);
+    const bool thread_join_result = dr_thread_join(loader->thread_handle, loader->thread_id);
+    DR_ASSERT_MSG(thread_join_result, "dataset loader thread join error");
+    (void)thread_join_result;
+    dr_thread_close(loader->thread_handle);
+    dr_semaphore_close(&loader->producer_wakeup);
+    dr_semaphore_close(&loader->consumer_wakeup);
+
+    for (size_t i = 0; i < DR_DATASET_LOADER_BATCHES_COUNT; ++i) {
+        dr_aligned_free(loader->batches[i].pixels);
+        DR_FREE(loader->batches[i].outputs_elements);
+        DR_FREE(loader->batches[i].inputs);
+        DR_FREE(loader->batches[i].outputs);
+    }
+    DR_FREE(loader->indices);
+    DR_FREE(loader);
+}
+
+const dr_dataset_batch* dr_dataset_loader_acquire(dr_dataset_loader* loader) {
+    DR_ASSERT_MSG(loader, "attempt to acquire a batch from a NULL dataset loader");
+    const size_t consumed_count = loader->consumed_count;
+    while (dr_atomic_load_acquire(&loader->produced_count) == consumed_count) {
+        // finished is stored after the last batch, so produced_count read after it is final
+        if (dr_atomic_load_acquire(&loader->finished)) {
+            if (dr_atomic_load_acquire(&loader->produced_count) == consumed_count) {
+                return NULL;
+            }
+            break;
+        }
+        // a wakeup left from an earlier wait only makes the loop check the counts once more
+        dr_atomic_store_release(&loader->consumer_waiting, true);
+        dr_atomic_thread_fence();
+        if (dr_atomic_load_acquire(&loader->produced_count) == consumed_count &&
+            !dr_atomic_load_acquire(&loader->finished)) {
+            dr_semaphore_wait(&loader->consumer_wakeup);
+        }
+    }
+    return loader->batches + consumed_count % DR_DATASET_LOADER_BATCHES_COUNT;
+}
+
+void dr_dataset_loader_release(dr_dataset_loader* loader) {
+    DR_ASSERT_MSG(loader, "attempt to release a batch of a NULL dataset loader");
+    dr_atomic_store_release(&loader->consumed_count, loader->consumed_count + 1);
+    dr_dataset_loader_details_wake(&loader->producer_waiting, &loader->producer_wakeup);
+}
\ No newline at end of file
@@ -0,0 +1,150 @@
+#include <dataset/dr_idx.h>
+#include <stdint.h>
+
+#ifdef DR_USE_ZLIB
+  #include <zlib.h>
+#endif // DR_USE_ZLIB
+
+// zlib reads both the compressed and the not compressed files
+typedef struct {
+#ifdef DR_USE_ZLIB
+    gzFile file;
+#else
+    FILE* file;
+#endif // DR_USE_ZLIB
+} dr_idx_details_stream;
+
+static inline bool dr_idx_details_stream_open(dr_idx_details_stream* stream, const char* file_path) {
+#ifdef DR_USE_ZLIB
+    stream->file = gzopen(file_path, "rb");
+    if (!stream->file) {
+        return false;
+    }
+    gzbuffer(stream->file, DR_IDX_CHUNK_SIZE);
+    return true;
+#else
+    stream->file = fopen(file_path, "rb");
+    if (!stream->file) {
+        return false;
+    }
+    // the gzip magic
+    const int first_byte  = fgetc(stream->file);
+    const int second_byte = fgetc(stream->file);
+    if (first_byte == 0x1F && second_byte == 0x8B) {
+        dr_print_error("The IDX file is gzip compressed, but the library is built without zlib\n");
+        fclose(stream->file);
+        return false;
+    }
+    rewind(stream->file);
+    return true;
+#endif // DR_USE_ZLIB
+}
+
+static inline void dr_idx_details_stream_close(dr_idx_details_stream* stream) {
+#ifdef DR_USE_ZLIB
+    gzclose(stream->file);
+#else
+    fclose(stream->file);
+#endif // DR_USE_ZLIB
+}
+
+// reads exactly size bytes chunk by chunk
+static bool dr_idx_details_stream_read(dr_idx_details_stream* stream, void* buffer, const size_t size) {
+    unsigned char* bytes = (unsigned char*)buffer;
+    for (size_t offset = 0; offset < size; offset += DR_IDX_CHUNK_SIZE) {
+        const size_t rest       = size - offset;
+        const size_t chunk_size = rest < DR_IDX_CHUNK_SIZE ? rest : DR_IDX_CHUNK_SIZE;
+#ifdef DR_USE_ZLIB
+        if (gzread(stream->file, bytes + offset, (unsigned int)chunk_size) != (int)chunk_size) {
+            return false;
+        }
+#else
+        if (fread(bytes + offset, 1, chunk_size, stream->file) != chunk_size) {
+            return false;
+        }
+#endif // DR_USE_ZLIB
+    }
+    return true;
+}
+
+static inline bool dr_idx_details_read_header(
+    dr_idx_details_stream* stream, uint32_t* header, const size_t header_size) {
+    unsigned char bytes[4 * 4] = { 0 };
+    if (!dr_idx_details_stream_read(stream, bytes, 4 * header_size)) {
+        return false;
+    }
+    // big endian regardless of the CPU
+    for (size_t i = 0; i < header_size; ++i) {
+        const unsigned char* value = bytes + 4 * i;
+        header[i] = ((uint32_t)value[0] << 24) | ((uint32_t)value[1] << 16) | ((uint32_t)value[2] << 8) | value[3];
+    }
+    return true;
+}
+
+bool dr_idx_gzip_supported() {
+#ifdef DR_USE_ZLIB
+    return true;
+#else
+    return false;
+#endif // DR_USE_ZLIB
+}
+
+bool dr_dataset_load_idx(
+    dr_dataset* dataset, const char* images_file_path, const char* labels_file_path, const size_t count) {
+    DR_ASSERT_MSG(dataset, "attempt to load IDX to a NULL dataset");
+    DR_ASSERT_MSG(dataset->image_size > 0, "attempt to load IDX to a not created dataset");
+    DR_ASSERT_MSG(images_file_path && labels_file_path, "attempt to load IDX to a dataset with NULL file path");
+
+    dr_idx_details_stream images_stream;
+    if (!dr_idx_details_stream_open(&images_stream, images_file_path)) {
+        return false;
+    }
+    dr_idx_details_stream labels_stream;
+    if (!dr_idx_details_stream_open(&labels_stream, labels_file_path)) {
+        dr_idx_details_stream_close(&images_stream);
+        return false;
+    }
+
+    bool result = false;
+    uint32_t images_header[4] = { 0 };
+    uint32_t labels_header[2] = { 0 };
+    if (!dr_idx_details_read_header(&images_stream, images_header, DR_ARRAY_LENGTH(images_header)) ||
+        !dr_idx_details_read_header(&labels_stream, labels_header, DR_ARRAY_LENGTH(labels_header))) {
+        dr_print_error("The IDX file is too small\n");
+    } else if (images_header[0] != DR_IDX_IMAGES_MAGIC || labels_header[0] != DR_IDX_LABELS_MAGIC) {
+        dr_print_error("Not correct magic of the IDX file\n");
+    } else if (images_header[1] != labels_header[1]) {
+        dr_print_error("The number of labels doesn't equal to the number of images in the IDX files\n");
+    } else if (count > images_header[1]) {
+        dr_print_error("Attempt to load more IDX images than there are\n");
+    } else if ((size_t)images_header[2] * images_header[3] != dataset->image_size) {
+        dr_print_error("Mismatch dataset image size and IDX images resolution\n");
+    } else {
+        // the items are only counted when everything has been read, so the dataset stays the same on errors
+        dr_dataset_unchecked_reserve(dataset, dataset->count + count);
+        unsigned char* pixels = dataset->pixels + dataset->count * dataset->image_size;
+        unsigned char* labels = dataset->labels + dataset->count;
+        result = dr_idx_details_stream_read(&images_stream, pixels, count * dataset->image_size) &&
+            dr_idx_details_stream_read(&labels_stream, labels, count);
+        if (!result) {
+            dr_print_error("The IDX file is truncated\n");
+        }
+        for (size_t i = 0; result && i < count; ++i) {
+            if (labels[i] >= DR_DATASET_LABELS_COUNT) {
+                dr_print_error("The IDX file contains a not correct label\n");
+                result = false;
+            }
+        }
+        for (size_t i = 0; result && i < count; ++i) {
+            ++dataset->labels_counts[labels[i]];
+        }
+        if (result) {
+            dataset->count += count;
+        }
+    }
+
+    dr_idx_details_stream_close(&labels_stream);
+    dr_idx_details_stream_close(&images_stream);
+
+    return result;
+}
\ No newline at end of file
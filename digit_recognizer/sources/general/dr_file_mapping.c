@@ -0,0 +1,81 @@
+#include <general/dr_file_mapping.h>
+#include <general/dr_utils.h>
+#include <stdint.h>
+
+#ifdef _WIN32
+  #include <Windows.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif // _WIN32
+
+bool dr_file_mapping_open(dr_file_mapping* mapping, const char* file_path) {
+    DR_ASSERT_MSG(mapping, "attempt to open a file mapping with NULL mapping");
+    DR_ASSERT_MSG(file_path, "attempt to open a file mapping with NULL file_path");
+    memset(mapping, 0, sizeof(dr_file_mapping));
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(file_path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart <= 0 || (ULONGLONG)file_size.QuadPart > SIZE_MAX) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE file_mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!file_mapping) {
+        CloseHandle(file);
+        return false;
+    }
+    const void* data = MapViewOfFile(file_mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!data) {
+        CloseHandle(file_mapping);
+        CloseHandle(file);
+        return false;
+    }
+    mapping->data           = data;
+    mapping->size           = (size_t)file_size.QuadPart;
+    mapping->file_handle    = file;
+    mapping->mapping_handle = file_mapping;
+#else
+    const int file = open(file_path, O_RDONLY);
+    if (file < 0) {
+        return false;
+    }
+    struct stat file_stat;
+    if (fstat(file, &file_stat) != 0 || file_stat.st_size <= 0) {
+        close(file);
+        return false;
+    }
+    void* data = mmap(NULL, (size_t)file_stat.st_size, PROT_READ, MAP_SHARED, file, 0);
+    // the mapping stays valid after the descriptor is closed
+    close(file);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+    mapping->data = data;
+    mapping->size = (size_t)file_stat.st_size;
+#endif // _WIN32
+
+    return true;
+}
+
+void dr_file_mapping_close(dr_file_mapping* mapping) {
+    DR_ASSERT_MSG(mapping, "attempt to close a NULL file mapping");
+    if (!mapping->data) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(mapping->data);
+    CloseHandle(mapping->mapping_handle);
+    CloseHandle(mapping->file_handle);
+#else
+    munmap((void*)mapping->data, mapping->size);
+#endif // _WIN32
+    memset(mapping, 0, sizeof(dr_file_mapping));
+}
\ No newline at end of file
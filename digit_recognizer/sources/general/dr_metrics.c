@@ -0,0 +1,53 @@
+#include <general/dr_metrics.h>
+#include <general/dr_time.h>
+#include <string.h>
+
+void dr_metrics_channel_init(dr_metrics_channel* channel, const double publish_interval) {
+    channel->sequence = 0;
+    for (size_t i = 0; i < DR_METRICS_WORDS_COUNT; ++i) {
+        channel->words[i] = 0;
+    }
+    channel->publish_interval  = publish_interval;
+    channel->last_publish_time = dr_time_seconds() - publish_interval; // <- the first snapshot goes at once
+}
+
+void dr_metrics_channel_publish(dr_metrics_channel* channel, const dr_training_metrics* metrics) {
+    size_t words[DR_METRICS_WORDS_COUNT] = { 0 };
+    memcpy(words, metrics, sizeof(dr_training_metrics));
+
+    const size_t sequence = dr_atomic_load_acquire(&channel->sequence);
+    dr_atomic_store_release(&channel->sequence, sequence + 1);
+    // the odd sequence has to be visible before any word of the new snapshot
+    dr_atomic_thread_fence();
+    for (size_t i = 0; i < DR_METRICS_WORDS_COUNT; ++i) {
+        dr_atomic_store_release(channel->words + i, words[i]);
+    }
+    dr_atomic_store_release(&channel->sequence, sequence + 2);
+    channel->last_publish_time = dr_time_seconds();
+}
+
+bool dr_metrics_channel_publish_throttled(dr_metrics_channel* channel, const dr_training_metrics* metrics) {
+    if (dr_time_seconds() - channel->last_publish_time < channel->publish_interval) {
+        return false;
+    }
+    dr_metrics_channel_publish(channel, metrics);
+    return true;
+}
+
+void dr_metrics_channel_read(const dr_metrics_channel* channel, dr_training_metrics* metrics) {
+    size_t words[DR_METRICS_WORDS_COUNT];
+    while (true) {
+        const size_t sequence = dr_atomic_load_acquire(&channel->sequence);
+        if (sequence % 2 != 0) {
+            dr_thread_yield();
+            continue;
+        }
+        for (size_t i = 0; i < DR_METRICS_WORDS_COUNT; ++i) {
+            words[i] = dr_atomic_load_acquire(channel->words + i);
+        }
+        if (dr_atomic_load_acquire(&channel->sequence) == sequence) {
+            break;
+        }
+    }
+    memcpy(metrics, words, sizeof(dr_training_metrics));
+}
\ No newline at end of file
@@ -0,0 +1,392 @@
+#include <general/dr_parallel.h>
+#include <general/dr_utils.h>
+
+static void* volatile dr_parallel_details_default = NULL;
+
+// the worker running on the current thread, NULL on the threads outside the schedulers
+static DR_THREAD_LOCAL dr_parallel_worker* dr_parallel_details_current_worker = NULL;
+
+static inline dr_parallel_worker* dr_parallel_details_get_worker(dr_parallel_scheduler* scheduler) {
+    dr_parallel_worker* worker = dr_parallel_details_current_worker;
+    return worker && worker->scheduler == scheduler ? worker : NULL;
+}
+
+static inline dr_parallel_task* dr_parallel_details_load_slot(dr_parallel_worker* worker, const size_t index) {
+    return (dr_parallel_task*)dr_atomic_load_pointer_acquire(
+        (void* const volatile*)(worker->tasks + (index & (DR_PARALLEL_DEQUE_CAPACITY - 1))));
+}
+
+static inline void dr_parallel_details_store_slot(
+    dr_parallel_worker* worker, const size_t index, dr_parallel_task* task) {
+    dr_atomic_store_pointer_release(
+        (void* volatile*)(worker->tasks + (index & (DR_PARALLEL_DEQUE_CAPACITY - 1))), task);
+}
+
+// the owner only, returns false if the deque is full
+static inline bool dr_parallel_details_push(dr_parallel_worker* worker, dr_parallel_task* task) {
+    const size_t bottom = dr_atomic_load_acquire(&worker->bottom);
+    const size_t top    = dr_atomic_load_acquire(&worker->top);
+    if (bottom - top >= DR_PARALLEL_DEQUE_CAPACITY) {
+        return false;
+    }
+    dr_parallel_details_store_slot(worker, bottom, task);
+    dr_atomic_store_release(&worker->bottom, bottom + 1);
+    return true;
+}
+
+// the owner only, takes the newest task
+static inline dr_parallel_task* dr_parallel_details_take(dr_parallel_worker* worker) {
+    // the bottom is moved before the top is read, so a thief and the owner can't both get the last task
+    // without the compare exchange below
+    const size_t bottom = dr_atomic_load_acquire(&worker->bottom) - 1;
+    dr_atomic_store_release(&worker->bottom, bottom);
+    dr_atomic_thread_fence();
+    const size_t top = dr_atomic_load_acquire(&worker->top);
+    if ((ptrdiff_t)(bottom - top) < 0) {
+        dr_atomic_store_release(&worker->bottom, bottom + 1);
+        return NULL;
+    }
+
+    dr_parallel_task* task = dr_parallel_details_load_slot(worker, bottom);
+    if (bottom != top) {
+        return task;
+    }
+    if (!dr_atomic_compare_exchange(&worker->top, top, top + 1)) {
+        task = NULL;
+    }
+    dr_atomic_store_release(&worker->bottom, bottom + 1);
+    return task;
+}
+
+// any thread, takes the oldest task
+static inline dr_parallel_task* dr_parallel_details_steal(dr_parallel_worker* victim) {
+    const size_t top = dr_atomic_load_acquire(&victim->top);
+    dr_atomic_thread_fence();
+    const size_t bottom = dr_atomic_load_acquire(&victim->bottom);
+    if ((ptrdiff_t)(bottom - top) <= 0) {
+        return NULL;
+    }
+
+    // the slot may be reused once the top has moved, then the compare exchange fails
+    dr_parallel_task* task = dr_parallel_details_load_slot(victim, top);
+    return dr_atomic_compare_exchange(&victim->top, top, top + 1) ? task : NULL;
+}
+
+static inline void dr_parallel_details_push_outside(dr_parallel_scheduler* scheduler, dr_parallel_task* task) {
+    task->next = NULL;
+    dr_mutex_lock(&scheduler->mutex);
+    if (scheduler->outside_last) {
+        scheduler->outside_last->next = task;
+    } else {
+        scheduler->outside_first = task;
+    }
+    scheduler->outside_last = task;
+    dr_atomic_fetch_add(&scheduler->outside_count, 1);
+    dr_mutex_unlock(&scheduler->mutex);
+}
+
+static inline dr_parallel_task* dr_parallel_details_pop_outside(dr_parallel_scheduler* scheduler) {
+    if (dr_atomic_load_acquire(&scheduler->outside_count) == 0) {
+        return NULL;
+    }
+
+    dr_mutex_lock(&scheduler->mutex);
+    dr_parallel_task* task = scheduler->outside_first;
+    if (task) {
+        scheduler->outside_first = task->next;
+        if (!scheduler->outside_first) {
+            scheduler->outside_last = NULL;
+        }
+        dr_atomic_fetch_add(&scheduler->outside_count, (size_t)-1);
+    }
+    dr_mutex_unlock(&scheduler->mutex);
+    return task;
+}
+
+// worker can be NULL
+static dr_parallel_task* dr_parallel_details_find(dr_parallel_scheduler* scheduler, dr_parallel_worker* worker) {
+    dr_parallel_task* task = NULL;
+    if (worker && (task = dr_parallel_details_take(worker))) {
+        return task;
+    }
+    if ((task = dr_parallel_details_pop_outside(scheduler))) {
+        return task;
+    }
+    if (scheduler->workers_count == 0) {
+        return NULL;
+    }
+
+    // every victim is tried once starting from a random one, so the thieves don't line up behind the same worker
+    const size_t first_victim = worker ? dr_random_below(&worker->random, scheduler->workers_count) :
+        dr_atomic_fetch_add(&scheduler->steal_counter, 1) % scheduler->workers_count;
+    for (size_t i = 0; i < scheduler->workers_count; ++i) {
+        dr_parallel_worker* victim = scheduler->workers + (first_victim + i) % scheduler->workers_count;
+        if (victim != worker && (task = dr_parallel_details_steal(victim))) {
+            return task;
+        }
+    }
+    return NULL;
+}
+
+static inline void dr_parallel_details_run(dr_parallel_task* task) {
+    task->function(task->data);
+    dr_atomic_store_release(&task->done, true);
+}
+
+// decrements the number of the sleeping workers if it isn't zero
+static inline bool dr_parallel_details_take_sleeper(dr_parallel_scheduler* scheduler) {
+    size_t sleeping_count = dr_atomic_load_acquire(&scheduler->sleeping_count);
+    while (sleeping_count > 0) {
+        if (dr_atomic_compare_exchange(&scheduler->sleeping_count, sleeping_count, sleeping_count - 1)) {
+            return true;
+        }
+        sleeping_count = dr_atomic_load_acquire(&scheduler->sleeping_count);
+    }
+    return false;
+}
+
+// a single sleeping worker is woken up per a forked task
+static inline void dr_parallel_details_wake(dr_parallel_scheduler* scheduler) {
+    dr_atomic_thread_fence();
+    if (dr_parallel_details_take_sleeper(scheduler)) {
+        dr_semaphore_post(&scheduler->semaphore, 1);
+    }
+}
+
+static dr_thread_function_result_t DR_WINAPI dr_parallel_details_worker_thread(void* data) {
+    dr_parallel_worker* worker         = (dr_parallel_worker*)data;
+    dr_parallel_scheduler* scheduler   = worker->scheduler;
+    dr_parallel_details_current_worker = worker;
+
+    size_t failed_count = 0;
+    while (!dr_atomic_load_acquire(&scheduler->stopping)) {
+        dr_parallel_task* task = dr_parallel_details_find(scheduler, worker);
+        if (task) {
+            dr_parallel_details_run(task);
+            failed_count = 0;
+            continue;
+        }
+        if (++failed_count < DR_PARALLEL_SPIN_COUNT) {
+            dr_thread_yield();
+            continue;
+        }
+
+        // the sleep is announced before the last look, so either the fork sees the sleeper
+        // or the worker sees the forked task
+        failed_count = 0;
+        dr_atomic_fetch_add(&scheduler->sleeping_count, 1);
+        dr_atomic_thread_fence();
+        task = dr_parallel_details_find(scheduler, worker);
+        if (task || dr_atomic_load_acquire(&scheduler->stopping)) {
+            // a fork has taken the worker already, its post has to be consumed
+            if (!dr_parallel_details_take_sleeper(scheduler)) {
+                dr_semaphore_wait(&scheduler->semaphore);
+            }
+            if (task) {
+                dr_parallel_details_run(task);
+            }
+            continue;
+        }
+        dr_semaphore_wait(&scheduler->semaphore);
+    }
+
+    dr_parallel_details_current_worker = NULL;
+    return 0;
+}
+
+dr_parallel_scheduler* dr_parallel_scheduler_create(const size_t workers_count) {
+    dr_parallel_scheduler* scheduler = (dr_parallel_scheduler*)DR_MALLOC(sizeof(dr_parallel_scheduler));
+    DR_ASSERT_MSG(scheduler, "alloc parallel scheduler error");
+    scheduler->workers_count  = workers_count;
+    scheduler->outside_first  = NULL;
+    scheduler->outside_last   = NULL;
+    scheduler->outside_count  = 0;
+    scheduler->steal_counter  = 0;
+    scheduler->sleeping_count = 0;
+    scheduler->stopping       = false;
+
+    scheduler->mutex = dr_mutex_create();
+    DR_ASSERT_MSG(dr_check_mutex(scheduler->mutex), "parallel scheduler mutex create error");
+    const bool semaphore_created = dr_semaphore_create(&scheduler->semaphore, 0);
+    DR_ASSERT_MSG(semaphore_created, "parallel scheduler semaphore create error");
+    (void)semaphore_created;
+
+    // one more element, so zero workers don't allocate zero bytes
+    scheduler->workers = (dr_parallel_worker*)DR_MALLOC(sizeof(dr_parallel_worker) * (workers_count + 1));
+    DR_ASSERT_MSG(scheduler->workers, "alloc parallel scheduler workers error");
+    for (size_t i = 0; i < workers_count; ++i) {
+        dr_parallel_worker* worker = scheduler->workers + i;
+        worker->scheduler = scheduler;
+        worker->tasks     = (dr_parallel_task* volatile*)DR_MALLOC(
+            sizeof(dr_parallel_task*) * DR_PARALLEL_DEQUE_CAPACITY);
+        DR_ASSERT_MSG(worker->tasks, "alloc parallel scheduler deque error");
+        worker->top    = 0;
+        worker->bottom = 0;
+        worker->random = dr_random_create(i + 1);
+    }
+
+    scheduler->threads_ids = (dr_thread_id_t*)DR_MALLOC(sizeof(dr_thread_id_t) * (workers_count + 1));
+    DR_ASSERT_MSG(scheduler->threads_ids, "alloc parallel scheduler threads ids error");
+    scheduler->threads_handles = (dr_thread_handle_t*)DR_MALLOC(sizeof(dr_thread_handle_t) * (workers_count + 1));
+    DR_ASSERT_MSG(scheduler->threads_handles, "alloc parallel scheduler threads handles error");
+    for (size_t i = 0; i < workers_count; ++i) {
+        scheduler->threads_handles[i] = dr_thread_create_with_data(
+            scheduler->threads_ids + i, dr_parallel_details_worker_thread, scheduler->workers + i);
+        DR_ASSERT_MSG(dr_check_thread_handle(scheduler->threads_handles[i]), "parallel scheduler thread create error");
+    }
+
+    return scheduler;
+}
+
+void dr_parallel_scheduler_free(dr_parallel_scheduler* scheduler) {
+    if (!scheduler) {
+        return;
+    }
+
+    DR_ASSERT_MSG(dr_atomic_load_acquire(&scheduler->outside_count) == 0,
+        "attempt to free a parallel scheduler with the tasks that haven't been joined");
+    dr_atomic_store_release(&scheduler->stopping, true);
+    dr_semaphore_post(&scheduler->semaphore, scheduler->workers_count);
+    for (size_t i = 0; i < scheduler->workers_count; ++i) {
+        const bool thread_join_result = dr_thread_join(scheduler->threads_handles[i], scheduler->threads_ids[i]);
+        DR_ASSERT_MSG(thread_join_result, "parallel scheduler thread join error");
+        (void)thread_join_result;
+        dr_thread_close(scheduler->threads_handles[i]);
+        DR_FREE((void*)scheduler->workers[i].tasks);
+    }
+
+    dr_semaphore_close(&scheduler->semaphore);
+    dr_mutex_close(scheduler->mutex);
+    DR_FREE(scheduler->workers);
+    DR_FREE(scheduler->threads_ids);
+    DR_FREE(scheduler->threads_handles);
+    DR_FREE(scheduler);
+}
+
+dr_parallel_scheduler* dr_parallel_scheduler_get_default() {
+    dr_parallel_scheduler* scheduler =
+        (dr_parallel_scheduler*)dr_atomic_load_pointer_acquire(&dr_parallel_details_default);
+    if (scheduler) {
+        return scheduler;
+    }
+
+    // the threads calling it at once may create several schedulers, only one of them is kept
+    dr_parallel_scheduler* created_scheduler = dr_parallel_scheduler_create(dr_thread_hardware_concurrency() - 1);
+    if (dr_atomic_compare_exchange_pointer(&dr_parallel_details_default, NULL, created_scheduler)) {
+        return created_scheduler;
+    }
+    dr_parallel_scheduler_free(created_scheduler);
+    return (dr_parallel_scheduler*)dr_atomic_load_pointer_acquire(&dr_parallel_details_default);
+}
+
+dr_parallel_scheduler* dr_parallel_scheduler_set_default(dr_parallel_scheduler* scheduler) {
+    void* previous_scheduler = dr_atomic_load_pointer_acquire(&dr_parallel_details_default);
+    while (!dr_atomic_compare_exchange_pointer(&dr_parallel_details_default, previous_scheduler, scheduler)) {
+        previous_scheduler = dr_atomic_load_pointer_acquire(&dr_parallel_details_default);
+    }
+    return (dr_parallel_scheduler*)previous_scheduler;
+}
+
+void dr_parallel_task_init(dr_parallel_task* task, dr_task_function function, void* data) {
+    task->function = function;
+    task->data     = data;
+    task->next     = NULL;
+    dr_atomic_store_release(&task->done, false);
+}
+
+bool dr_parallel_task_done(const dr_parallel_task* task) {
+    return dr_atomic_load_acquire(&task->done);
+}
+
+void dr_parallel_unchecked_fork(dr_parallel_scheduler* scheduler, dr_parallel_task* task) {
+    dr_parallel_worker* worker = dr_parallel_details_get_worker(scheduler);
+    if (!worker) {
+        dr_parallel_details_push_outside(scheduler, task);
+    } else if (!dr_parallel_details_push(worker, task)) {
+        dr_parallel_details_run(task);
+        return;
+    }
+    dr_parallel_details_wake(scheduler);
+}
+
+void dr_parallel_fork(dr_parallel_scheduler* scheduler, dr_parallel_task* task) {
+    DR_ASSERT_MSG(scheduler, "attempt to fork a task on a NULL parallel scheduler");
+    DR_ASSERT_MSG(task, "attempt to fork a NULL task");
+    DR_ASSERT_MSG(task->function, "attempt to fork a task with a NULL function");
+    dr_parallel_unchecked_fork(scheduler, task);
+}
+
+void dr_parallel_unchecked_join(dr_parallel_scheduler* scheduler, dr_parallel_task* task) {
+    // the task forked last is on the bottom of the deque, so usually it's taken back and run right here
+    dr_parallel_worker* worker = dr_parallel_details_get_worker(scheduler);
+    while (!dr_parallel_task_done(task)) {
+        dr_parallel_task* other_task = dr_parallel_details_find(scheduler, worker);
+        if (other_task) {
+            dr_parallel_details_run(other_task);
+        } else {
+            dr_thread_yield();
+        }
+    }
+}
+
+void dr_parallel_join(dr_parallel_scheduler* scheduler, dr_parallel_task* task) {
+    DR_ASSERT_MSG(scheduler, "attempt to join a task on a NULL parallel scheduler");
+    DR_ASSERT_MSG(task, "attempt to join a NULL task");
+    dr_parallel_unchecked_join(scheduler, task);
+}
+
+typedef struct {
+    dr_parallel_scheduler* scheduler;
+    dr_parallel_for_function function;
+    void* data;
+    size_t grain_size;
+} dr_parallel_details_for_context;
+
+typedef struct {
+    const dr_parallel_details_for_context* context;
+    size_t begin;
+    size_t end;
+} dr_parallel_details_for_range;
+
+static void dr_parallel_details_for_run(void* data) {
+    const dr_parallel_details_for_range* range     = (const dr_parallel_details_for_range*)data;
+    const dr_parallel_details_for_context* context = range->context;
+    const size_t count = range->end - range->begin;
+    if (count <= context->grain_size) {
+        context->function(context->data, range->begin, range->end);
+        return;
+    }
+
+    const size_t middle = range->begin + count / 2;
+    dr_parallel_details_for_range right_range = { context, middle, range->end };
+    dr_parallel_task right_task;
+    dr_parallel_task_init(&right_task, dr_parallel_details_for_run, &right_range);
+    dr_parallel_unchecked_fork(context->scheduler, &right_task);
+
+    const dr_parallel_details_for_range left_range = { context, range->begin, middle };
+    dr_parallel_details_for_run((void*)&left_range);
+    dr_parallel_unchecked_join(context->scheduler, &right_task);
+}
+
+void dr_parallel_unchecked_for(dr_parallel_scheduler* scheduler, const size_t begin, const size_t end,
+    const size_t grain_size, dr_parallel_for_function function, void* data) {
+    if (begin >= end) {
+        return;
+    }
+
+    dr_parallel_details_for_context context;
+    context.scheduler  = scheduler;
+    context.function   = function;
+    context.data       = data;
+    context.grain_size = grain_size;
+    dr_parallel_details_for_range range = { &context, begin, end };
+    dr_parallel_details_for_run(&range);
+}
+
+void dr_parallel_for(dr_parallel_scheduler* scheduler, const size_t begin, const size_t end,
+    const size_t grain_size, dr_parallel_for_function function, void* data) {
+    DR_ASSERT_MSG(scheduler, "attempt to run parallel for on a NULL parallel scheduler");
+    DR_ASSERT_MSG(grain_size > 0, "attempt to run parallel for with zero grain size");
+    DR_ASSERT_MSG(function, "attempt to run parallel for with a NULL function");
+    dr_parallel_unchecked_for(scheduler, begin, end, grain_size, function, data);
+}
\ No newline at end of file
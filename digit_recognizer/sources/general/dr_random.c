@@ -0,0 +1,80 @@
+#include <general/dr_random.h>
+
+static inline uint64_t dr_random_details_rotate_left(const uint64_t value, const int shift) {
+    return (value << shift) | (value >> (64 - shift));
+}
+
+static inline uint64_t dr_random_details_splitmix64(uint64_t* state) {
+    uint64_t value = (*state += 0x9E3779B97F4A7C15ull);
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    return value ^ (value >> 31);
+}
+
+static inline void dr_random_details_swap(size_t* left, size_t* right) {
+    const size_t temp = *left;
+    *left  = *right;
+    *right = temp;
+}
+
+dr_random dr_random_create(const uint64_t seed) {
+    // splitmix64 spreads the seed, so the state is never all zeros
+    dr_random random;
+    uint64_t splitmix_state = seed;
+    for (size_t i = 0; i < 4; ++i) {
+        random.state[i] = dr_random_details_splitmix64(&splitmix_state);
+    }
+    return random;
+}
+
+uint64_t dr_random_next(dr_random* random) {
+    uint64_t* s = random->state;
+    const uint64_t result = dr_random_details_rotate_left(s[1] * 5, 7) * 9;
+    const uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = dr_random_details_rotate_left(s[3], 45);
+    return result;
+}
+
+size_t dr_random_below(dr_random* random, const size_t bound) {
+    // the values below threshold are rejected, so every remainder has the same number of values
+    const uint64_t threshold = (0 - (uint64_t)bound) % bound;
+    uint64_t value = 0;
+    do {
+        value = dr_random_next(random);
+    } while (value < threshold);
+    return (size_t)(value % bound);
+}
+
+void dr_random_shuffle(dr_random* random, size_t* indices, const size_t count) {
+    for (size_t i = count; i > 1; --i) {
+        dr_random_details_swap(indices + i - 1, indices + dr_random_below(random, i));
+    }
+}
+
+void dr_random_shuffle_blocks(dr_random* random, size_t* indices, const size_t count, const size_t block_size) {
+    if (block_size == 0) {
+        return;
+    }
+
+    const size_t full_blocks_count = count / block_size;
+    for (size_t i = full_blocks_count; i > 1; --i) {
+        const size_t j = dr_random_below(random, i);
+        if (j == i - 1) {
+            continue;
+        }
+        size_t* left  = indices + (i - 1) * block_size;
+        size_t* right = indices + j * block_size;
+        for (size_t k = 0; k < block_size; ++k) {
+            dr_random_details_swap(left + k, right + k);
+        }
+    }
+    for (size_t begin = 0; begin < count; begin += block_size) {
+        const size_t rest = count - begin;
+        dr_random_shuffle(random, indices + begin, rest < block_size ? rest : block_size);
+    }
+}
\ No newline at end of file
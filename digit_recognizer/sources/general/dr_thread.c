@@ -0,0 +1,232 @@
+#include <general/dr_thread.h>
+#include <general/dr_utils.h>
+
+#ifdef _WIN32
+  #include <Windows.h>
+  #include <limits.h>
+#else
+  #include <sched.h>
+  #include <unistd.h>
+#endif // _WIN32
+
+dr_thread_handle_t dr_thread_create(dr_thread_id_t* thread_id, dr_thread_function_t thread_function) {
+    return dr_thread_create_with_data(thread_id, thread_function, NULL);
+}
+
+dr_thread_handle_t dr_thread_create_with_data(
+    dr_thread_id_t* thread_id, dr_thread_function_t thread_function, void* data) {
+#ifdef _WIN32
+    return CreateThread(NULL, 0, thread_function, data, 0, thread_id);
+#else
+    return pthread_create(thread_id, NULL, thread_function, data);
+#endif // _WIN32
+}
+
+bool dr_check_thread_handle(const dr_thread_handle_t thread_handle) {
+#ifdef _WIN32
+    return thread_handle != NULL;
+#else
+    return thread_handle == 0;
+#endif // _WIN32
+}
+
+bool dr_thread_join(dr_thread_handle_t thread_handle, dr_thread_id_t thread_id) {
+#ifdef _WIN32
+    return WaitForSingleObject(thread_handle, INFINITE) != (uint32_t)0xFFFFFFFF;
+#else
+    return pthread_join(thread_id, NULL) == 0;
+#endif // _WIN32
+}
+
+bool dr_thread_close(dr_thread_handle_t thread_handle) {
+#ifdef _WIN32
+    return CloseHandle(thread_handle);
+#else
+    return true;
+#endif // _WIN32
+}
+
+void dr_thread_yield() {
+#ifdef _WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif // _WIN32
+}
+
+size_t dr_thread_hardware_concurrency() {
+#ifdef _WIN32
+    SYSTEM_INFO system_info;
+    GetSystemInfo(&system_info);
+    return system_info.dwNumberOfProcessors > 0 ? (size_t)system_info.dwNumberOfProcessors : 1;
+#else
+    const long processors_count = sysconf(_SC_NPROCESSORS_ONLN);
+    return processors_count > 0 ? (size_t)processors_count : 1;
+#endif // _WIN32
+}
+
+dr_mutex_t dr_mutex_create() {
+#ifdef _WIN32
+    return CreateMutex(NULL, FALSE, NULL);
+#else
+    const dr_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+    return mutex;
+#endif // _WIN32
+}
+
+bool dr_check_mutex(const dr_mutex_t mutex) {
+#ifdef _WIN32
+    return mutex != NULL;
+#else
+    return true;
+#endif // _WIN32
+}
+
+bool dr_mutex_lock(dr_mutex_t* mutex) {
+#ifdef _WIN32
+    return WaitForSingleObject(*mutex, INFINITE) == WAIT_OBJECT_0;
+#else
+    return pthread_mutex_lock(mutex) == 0;
+#endif // _WIN32
+}
+
+bool dr_mutex_unlock(dr_mutex_t* mutex) {
+#ifdef _WIN32
+    return ReleaseMutex(*mutex);
+#else
+    return pthread_mutex_unlock(mutex) == 0;
+#endif // _WIN32
+}
+
+bool dr_mutex_close(dr_mutex_t mutex) {
+#ifdef _WIN32
+    return CloseHandle(mutex);
+#else
+    return true;
+#endif // _WIN32
+}
+
+bool dr_barrier_create(dr_barrier_t* barrier, const size_t count) {
+#ifdef _WIN32
+    SYNCHRONIZATION_BARRIER* synchronization_barrier =
+        (SYNCHRONIZATION_BARRIER*)DR_MALLOC(sizeof(SYNCHRONIZATION_BARRIER));
+    if (!synchronization_barrier) {
+        return false;
+    }
+    if (!InitializeSynchronizationBarrier(synchronization_barrier, (LONG)count, -1)) {
+        DR_FREE(synchronization_barrier);
+        return false;
+    }
+    *barrier = synchronization_barrier;
+    return true;
+#else
+    barrier->count      = count;
+    barrier->waiting    = 0;
+    barrier->generation = 0;
+    if (pthread_mutex_init(&barrier->mutex, NULL) != 0) {
+        return false;
+    }
+    if (pthread_cond_init(&barrier->condition, NULL) != 0) {
+        pthread_mutex_destroy(&barrier->mutex);
+        return false;
+    }
+    return true;
+#endif // _WIN32
+}
+
+bool dr_barrier_wait(dr_barrier_t* barrier) {
+#ifdef _WIN32
+    EnterSynchronizationBarrier((SYNCHRONIZATION_BARRIER*)*barrier, 0);
+    return true;
+#else
+    if (pthread_mutex_lock(&barrier->mutex) != 0) {
+        return false;
+    }
+    const size_t generation = barrier->generation;
+    if (++barrier->waiting == barrier->count) {
+        barrier->waiting = 0;
+        ++barrier->generation;
+        pthread_cond_broadcast(&barrier->condition);
+    } else {
+        // the generation protects from spurious wakeups and from the threads that already reached the next round
+        while (generation == barrier->generation) {
+            pthread_cond_wait(&barrier->condition, &barrier->mutex);
+        }
+    }
+    return pthread_mutex_unlock(&barrier->mutex) == 0;
+#endif // _WIN32
+}
+
+bool dr_barrier_close(dr_barrier_t* barrier) {
+#ifdef _WIN32
+    const bool result = DeleteSynchronizationBarrier((SYNCHRONIZATION_BARRIER*)*barrier);
+    DR_FREE(*barrier);
+    *barrier = NULL;
+    return result;
+#else
+    const bool condition_destroyed = pthread_cond_destroy(&barrier->condition) == 0;
+    const bool mutex_destroyed     = pthread_mutex_destroy(&barrier->mutex) == 0;
+    return condition_destroyed && mutex_destroyed;
+#endif // _WIN32
+}
+
+bool dr_semaphore_create(dr_semaphore_t* semaphore, const size_t count) {
+#ifdef _WIN32
+    *semaphore = CreateSemaphore(NULL, (LONG)count, LONG_MAX, NULL);
+    return *semaphore != NULL;
+#else
+    semaphore->count = count;
+    if (pthread_mutex_init(&semaphore->mutex, NULL) != 0) {
+        return false;
+    }
+    if (pthread_cond_init(&semaphore->condition, NULL) != 0) {
+        pthread_mutex_destroy(&semaphore->mutex);
+        return false;
+    }
+    return true;
+#endif // _WIN32
+}
+
+bool dr_semaphore_wait(dr_semaphore_t* semaphore) {
+#ifdef _WIN32
+    return WaitForSingleObject(*semaphore, INFINITE) == WAIT_OBJECT_0;
+#else
+    if (pthread_mutex_lock(&semaphore->mutex) != 0) {
+        return false;
+    }
+    while (semaphore->count == 0) {
+        pthread_cond_wait(&semaphore->condition, &semaphore->mutex);
+    }
+    --semaphore->count;
+    return pthread_mutex_unlock(&semaphore->mutex) == 0;
+#endif // _WIN32
+}
+
+bool dr_semaphore_post(dr_semaphore_t* semaphore, const size_t count) {
+#ifdef _WIN32
+    return ReleaseSemaphore(*semaphore, (LONG)count, NULL);
+#else
+    if (pthread_mutex_lock(&semaphore->mutex) != 0) {
+        return false;
+    }
+    semaphore->count += count;
+    if (count == 1) {
+        pthread_cond_signal(&semaphore->condition);
+    } else {
+        pthread_cond_broadcast(&semaphore->condition);
+    }
+    return pthread_mutex_unlock(&semaphore->mutex) == 0;
+#endif // _WIN32
+}
+
+bool dr_semaphore_close(dr_semaphore_t* semaphore) {
+#ifdef _WIN32
+    const bool result = CloseHandle(*semaphore);
+    *semaphore = NULL;
+    return result;
+#else
+    const bool condition_destroyed = pthread_cond_destroy(&semaphore->condition) == 0;
+    const bool mutex_destroyed     = pthread_mutex_destroy(&semaphore->mutex) == 0;
+    return condition_destroyed && mutex_destroyed;
+#endif // _WIN32
+}
\ No newline at end of file
@@ -0,0 +1,251 @@
+#include <general/dr_thread_pool.h>
+#include <general/dr_utils.h>
+
+static void* volatile dr_thread_pool_details_default = NULL;
+
+// the mutex of the pool is locked
+static inline void dr_thread_pool_details_push(dr_thread_pool* pool, const dr_task task) {
+    if (pool->tasks_count == pool->tasks_capacity) {
+        const size_t new_capacity = pool->tasks_capacity * 2;
+        dr_task* new_tasks = (dr_task*)DR_MALLOC(sizeof(dr_task) * new_capacity);
+        DR_ASSERT_MSG(new_tasks, "alloc thread pool tasks error");
+        for (size_t i = 0; i < pool->tasks_count; ++i) {
+            new_tasks[i] = pool->tasks[(pool->tasks_begin + i) % pool->tasks_capacity];
+        }
+        DR_FREE(pool->tasks);
+        pool->tasks          = new_tasks;
+        pool->tasks_capacity = new_capacity;
+        pool->tasks_begin    = 0;
+    }
+    pool->tasks[(pool->tasks_begin + pool->tasks_count) % pool->tasks_capacity] = task;
+    ++pool->tasks_count;
+}
+
+// the mutex of the pool is locked
+static inline bool dr_thread_pool_details_pop(dr_thread_pool* pool, dr_task* task) {
+    if (pool->tasks_count == 0) {
+        return false;
+    }
+    *task = pool->tasks[pool->tasks_begin];
+    pool->tasks_begin = (pool->tasks_begin + 1) % pool->tasks_capacity;
+    --pool->tasks_count;
+    return true;
+}
+
+static inline void dr_thread_pool_details_run(const dr_task task) {
+    task.function(task.data);
+    if (task.future) {
+        dr_atomic_store_release(&task.future->done, true);
+    }
+}
+
+static dr_thread_function_result_t DR_WINAPI dr_thread_pool_details_worker_thread(void* data) {
+    dr_thread_pool* pool = (dr_thread_pool*)data;
+    // every queued task and every stop request posts the semaphore once, the waiting threads can take
+    // the tasks before the workers, so the queue may be empty after the wait
+    while (true) {
+        dr_semaphore_wait(&pool->semaphore);
+        dr_task task;
+        dr_mutex_lock(&pool->mutex);
+        const bool popped   = dr_thread_pool_details_pop(pool, &task);
+        const bool stopping = pool->stopping;
+        dr_mutex_unlock(&pool->mutex);
+        if (popped) {
+            dr_thread_pool_details_run(task);
+        } else if (stopping) {
+            break;
+        }
+    }
+    return 0;
+}
+
+dr_thread_pool* dr_thread_pool_create(const size_t threads_count) {
+    dr_thread_pool* pool = (dr_thread_pool*)DR_MALLOC(sizeof(dr_thread_pool));
+    DR_ASSERT_MSG(pool, "alloc thread pool error");
+    pool->threads_count  = threads_count;
+    pool->tasks_capacity = DR_THREAD_POOL_MIN_TASKS_CAPACITY;
+    pool->tasks_begin    = 0;
+    pool->tasks_count    = 0;
+    pool->stopping       = false;
+    pool->tasks = (dr_task*)DR_MALLOC(sizeof(dr_task) * pool->tasks_capacity);
+    DR_ASSERT_MSG(pool->tasks, "alloc thread pool tasks error");
+
+    pool->mutex = dr_mutex_create();
+    DR_ASSERT_MSG(dr_check_mutex(pool->mutex), "thread pool mutex create error");
+    const bool semaphore_created = dr_semaphore_create(&pool->semaphore, 0);
+    DR_ASSERT_MSG(semaphore_created, "thread pool semaphore create error");
+    (void)semaphore_created;
+
+    // one more element, so zero workers don't allocate zero bytes
+    pool->threads_ids = (dr_thread_id_t*)DR_MALLOC(sizeof(dr_thread_id_t) * (threads_count + 1));
+    DR_ASSERT_MSG(pool->threads_ids, "alloc thread pool threads ids error");
+    pool->threads_handles = (dr_thread_handle_t*)DR_MALLOC(sizeof(dr_thread_handle_t) * (threads_count + 1));
+    DR_ASSERT_MSG(pool->threads_handles, "alloc thread pool threads handles error");
+    for (size_t i = 0; i < threads_count; ++i) {
+        pool->threads_handles[i] = dr_thread_create_with_data(
+            pool->threads_ids + i, dr_thread_pool_details_worker_thread, pool);
+        DR_ASSERT_MSG(dr_check_thread_handle(pool->threads_handles[i]), "thread pool thread create error");
+    }
+
+    return pool;
+}
+
+void dr_thread_pool_free(dr_thread_pool* pool) {
+    if (!pool) {
+        return;
+    }
+
+    dr_mutex_lock(&pool->mutex);
+    pool->stopping = true;
+    dr_mutex_unlock(&pool->mutex);
+    dr_semaphore_post(&pool->semaphore, pool->threads_count);
+    for (size_t i = 0; i < pool->threads_count; ++i) {
+        const bool thread_join_result = dr_thread_join(pool->threads_handles[i], pool->threads_ids[i]);
+        DR_ASSERT_MSG(thread_join_result, "thread pool thread join error");
+        (void)thread_join_result;
+        dr_thread_close(pool->threads_handles[i]);
+    }
+    // the tasks left without workers
+    while (dr_thread_pool_run_pending_task(pool)) {
+    }
+
+    dr_semaphore_close(&pool->semaphore);
+    dr_mutex_close(pool->mutex);
+    DR_FREE(pool->threads_ids);
+    DR_FREE(pool->threads_handles);
+    DR_FREE(pool->tasks);
+    DR_FREE(pool);
+}
+
+dr_thread_pool* dr_thread_pool_get_default() {
+    dr_thread_pool* pool = (dr_thread_pool*)dr_atomic_load_pointer_acquire(&dr_thread_pool_details_default);
+    if (pool) {
+        return pool;
+    }
+
+    // the threads calling it at once may create several pools, only one of them is kept
+    dr_thread_pool* created_pool = dr_thread_pool_create(dr_thread_hardware_concurrency() - 1);
+    if (dr_atomic_compare_exchange_pointer(&dr_thread_pool_details_default, NULL, created_pool)) {
+        return created_pool;
+    }
+    dr_thread_pool_free(created_pool);
+    return (dr_thread_pool*)dr_atomic_load_pointer_acquire(&dr_thread_pool_details_default);
+}
+
+void dr_thread_pool_unchecked_submit(
+    dr_thread_pool* pool, dr_task_function function, void* data, dr_future* future) {
+    dr_task task;
+    task.function = function;
+    task.data     = data;
+    task.future   = future;
+    if (future) {
+        dr_future_init(future);
+    }
+
+    dr_mutex_lock(&pool->mutex);
+    dr_thread_pool_details_push(pool, task);
+    dr_mutex_unlock(&pool->mutex);
+    dr_semaphore_post(&pool->semaphore, 1);
+}
+
+void dr_thread_pool_submit(dr_thread_pool* pool, dr_task_function function, void* data, dr_future* future) {
+    DR_ASSERT_MSG(pool, "attempt to submit a task to a NULL thread pool");
+    DR_ASSERT_MSG(function, "attempt to submit a NULL task function to a thread pool");
+    DR_ASSERT_MSG(!pool->stopping, "attempt to submit a task to a stopping thread pool");
+    dr_thread_pool_unchecked_submit(pool, function, data, future);
+}
+
+bool dr_thread_pool_run_pending_task(dr_thread_pool* pool) {
+    dr_task task;
+    dr_mutex_lock(&pool->mutex);
+    const bool popped = dr_thread_pool_details_pop(pool, &task);
+    dr_mutex_unlock(&pool->mutex);
+    if (popped) {
+        dr_thread_pool_details_run(task);
+    }
+    return popped;
+}
+
+void dr_future_init(dr_future* future) {
+    dr_atomic_store_release(&future->done, false);
+}
+
+bool dr_future_ready(const dr_future* future) {
+    return dr_atomic_load_acquire(&future->done);
+}
+
+void dr_future_wait(dr_future* future, dr_thread_pool* pool) {
+    DR_ASSERT_MSG(future, "attempt to wait for a NULL future");
+    while (!dr_future_ready(future)) {
+        if (!pool || !dr_thread_pool_run_pending_task(pool)) {
+            dr_thread_yield();
+        }
+    }
+}
+
+typedef struct {
+    dr_parallel_for_function function;
+    void* data;
+    size_t begin;
+    size_t end;
+    size_t grain_size;
+    size_t chunks_count;
+    dr_atomic_size_t next_chunk;
+    dr_atomic_size_t helpers_count; // <- the submitted helpers that haven't finished
+} dr_thread_pool_details_parallel_for_context;
+
+static void dr_thread_pool_details_parallel_for_run(dr_thread_pool_details_parallel_for_context* context) {
+    size_t chunk = 0;
+    while ((chunk = dr_atomic_fetch_add(&context->next_chunk, 1)) < context->chunks_count) {
+        const size_t chunk_begin = context->begin + chunk * context->grain_size;
+        const size_t chunk_rest  = context->end - chunk_begin;
+        context->function(context->data, chunk_begin,
+            chunk_begin + (chunk_rest < context->grain_size ? chunk_rest : context->grain_size));
+    }
+}
+
+static void dr_thread_pool_details_parallel_for_helper(void* data) {
+    dr_thread_pool_details_parallel_for_context* context = (dr_thread_pool_details_parallel_for_context*)data;
+    dr_thread_pool_details_parallel_for_run(context);
+    dr_atomic_fetch_add(&context->helpers_count, (size_t)-1);
+}
+
+void dr_thread_pool_unchecked_parallel_for(dr_thread_pool* pool, const size_t begin, const size_t end,
+    const size_t grain_size, dr_parallel_for_function function, void* data) {
+    if (begin >= end) {
+        return;
+    }
+
+    dr_thread_pool_details_parallel_for_context context;
+    context.function     = function;
+    context.data         = data;
+    context.begin        = begin;
+    context.end          = end;
+    context.grain_size   = grain_size;
+    context.chunks_count = (end - begin + grain_size - 1) / grain_size;
+    context.next_chunk   = 0;
+
+    // the calling thread takes the chunks too, so one chunk needs no helpers
+    const size_t helpers_count =
+        context.chunks_count - 1 < pool->threads_count ? context.chunks_count - 1 : pool->threads_count;
+    context.helpers_count = helpers_count;
+    for (size_t i = 0; i < helpers_count; ++i) {
+        dr_thread_pool_unchecked_submit(pool, dr_thread_pool_details_parallel_for_helper, &context, NULL);
+    }
+    dr_thread_pool_details_parallel_for_run(&context);
+
+    // the context is on the stack, so even the helpers that found no chunks must finish
+    while (dr_atomic_load_acquire(&context.helpers_count) > 0) {
+        if (!dr_thread_pool_run_pending_task(pool)) {
+            dr_thread_yield();
+        }
+    }
+}
+
+void dr_thread_pool_parallel_for(dr_thread_pool* pool, const size_t begin, const size_t end,
+    const size_t grain_size, dr_parallel_for_function function, void* data) {
+    DR_ASSERT_MSG(pool, "attempt to run parallel for on a NULL thread pool");
+    DR_ASSERT_MSG(grain_size > 0, "attempt to run parallel for with zero grain size");
+    DR_ASSERT_MSG(function, "attempt to run parallel for with a NULL function");
+    dr_thread_pool_unchecked_parallel_for(pool, begin, end, grain_size, function, data);
+}
\ No newline at end of file
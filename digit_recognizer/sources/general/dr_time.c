@@ -0,0 +1,21 @@
+#include <general/dr_time.h>
+
+#ifdef _WIN32
+  #include <Windows.h>
+#else
+  #include <time.h>
+#endif // _WIN32
+
+double dr_time_seconds() {
+#ifdef _WIN32
+    LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (double)time.tv_sec + (double)time.tv_nsec * 1e-9;
+#endif // _WIN32
+}
\ No newline at end of file
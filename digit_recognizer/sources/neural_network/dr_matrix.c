@@ -1,6 +1,28 @@
 #include <neural_network/dr_matrix.h>
+#include <neural_network/dr_matrix_kernels.h>
+#include <general/dr_parallel.h>
 #include <math.h>
 
+#ifndef DR_MATRIX_GEMM_MC
+# define DR_MATRIX_GEMM_MC 128
+#endif
+
+#ifndef DR_MATRIX_GEMM_KC
+# define DR_MATRIX_GEMM_KC 256
+#endif
+
+#ifndef DR_MATRIX_GEMM_NC
+# define DR_MATRIX_GEMM_NC 2048
+#endif
+
+#define DR_MATRIX_GEMM_MR DR_MATRIX_KERNELS_GEMM_MR
+#define DR_MATRIX_GEMM_NR DR_MATRIX_KERNELS_GEMM_NR
+#define DR_MATRIX_GEMM_MIN_VOLUME (32 * 32 * 32)
+
+// every part of a parallel GEMM repacks the operand that isn't split, so the parts are kept large
+#define DR_MATRIX_GEMM_PARALLEL_MIN_VOLUME (64 * 64 * 64)
+#define DR_MATRIX_GEMM_PARALLEL_MIN_EXTENT 64
+
 bool dr_matrix_correct_sizes(const size_t width, const size_t height) {
     return (width > 0 && height > 0) || (width == 0 && height == 0);
 }
@@ -42,10 +64,7 @@ void dr_matrix_free(dr_matrix* matrix) {
 }
 
 void dr_matrix_unchecked_fill(dr_matrix matrix, const DR_FLOAT_TYPE value) {
-    const size_t matrix_size = dr_matrix_unchecked_size(matrix);
-    for (size_t i = 0; i < matrix_size; ++i) {
-        matrix.elements[i] = value;
-    }
+    dr_matrix_kernels_get()->fill(matrix.elements, value, dr_matrix_unchecked_size(matrix));
 }
 
 void dr_matrix_fill(dr_matrix matrix, const DR_FLOAT_TYPE value) {
@@ -174,10 +193,8 @@ size_t dr_matrix_size(const dr_matrix matrix) {
 }
 
 void dr_matrix_unchecked_multiplication_write(const dr_matrix left, const dr_matrix right, dr_matrix result) {
-    const size_t size = dr_matrix_unchecked_size(result);
-    for (size_t i = 0; i < size; ++i) {
-        result.elements[i] = left.elements[i] * right.elements[i];
-    }
+    dr_matrix_kernels_get()->multiplication(
+        left.elements, right.elements, result.elements, dr_matrix_unchecked_size(result));
 }
 
 void dr_matrix_multiplication_write(const dr_matrix left, const dr_matrix right, dr_matrix result) {
@@ -205,32 +222,315 @@ dr_matrix dr_matrix_multiplication_create(const dr_matrix left, const dr_matrix
     return dr_matrix_unchecked_multiplication_create(left, right);
 }
 
-void dr_matrix_unchecked_dot_write(const dr_matrix left, const dr_matrix right, dr_matrix result) {
+// C = alpha * A * B + beta * C for the operands where packing does not pay off,
+// element (i, k) of A is at A[i * A_row_stride + k * A_column_stride], the same goes for B
+static inline void dr_matrix_details_dot_write_naive(const size_t M, const size_t N, const size_t K,
+    const DR_FLOAT_TYPE alpha, const DR_FLOAT_TYPE* A, const size_t A_row_stride, const size_t A_column_stride,
+    const DR_FLOAT_TYPE* B, const size_t B_row_stride, const size_t B_column_stride,
+    const DR_FLOAT_TYPE beta, DR_FLOAT_TYPE* C) {
     // the method was taken from the article: https://habr.com/ru/articles/359272/
 
-    const size_t M = left.height;
-    const size_t N = right.width;
-    const size_t K = left.width;
-
-    DR_FLOAT_TYPE* A = left.elements;
-    DR_FLOAT_TYPE* B = right.elements;
-    DR_FLOAT_TYPE* C = result.elements;
-
     for (size_t i = 0; i < M; ++i) {
         DR_FLOAT_TYPE* c = C + i * N;
         for (size_t j = 0; j < N; ++j) {
-            c[j] = 0;
+            c[j] = beta == 0 ? 0 : beta * c[j];
         }
         for (size_t k = 0; k < K; ++k) {
-            const DR_FLOAT_TYPE* b = B + k * N;
-            const DR_FLOAT_TYPE a = A[i * K + k];
+            const DR_FLOAT_TYPE* b = B + k * B_row_stride;
+            const DR_FLOAT_TYPE a = alpha * A[i * A_row_stride + k * A_column_stride];
             for (size_t j = 0; j < N; ++j) {
-                c[j] += a * b[j];
+                c[j] += a * b[j * B_column_stride];
             }
         }
     }
 }
 
+static inline size_t dr_matrix_details_min(const size_t left, const size_t right) {
+    return left < right ? left : right;
+}
+
+static inline size_t dr_matrix_details_round_up(const size_t value, const size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+// Packs the mc x kc block of A (element (i, k) is at A[i * row_stride + k * column_stride]) into
+// panels of DR_MATRIX_GEMM_MR rows, each panel stored column by column. Missing rows are filled with zeros.
+static inline void dr_matrix_details_gemm_pack_A(const DR_FLOAT_TYPE* A, const size_t row_stride,
+    const size_t column_stride, const size_t mc, const size_t kc, DR_FLOAT_TYPE* packed) {
+    for (size_t ir = 0; ir < mc; ir += DR_MATRIX_GEMM_MR) {
+        const size_t mr = dr_matrix_details_min(DR_MATRIX_GEMM_MR, mc - ir);
+        for (size_t p = 0; p < kc; ++p) {
+            size_t i = 0;
+            for (; i < mr; ++i) {
+                packed[i] = A[(ir + i) * row_stride + p * column_stride];
+            }
+            for (; i < DR_MATRIX_GEMM_MR; ++i) {
+                packed[i] = 0;
+            }
+            packed += DR_MATRIX_GEMM_MR;
+        }
+    }
+}
+
+// Packs the kc x nc block of B (element (k, j) is at B[k * row_stride + j * column_stride]) into
+// panels of DR_MATRIX_GEMM_NR columns, each panel stored row by row. Missing columns are filled with zeros.
+static inline void dr_matrix_details_gemm_pack_B(const DR_FLOAT_TYPE* B, const size_t row_stride,
+    const size_t column_stride, const size_t kc, const size_t nc, DR_FLOAT_TYPE* packed) {
+    for (size_t jr = 0; jr < nc; jr += DR_MATRIX_GEMM_NR) {
+        const size_t nr = dr_matrix_details_min(DR_MATRIX_GEMM_NR, nc - jr);
+        for (size_t p = 0; p < kc; ++p) {
+            size_t j = 0;
+            for (; j < nr; ++j) {
+                packed[j] = B[p * row_stride + (jr + j) * column_stride];
+            }
+            for (; j < DR_MATRIX_GEMM_NR; ++j) {
+                packed[j] = 0;
+            }
+            packed += DR_MATRIX_GEMM_NR;
+        }
+    }
+}
+
+// Computes the DR_MATRIX_GEMM_MR x DR_MATRIX_GEMM_NR register tile of packed A and packed B
+// with the kernel of the selected instruction set and writes its mr x nr part into C as C = alpha * tile + beta * C.
+static inline void dr_matrix_details_gemm_micro_kernel(const dr_matrix_kernel_gemm_tile gemm_tile, const size_t kc,
+    const DR_FLOAT_TYPE* packed_A, const DR_FLOAT_TYPE* packed_B, DR_FLOAT_TYPE* C, const size_t ldc,
+    const size_t mr, const size_t nr, const DR_FLOAT_TYPE alpha, const DR_FLOAT_TYPE beta) {
+    DR_FLOAT_TYPE tile[DR_MATRIX_GEMM_MR][DR_MATRIX_GEMM_NR];
+    gemm_tile(kc, packed_A, packed_B, &tile[0][0]);
+
+    for (size_t i = 0; i < mr; ++i) {
+        DR_FLOAT_TYPE* c = C + i * ldc;
+        if (beta == 0) {
+            for (size_t j = 0; j < nr; ++j) {
+                c[j] = alpha * tile[i][j];
+            }
+        } else {
+            for (size_t j = 0; j < nr; ++j) {
+                c[j] = alpha * tile[i][j] + beta * c[j];
+            }
+        }
+    }
+}
+
+// Blocked GEMM (C = alpha * A * B + beta * C) in the spirit of the Goto/BLIS algorithm:
+// the kc x nc block of B is packed to stay in L3 cache, the mc x kc block of A is packed to stay in L2 cache
+// and the micro-kernel keeps an mr x nr tile of C in registers while streaming the packed panels from L1.
+static void dr_matrix_details_gemm(const size_t M, const size_t N, const size_t K,
+    const DR_FLOAT_TYPE alpha, const DR_FLOAT_TYPE* A, const size_t A_row_stride, const size_t A_column_stride,
+    const DR_FLOAT_TYPE* B, const size_t B_row_stride, const size_t B_column_stride,
+    const DR_FLOAT_TYPE beta, DR_FLOAT_TYPE* C, const size_t ldc) {
+    const size_t max_mc = dr_matrix_details_min(DR_MATRIX_GEMM_MC, dr_matrix_details_round_up(M, DR_MATRIX_GEMM_MR));
+    const size_t max_nc = dr_matrix_details_min(DR_MATRIX_GEMM_NC, dr_matrix_details_round_up(N, DR_MATRIX_GEMM_NR));
+    const size_t max_kc = dr_matrix_details_min(DR_MATRIX_GEMM_KC, K);
+
+    DR_FLOAT_TYPE* packed_A = (DR_FLOAT_TYPE*)DR_MALLOC(sizeof(DR_FLOAT_TYPE) * max_mc * max_kc);
+    DR_ASSERT_MSG(packed_A, "alloc packed A panel error when dot the matrices");
+    DR_FLOAT_TYPE* packed_B = (DR_FLOAT_TYPE*)DR_MALLOC(sizeof(DR_FLOAT_TYPE) * max_kc * max_nc);
+    DR_ASSERT_MSG(packed_B, "alloc packed B panel error when dot the matrices");
+    const dr_matrix_kernel_gemm_tile gemm_tile = dr_matrix_kernels_get()->gemm_tile;
+
+    for (size_t jc = 0; jc < N; jc += DR_MATRIX_GEMM_NC) {
+        const size_t nc = dr_matrix_details_min(DR_MATRIX_GEMM_NC, N - jc);
+        for (size_t pc = 0; pc < K; pc += DR_MATRIX_GEMM_KC) {
+            const size_t kc = dr_matrix_details_min(DR_MATRIX_GEMM_KC, K - pc);
+            dr_matrix_details_gemm_pack_B(B + pc * B_row_stride + jc * B_column_stride,
+                B_row_stride, B_column_stride, kc, nc, packed_B);
+            for (size_t ic = 0; ic < M; ic += DR_MATRIX_GEMM_MC) {
+                const size_t mc = dr_matrix_details_min(DR_MATRIX_GEMM_MC, M - ic);
+                dr_matrix_details_gemm_pack_A(A + ic * A_row_stride + pc * A_column_stride,
+                    A_row_stride, A_column_stride, mc, kc, packed_A);
+                for (size_t jr = 0; jr < nc; jr += DR_MATRIX_GEMM_NR) {
+                    const size_t nr = dr_matrix_details_min(DR_MATRIX_GEMM_NR, nc - jr);
+                    for (size_t ir = 0; ir < mc; ir += DR_MATRIX_GEMM_MR) {
+                        const size_t mr = dr_matrix_details_min(DR_MATRIX_GEMM_MR, mc - ir);
+                        dr_matrix_details_gemm_micro_kernel(gemm_tile, kc, packed_A + ir * kc, packed_B + jr * kc,
+                            C + (ic + ir) * ldc + jc + jr, ldc, mr, nr, alpha, pc == 0 ? beta : 1);
+                    }
+                }
+            }
+        }
+    }
+
+    DR_FREE(packed_A);
+    DR_FREE(packed_B);
+}
+
+typedef struct {
+    size_t M;
+    size_t N;
+    size_t K;
+    DR_FLOAT_TYPE alpha;
+    const DR_FLOAT_TYPE* A;
+    size_t A_row_stride;
+    size_t A_column_stride;
+    const DR_FLOAT_TYPE* B;
+    size_t B_row_stride;
+    size_t B_column_stride;
+    DR_FLOAT_TYPE beta;
+    DR_FLOAT_TYPE* C;
+    size_t ldc;
+    bool split_rows;
+} dr_matrix_details_gemm_parallel_data;
+
+// the range is in the register tiles: rows of DR_MATRIX_GEMM_MR or columns of DR_MATRIX_GEMM_NR
+static void dr_matrix_details_gemm_parallel_run(void* data, const size_t begin, const size_t end) {
+    const dr_matrix_details_gemm_parallel_data* gemm = (const dr_matrix_details_gemm_parallel_data*)data;
+    if (gemm->split_rows) {
+        const size_t row_begin = begin * DR_MATRIX_GEMM_MR;
+        const size_t row_end   = dr_matrix_details_min(end * DR_MATRIX_GEMM_MR, gemm->M);
+        dr_matrix_details_gemm(row_end - row_begin, gemm->N, gemm->K, gemm->alpha,
+            gemm->A + row_begin * gemm->A_row_stride, gemm->A_row_stride, gemm->A_column_stride,
+            gemm->B, gemm->B_row_stride, gemm->B_column_stride, gemm->beta, gemm->C + row_begin * gemm->ldc, gemm->ldc);
+    } else {
+        const size_t column_begin = begin * DR_MATRIX_GEMM_NR;
+        const size_t column_end   = dr_matrix_details_min(end * DR_MATRIX_GEMM_NR, gemm->N);
+        dr_matrix_details_gemm(gemm->M, column_end - column_begin, gemm->K, gemm->alpha,
+            gemm->A, gemm->A_row_stride, gemm->A_column_stride,
+            gemm->B + column_begin * gemm->B_column_stride, gemm->B_row_stride, gemm->B_column_stride,
+            gemm->beta, gemm->C + column_begin, gemm->ldc);
+    }
+}
+
+// The larger of M and N is split between the workers of the default scheduler. A GEMM called from a parallel
+// task (a training step, a part of a batch) forks its parts into the same scheduler, the idle workers steal them.
+static void dr_matrix_details_gemm_parallel(const size_t M, const size_t N, const size_t K,
+    const DR_FLOAT_TYPE alpha, const DR_FLOAT_TYPE* A, const size_t A_row_stride, const size_t A_column_stride,
+    const DR_FLOAT_TYPE* B, const size_t B_row_stride, const size_t B_column_stride,
+    const DR_FLOAT_TYPE beta, DR_FLOAT_TYPE* C, const size_t ldc) {
+    dr_matrix_details_gemm_parallel_data gemm;
+    gemm.M               = M;
+    gemm.N               = N;
+    gemm.K               = K;
+    gemm.alpha           = alpha;
+    gemm.A               = A;
+    gemm.A_row_stride    = A_row_stride;
+    gemm.A_column_stride = A_column_stride;
+    gemm.B               = B;
+    gemm.B_row_stride    = B_row_stride;
+    gemm.B_column_stride = B_column_stride;
+    gemm.beta            = beta;
+    gemm.C               = C;
+    gemm.ldc             = ldc;
+    gemm.split_rows      = M >= N;
+
+    const size_t tile_extent  = gemm.split_rows ? DR_MATRIX_GEMM_MR : DR_MATRIX_GEMM_NR;
+    const size_t split_extent = gemm.split_rows ? M : N;
+    const size_t tile_volume  = tile_extent * (gemm.split_rows ? N : M) * K;
+    const size_t tiles_count  = (split_extent + tile_extent - 1) / tile_extent;
+    const size_t volume_grain = (DR_MATRIX_GEMM_PARALLEL_MIN_VOLUME + tile_volume - 1) / tile_volume;
+    const size_t extent_grain = (DR_MATRIX_GEMM_PARALLEL_MIN_EXTENT + tile_extent - 1) / tile_extent;
+    const size_t grain_size   = volume_grain > extent_grain ? volume_grain : extent_grain;
+
+    dr_parallel_scheduler* scheduler = dr_parallel_scheduler_get_default();
+    if (scheduler->workers_count == 0 || tiles_count <= grain_size) {
+        dr_matrix_details_gemm(M, N, K, alpha, A, A_row_stride, A_column_stride,
+            B, B_row_stride, B_column_stride, beta, C, ldc);
+        return;
+    }
+    dr_parallel_unchecked_for(scheduler, 0, tiles_count, grain_size, dr_matrix_details_gemm_parallel_run, &gemm);
+}
+
+// y = alpha * A^T * x + beta * y without transposing A: y accumulates the rows of A scaled by x
+static inline void dr_matrix_details_gemv_transposed(const size_t M, const size_t K, const DR_FLOAT_TYPE alpha,
+    const DR_FLOAT_TYPE* A, const DR_FLOAT_TYPE* x, const DR_FLOAT_TYPE beta, DR_FLOAT_TYPE* y) {
+    const dr_matrix_kernels* kernels = dr_matrix_kernels_get();
+    if (beta == 0) {
+        kernels->fill(y, 0, M);
+    } else if (beta != 1) {
+        kernels->scale(y, beta, y, M);
+    }
+    for (size_t k = 0; k < K; ++k) {
+        const DR_FLOAT_TYPE coefficient = alpha * x[k];
+        if (coefficient != 0) {
+            kernels->axpy(coefficient, A + k * M, y, M);
+        }
+    }
+}
+
+void dr_matrix_unchecked_dot_write_ex(const dr_matrix left, const bool left_transposed,
+    const dr_matrix right, const bool right_transposed,
+    const DR_FLOAT_TYPE alpha, const DR_FLOAT_TYPE beta, dr_matrix result) {
+    const size_t M = left_transposed ? left.width : left.height;
+    const size_t K = left_transposed ? left.height : left.width;
+    const size_t N = right_transposed ? right.height : right.width;
+
+    // op(A)(i, k) = A[i * A_row_stride + k * A_column_stride], the same goes for op(B)
+    const size_t A_row_stride    = left_transposed ? 1 : left.width;
+    const size_t A_column_stride = left_transposed ? left.width : 1;
+    const size_t B_row_stride    = right_transposed ? 1 : right.width;
+    const size_t B_column_stride = right_transposed ? right.width : 1;
+
+    // a single column of op(B) is contiguous whether B is transposed or not
+    if (N == 1) {
+        if (left_transposed) {
+            dr_matrix_details_gemv_transposed(M, K, alpha, left.elements, right.elements, beta, result.elements);
+        } else if (alpha == 1 && beta == 0) {
+            dr_matrix_unchecked_gemv_write(left, right, result);
+        } else {
+            const dr_matrix_kernel_dot dot = dr_matrix_kernels_get()->dot;
+            for (size_t row = 0; row < M; ++row) {
+                const DR_FLOAT_TYPE value = alpha * dot(left.elements + row * K, right.elements, K);
+                result.elements[row] = beta == 0 ? value : value + beta * result.elements[row];
+            }
+        }
+        return;
+    }
+
+    // a single column of op(A) and a single row of op(B) are contiguous too: a rank-1 update row by row
+    if (K == 1) {
+        const dr_matrix_kernels* kernels = dr_matrix_kernels_get();
+        for (size_t row = 0; row < M; ++row) {
+            DR_FLOAT_TYPE* c = result.elements + row * N;
+            if (beta == 0) {
+                kernels->fill(c, 0, N);
+            } else if (beta != 1) {
+                kernels->scale(c, beta, c, N);
+            }
+            kernels->axpy(alpha * left.elements[row], right.elements, c, N);
+        }
+        return;
+    }
+
+    // packing does not pay off for tiny products and for the narrow ones
+    if (N < DR_MATRIX_GEMM_NR || M * N * K <= DR_MATRIX_GEMM_MIN_VOLUME) {
+        dr_matrix_details_dot_write_naive(M, N, K, alpha, left.elements, A_row_stride, A_column_stride,
+            right.elements, B_row_stride, B_column_stride, beta, result.elements);
+        return;
+    }
+
+    dr_matrix_details_gemm_parallel(M, N, K, alpha, left.elements, A_row_stride, A_column_stride,
+        right.elements, B_row_stride, B_column_stride, beta, result.elements, N);
+}
+
+void dr_matrix_dot_write_ex(const dr_matrix left, const bool left_transposed,
+    const dr_matrix right, const bool right_transposed,
+    const DR_FLOAT_TYPE alpha, const DR_FLOAT_TYPE beta, dr_matrix result) {
+    const size_t M = left_transposed ? left.width : left.height;
+    const size_t K = left_transposed ? left.height : left.width;
+    const size_t right_K = right_transposed ? right.width : right.height;
+    const size_t N = right_transposed ? right.height : right.width;
+    // the sizes are only used by the asserts, which NDEBUG compiles out
+    (void)M;
+    (void)K;
+    (void)right_K;
+    (void)N;
+    DR_ASSERT_MSG(result.elements,
+        "attempt to write the result of matrix dot into a matrix with NULL elements");
+    DR_ASSERT_MSG(result.width == N && result.height == M,
+        "it is impossible to write the result of matrix dot: "
+        "the width of the resulting matrix should be the width of op(right), the height - the height of op(left)");
+    DR_ASSERT_MSG(K == right_K, "when multiplying the matrix, the number of columns of op(left) "
+        "should be equal to the number of rows of op(right)");
+    dr_matrix_assert_compat_elements_and_sizes(left);
+    dr_matrix_assert_compat_elements_and_sizes(right);
+    dr_matrix_unchecked_dot_write_ex(left, left_transposed, right, right_transposed, alpha, beta, result);
+}
+
+void dr_matrix_unchecked_dot_write(const dr_matrix left, const dr_matrix right, dr_matrix result) {
+    dr_matrix_unchecked_dot_write_ex(left, false, right, false, 1, 0, result);
+}
+
 void dr_matrix_dot_write(const dr_matrix left, const dr_matrix right, dr_matrix result) {
     DR_ASSERT_MSG(result.elements,
         "attempt to write the result of matrix dot into a matrix with NULL elements");
@@ -258,13 +558,46 @@ dr_matrix dr_matrix_dot_create(const dr_matrix left, const dr_matrix right) {
     return dr_matrix_unchecked_dot_create(left, right);
 }
 
-void dr_matrix_unchecked_scale_write(const dr_matrix matrix, const DR_FLOAT_TYPE value, dr_matrix result) {
-    const size_t size = dr_matrix_unchecked_size(matrix);
-    for (size_t i = 0; i < size; ++i) {
-        result.elements[i] = matrix.elements[i] * value;
+void dr_matrix_unchecked_gemv_write(const dr_matrix matrix, const dr_matrix vector, dr_matrix result) {
+    const dr_matrix_kernel_dot dot = dr_matrix_kernels_get()->dot;
+    for (size_t row = 0; row < matrix.height; ++row) {
+        result.elements[row] = dot(matrix.elements + row * matrix.width, vector.elements, matrix.width);
     }
 }
 
+void dr_matrix_gemv_write(const dr_matrix matrix, const dr_matrix vector, dr_matrix result) {
+    DR_ASSERT_MSG(result.elements,
+        "attempt to write the result of matrix by vector multiplication into a matrix with NULL elements");
+    DR_ASSERT_MSG(vector.width == 1, "attempt to multiply a matrix by a vector with a width other than 1");
+    DR_ASSERT_MSG(matrix.width == vector.height,
+        "when multiplying a matrix by a vector, the width of the matrix must be equal to the height of the vector");
+    DR_ASSERT_MSG(result.width == 1 && result.height == matrix.height,
+        "it is impossible to write the result of matrix by vector multiplication: "
+        "the width of the resulting matrix should be 1 and the height should be equal to matrix.height");
+    dr_matrix_assert_compat_elements_and_sizes(matrix);
+    dr_matrix_assert_compat_elements_and_sizes(vector);
+    dr_matrix_unchecked_gemv_write(matrix, vector, result);
+}
+
+dr_matrix dr_matrix_unchecked_gemv_create(const dr_matrix matrix, const dr_matrix vector) {
+    dr_matrix result = dr_matrix_alloc(1, matrix.height);
+    dr_matrix_unchecked_gemv_write(matrix, vector, result);
+    return result;
+}
+
+dr_matrix dr_matrix_gemv_create(const dr_matrix matrix, const dr_matrix vector) {
+    DR_ASSERT_MSG(vector.width == 1, "attempt to multiply a matrix by a vector with a width other than 1");
+    DR_ASSERT_MSG(matrix.width == vector.height,
+        "when multiplying a matrix by a vector, the width of the matrix must be equal to the height of the vector");
+    dr_matrix_assert_compat_elements_and_sizes(matrix);
+    dr_matrix_assert_compat_elements_and_sizes(vector);
+    return dr_matrix_unchecked_gemv_create(matrix, vector);
+}
+
+void dr_matrix_unchecked_scale_write(const dr_matrix matrix, const DR_FLOAT_TYPE value, dr_matrix result) {
+    dr_matrix_kernels_get()->scale(matrix.elements, value, result.elements, dr_matrix_unchecked_size(matrix));
+}
+
 void dr_matrix_scale_write(const dr_matrix matrix, const DR_FLOAT_TYPE value, dr_matrix result) {
     DR_ASSERT_MSG(result.width == matrix.width && result.height == matrix.height,
         "an attempt to write the result of matrix scale to a matrix with a different size");
@@ -284,10 +617,8 @@ dr_matrix dr_matrix_scale_create(const dr_matrix matrix, const DR_FLOAT_TYPE val
 }
 
 void dr_matrix_unchecked_subtraction_write(const dr_matrix left, const dr_matrix right, dr_matrix result) {
-    const size_t size = dr_matrix_unchecked_size(result);
-    for (size_t i = 0; i < size; ++i) {
-        result.elements[i] = left.elements[i] - right.elements[i];
-    }
+    dr_matrix_kernels_get()->subtraction(
+        left.elements, right.elements, result.elements, dr_matrix_unchecked_size(result));
 }
 
 void dr_matrix_subtraction_write(const dr_matrix left, const dr_matrix right, dr_matrix result) {
@@ -317,10 +648,8 @@ dr_matrix dr_matrix_subtraction_create(const dr_matrix left, const dr_matrix rig
 }
 
 void dr_matrix_unchecked_addition_write(const dr_matrix left, const dr_matrix right, dr_matrix result) {
-    const size_t size = dr_matrix_unchecked_size(result);
-    for (size_t i = 0; i < size; ++i) {
-        result.elements[i] = left.elements[i] + right.elements[i];
-    }
+    dr_matrix_kernels_get()->addition(
+        left.elements, right.elements, result.elements, dr_matrix_unchecked_size(result));
 }
 
 void dr_matrix_addition_write(const dr_matrix left, const dr_matrix right, dr_matrix result) {
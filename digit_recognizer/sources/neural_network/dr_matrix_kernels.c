@@ -0,0 +1,684 @@
+#include <neural_network/dr_matrix_kernels.h>
+#include <general/dr_thread.h>
+#include <math.h>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+  #define DR_MATRIX_KERNELS_X86
+  #define DR_MATRIX_KERNELS_TARGET(isa) __attribute__((target(isa)))
+  #include <immintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  #define DR_MATRIX_KERNELS_X86
+  #define DR_MATRIX_KERNELS_TARGET(isa)
+  #include <intrin.h>
+  #include <immintrin.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////// SCALAR
+
+static void dr_matrix_kernels_scalar_fill(DR_FLOAT_TYPE* result, const DR_FLOAT_TYPE value, const size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        result[i] = value;
+    }
+}
+
+static void dr_matrix_kernels_scalar_multiplication(
+    const DR_FLOAT_TYPE* left, const DR_FLOAT_TYPE* right, DR_FLOAT_TYPE* result, const size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        result[i] = left[i] * right[i];
+    }
+}
+
+static void dr_matrix_kernels_scalar_addition(
+    const DR_FLOAT_TYPE* left, const DR_FLOAT_TYPE* right, DR_FLOAT_TYPE* result, const size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        result[i] = left[i] + right[i];
+    }
+}
+
+static void dr_matrix_kernels_scalar_subtraction(
+    const DR_FLOAT_TYPE* left, const DR_FLOAT_TYPE* right, DR_FLOAT_TYPE* result, const size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        result[i] = left[i] - right[i];
+    }
+}
+
+static void dr_matrix_kernels_scalar_scale(
+    const DR_FLOAT_TYPE* array, const DR_FLOAT_TYPE value, DR_FLOAT_TYPE* result, const size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        result[i] = array[i] * value;
+    }
+}
+
+static DR_FLOAT_TYPE dr_matrix_kernels_scalar_dot(
+    const DR_FLOAT_TYPE* left, const DR_FLOAT_TYPE* right, const size_t size) {
+    // independent accumulators hide the latency of the additions
+    DR_FLOAT_TYPE sum_0 = 0;
+    DR_FLOAT_TYPE sum_1 = 0;
+    DR_FLOAT_TYPE sum_2 = 0;
+    DR_FLOAT_TYPE sum_3 = 0;
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        sum_0 += left[i] * right[i];
+        sum_1 += left[i + 1] * right[i + 1];
+        sum_2 += left[i + 2] * right[i + 2];
+        sum_3 += left[i + 3] * right[i + 3];
+    }
+    for (; i < size; ++i) {
+        sum_0 += left[i] * right[i];
+    }
+    return (sum_0 + sum_1) + (sum_2 + sum_3);
+}
+
+static void dr_matrix_kernels_scalar_axpy(
+    const DR_FLOAT_TYPE alpha, const DR_FLOAT_TYPE* array, DR_FLOAT_TYPE* result, const size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        result[i] += alpha * array[i];
+    }
+}
+
+static void dr_matrix_kernels_scalar_gemm_tile(
+    const size_t kc, const DR_FLOAT_TYPE* packed_A, const DR_FLOAT_TYPE* packed_B, DR_FLOAT_TYPE* tile) {
+    for (size_t i = 0; i < DR_MATRIX_KERNELS_GEMM_MR * DR_MATRIX_KERNELS_GEMM_NR; ++i) {
+        tile[i] = 0;
+    }
+    for (size_t p = 0; p < kc; ++p) {
+        for (size_t i = 0; i < DR_MATRIX_KERNELS_GEMM_MR; ++i) {
+            const DR_FLOAT_TYPE a = packed_A[i];
+            for (size_t j = 0; j < DR_MATRIX_KERNELS_GEMM_NR; ++j) {
+                tile[i * DR_MATRIX_KERNELS_GEMM_NR + j] += a * packed_B[j];
+            }
+        }
+        packed_A += DR_MATRIX_KERNELS_GEMM_MR;
+        packed_B += DR_MATRIX_KERNELS_GEMM_NR;
+    }
+}
+
+static void dr_matrix_kernels_scalar_bytes_to_floats(
+    const unsigned char* bytes, const DR_FLOAT_TYPE scale, DR_FLOAT_TYPE* result, const size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        result[i] = bytes[i] * scale;
+    }
+}
+
+// the activation functions element by element, used by the scalar kernels and by the tails of the vector kernels
+static inline DR_FLOAT_TYPE dr_matrix_kernels_sigmoid(const DR_FLOAT_TYPE value) {
+    return 1 / (1 + expf(-value));
+}
+
+static inline DR_FLOAT_TYPE dr_matrix_kernels_sigmoid_derivative(const DR_FLOAT_TYPE value) {
+    return value * (1 - value);
+}
+
+static inline DR_FLOAT_TYPE dr_matrix_kernels_tanh(const DR_FLOAT_TYPE value) {
+    return tanhf(value);
+}
+
+static inline DR_FLOAT_TYPE dr_matrix_kernels_tanh_derivative(const DR_FLOAT_TYPE value) {
+    return 1 - value * value;
+}
+
+static inline DR_FLOAT_TYPE dr_matrix_kernels_relu(const DR_FLOAT_TYPE value) {
+    return value < 0 ? 0 : value;
+}
+
+static inline DR_FLOAT_TYPE dr_matrix_kernels_relu_derivative(const DR_FLOAT_TYPE value) {
+    return value > 0;
+}
+
+#define DR_MATRIX_KERNELS_DEFINE_SCALAR_UNARY(name)                                                             \
+    static void dr_matrix_kernels_scalar_##name(                                                                \
+        const DR_FLOAT_TYPE* array, DR_FLOAT_TYPE* result, const size_t size) {                                 \
+        for (size_t i = 0; i < size; ++i) {                                                                     \
+            result[i] = dr_matrix_kernels_##name(array[i]);                                                     \
+        }                                                                                                       \
+    }
+
+DR_MATRIX_KERNELS_DEFINE_SCALAR_UNARY(sigmoid)
+DR_MATRIX_KERNELS_DEFINE_SCALAR_UNARY(sigmoid_derivative)
+DR_MATRIX_KERNELS_DEFINE_SCALAR_UNARY(tanh)
+DR_MATRIX_KERNELS_DEFINE_SCALAR_UNARY(tanh_derivative)
+DR_MATRIX_KERNELS_DEFINE_SCALAR_UNARY(relu)
+DR_MATRIX_KERNELS_DEFINE_SCALAR_UNARY(relu_derivative)
+
+static const dr_matrix_kernels dr_matrix_kernels_scalar = {
+    dr_matrix_kernels_isa_scalar,
+    &dr_matrix_kernels_scalar_fill,
+    &dr_matrix_kernels_scalar_multiplication,
+    &dr_matrix_kernels_scalar_addition,
+    &dr_matrix_kernels_scalar_subtraction,
+    &dr_matrix_kernels_scalar_scale,
+    &dr_matrix_kernels_scalar_dot,
+    &dr_matrix_kernels_scalar_axpy,
+    &dr_matrix_kernels_scalar_gemm_tile,
+    &dr_matrix_kernels_scalar_bytes_to_floats,
+    &dr_matrix_kernels_scalar_sigmoid,
+    &dr_matrix_kernels_scalar_sigmoid_derivative,
+    &dr_matrix_kernels_scalar_tanh,
+    &dr_matrix_kernels_scalar_tanh_derivative,
+    &dr_matrix_kernels_scalar_relu,
+    &dr_matrix_kernels_scalar_relu_derivative
+};
+
+#ifdef DR_MATRIX_KERNELS_X86
+
+// the vector kernels below are written for DR_FLOAT_TYPE being float
+typedef char dr_matrix_kernels_float_type_check[sizeof(DR_FLOAT_TYPE) == sizeof(float) ? 1 : -1];
+// and the GEMM tiles below keep a row of the tile in two SSE2 or in one AVX2 register
+typedef char dr_matrix_kernels_gemm_tile_check[
+    DR_MATRIX_KERNELS_GEMM_MR == 4 && DR_MATRIX_KERNELS_GEMM_NR == 8 ? 1 : -1];
+
+// exp(x) = 2^n * exp(r) with n = round(x * log2(e)) and r = x - n * ln(2) in [-ln(2) / 2, ln(2) / 2],
+// ln(2) is split in two parts so n * ln(2) loses no bits, exp(r) is the polynomial of Cephes expf
+// (relative error below 2e-7). x is clamped to [-86.6, 87]: n stays in [-125, 126] and exp(r) >= 1 / sqrt(2),
+// so exp(x) is a normal float, and 1 / (1 + exp(87)) ~ 1.6e-38 is still above FLT_MIN ~ 1.2e-38
+// (denormals are many times slower). min and max return their second operand when either one is NaN,
+// so the clamp and relu take the value second and NaN passes through them like through the scalar functions
+#define DR_MATRIX_KERNELS_EXP_MIN      -86.6f
+#define DR_MATRIX_KERNELS_EXP_MAX       87.0f
+#define DR_MATRIX_KERNELS_EXP_LOG2E     1.44269504088896341f
+#define DR_MATRIX_KERNELS_EXP_LN2_HIGH  0.693359375f
+#define DR_MATRIX_KERNELS_EXP_LN2_LOW  -2.12194440e-4f
+#define DR_MATRIX_KERNELS_EXP_P0        1.9875691500e-4f
+#define DR_MATRIX_KERNELS_EXP_P1        1.3981999507e-3f
+#define DR_MATRIX_KERNELS_EXP_P2        8.3334519073e-3f
+#define DR_MATRIX_KERNELS_EXP_P3        4.1665795894e-2f
+#define DR_MATRIX_KERNELS_EXP_P4        1.6666665459e-1f
+#define DR_MATRIX_KERNELS_EXP_P5        5.0000001201e-1f
+
+// defines the element-wise kernel for an instruction set: the vector loop followed by the scalar tail
+#define DR_MATRIX_KERNELS_DEFINE_BINARY(isa, isa_target, name, vector_type, width, load, store, op, scalar_op) \
+    DR_MATRIX_KERNELS_TARGET(isa_target) static void dr_matrix_kernels_##isa##_##name(                          \
+        const DR_FLOAT_TYPE* left, const DR_FLOAT_TYPE* right, DR_FLOAT_TYPE* result, const size_t size) {      \
+        size_t i = 0;                                                                                           \
+        for (; i + width <= size; i += width) {                                                                 \
+            const vector_type l = load(left + i);                                                               \
+            const vector_type r = load(right + i);                                                              \
+            store(result + i, op(l, r));                                                                        \
+        }                                                                                                       \
+        for (; i < size; ++i) {                                                                                 \
+            result[i] = left[i] scalar_op right[i];                                                             \
+        }                                                                                                       \
+    }
+
+// defines the kernel of an activation function for an instruction set: the vector loop followed by the scalar tail
+#define DR_MATRIX_KERNELS_DEFINE_UNARY(isa, isa_target, name, vector_type, width, load, store)                  \
+    DR_MATRIX_KERNELS_TARGET(isa_target) static void dr_matrix_kernels_##isa##_##name(                          \
+        const DR_FLOAT_TYPE* array, DR_FLOAT_TYPE* result, const size_t size) {                                 \
+        size_t i = 0;                                                                                           \
+        for (; i + width <= size; i += width) {                                                                 \
+            store(result + i, dr_matrix_kernels_##isa##_##name##_vector(load(array + i)));                      \
+        }                                                                                                       \
+        for (; i < size; ++i) {                                                                                 \
+            result[i] = dr_matrix_kernels_##name(array[i]);                                                     \
+        }                                                                                                       \
+    }
+
+// sigmoid(x) = 1 / (1 + exp(-x)) and tanh(x) = 1 - 2 / (exp(2x) + 1), the derivatives take the outputs
+#define DR_MATRIX_KERNELS_DEFINE_ACTIVATIONS(                                                                   \
+    isa, isa_target, vector_type, width, load, store, set1, mul, add, sub, div, max, exp, step)                 \
+    DR_MATRIX_KERNELS_TARGET(isa_target) static inline vector_type                                              \
+        dr_matrix_kernels_##isa##_sigmoid_vector(const vector_type v) {                                         \
+        return div(set1(1), add(set1(1), exp(sub(set1(0), v))));                                                \
+    }                                                                                                           \
+    DR_MATRIX_KERNELS_TARGET(isa_target) static inline vector_type                                              \
+        dr_matrix_kernels_##isa##_sigmoid_derivative_vector(const vector_type v) {                              \
+        return mul(v, sub(set1(1), v));                                                                         \
+    }                                                                                                           \
+    DR_MATRIX_KERNELS_TARGET(isa_target) static inline vector_type                                              \
+        dr_matrix_kernels_##isa##_tanh_vector(const vector_type v) {                                            \
+        return sub(set1(1), div(set1(2), add(exp(add(v, v)), set1(1))));                                        \
+    }                                                                                                           \
+    DR_MATRIX_KERNELS_TARGET(isa_target) static inline vector_type                                              \
+        dr_matrix_kernels_##isa##_tanh_derivative_vector(const vector_type v) {                                 \
+        return sub(set1(1), mul(v, v));                                                                         \
+    }                                                                                                           \
+    DR_MATRIX_KERNELS_TARGET(isa_target) static inline vector_type                                              \
+        dr_matrix_kernels_##isa##_relu_vector(const vector_type v) {                                            \
+        return max(set1(0), v);                                                                                 \
+    }                                                                                                           \
+    DR_MATRIX_KERNELS_TARGET(isa_target) static inline vector_type                                              \
+        dr_matrix_kernels_##isa##_relu_derivative_vector(const vector_type v) {                                 \
+        return step(v);                                                                                         \
+    }                                                                                                           \
+    DR_MATRIX_KERNELS_DEFINE_UNARY(isa, isa_target, sigmoid, vector_type, width, load, store)                   \
+    DR_MATRIX_KERNELS_DEFINE_UNARY(isa, isa_target, sigmoid_derivative, vector_type, width, load, store)        \
+    DR_MATRIX_KERNELS_DEFINE_UNARY(isa, isa_target, tanh, vector_type, width, load, store)                      \
+    DR_MATRIX_KERNELS_DEFINE_UNARY(isa, isa_target, tanh_derivative, vector_type, width, load, store)           \
+    DR_MATRIX_KERNELS_DEFINE_UNARY(isa, isa_target, relu, vector_type, width, load, store)                      \
+    DR_MATRIX_KERNELS_DEFINE_UNARY(isa, isa_target, relu_derivative, vector_type, width, load, store)
+
+#define DR_MATRIX_KERNELS_DEFINE(                                                                              \
+    isa, isa_target, vector_type, width, load, store, set1, mul, add, sub, fmadd, reduce, gemm_tile,           \
+    bytes_to_floats, div, max, exp, step)                                                                       \
+    DR_MATRIX_KERNELS_DEFINE_ACTIVATIONS(                                                                       \
+        isa, isa_target, vector_type, width, load, store, set1, mul, add, sub, div, max, exp, step)             \
+    DR_MATRIX_KERNELS_TARGET(isa_target) static void dr_matrix_kernels_##isa##_fill(                            \
+        DR_FLOAT_TYPE* result, const DR_FLOAT_TYPE value, const size_t size) {                                  \
+        const vector_type v = set1(value);                                                                      \
+        size_t i = 0;                                                                                           \
+        for (; i + width <= size; i += width) {                                                                 \
+            store(result + i, v);                                                                               \
+        }                                                                                                       \
+        for (; i < size; ++i) {                                                                                 \
+            result[i] = value;                                                                                  \
+        }                                                                                                       \
+    }                                                                                                           \
+    DR_MATRIX_KERNELS_TARGET(isa_target) static void dr_matrix_kernels_##isa##_scale(                           \
+        const DR_FLOAT_TYPE* array, const DR_FLOAT_TYPE value, DR_FLOAT_TYPE* result, const size_t size) {      \
+        const vector_type v = set1(value);                                                                      \
+        size_t i = 0;                                                                                           \
+        for (; i + width <= size; i += width) {                                                                 \
+            store(result + i, mul(load(array + i), v));                                                         \
+        }                                                                                                       \
+        for (; i < size; ++i) {                                                                                 \
+            result[i] = array[i] * value;                                                                       \
+        }                                                                                                       \
+    }                                                                                                           \
+    DR_MATRIX_KERNELS_DEFINE_BINARY(isa, isa_target, multiplication, vector_type, width, load, store, mul, *)  \
+    DR_MATRIX_KERNELS_DEFINE_BINARY(isa, isa_target, addition, vector_type, width, load, store, add, +)        \
+    DR_MATRIX_KERNELS_DEFINE_BINARY(isa, isa_target, subtraction, vector_type, width, load, store, sub, -)     \
+    DR_MATRIX_KERNELS_TARGET(isa_target) static DR_FLOAT_TYPE dr_matrix_kernels_##isa##_dot(                    \
+        const DR_FLOAT_TYPE* left, const DR_FLOAT_TYPE* right, const size_t size) {                             \
+        vector_type sum_0 = set1(0);                                                                            \
+        vector_type sum_1 = set1(0);                                                                            \
+        vector_type sum_2 = set1(0);                                                                            \
+        vector_type sum_3 = set1(0);                                                                            \
+        size_t i = 0;                                                                                           \
+        for (; i + 4 * width <= size; i += 4 * width) {                                                         \
+            sum_0 = fmadd(load(left + i), load(right + i), sum_0);                                              \
+            sum_1 = fmadd(load(left + i + width), load(right + i + width), sum_1);                              \
+            sum_2 = fmadd(load(left + i + 2 * width), load(right + i + 2 * width), sum_2);                      \
+            sum_3 = fmadd(load(left + i + 3 * width), load(right + i + 3 * width), sum_3);                      \
+        }                                                                                                       \
+        for (; i + width <= size; i += width) {                                                                 \
+            sum_0 = fmadd(load(left + i), load(right + i), sum_0);                                              \
+        }                                                                                                       \
+        DR_FLOAT_TYPE result = reduce(add(add(sum_0, sum_1), add(sum_2, sum_3)));                               \
+        for (; i < size; ++i) {                                                                                 \
+            result += left[i] * right[i];                                                                       \
+        }                                                                                                       \
+        return result;                                                                                          \
+    }                                                                                                           \
+    DR_MATRIX_KERNELS_TARGET(isa_target) static void dr_matrix_kernels_##isa##_axpy(                            \
+        const DR_FLOAT_TYPE alpha, const DR_FLOAT_TYPE* array, DR_FLOAT_TYPE* result, const size_t size) {      \
+        const vector_type v = set1(alpha);                                                                      \
+        size_t i = 0;                                                                                           \
+        for (; i + width <= size; i += width) {                                                                 \
+            store(result + i, fmadd(v, load(array + i), load(result + i)));                                     \
+        }                                                                                                       \
+        for (; i < size; ++i) {                                                                                 \
+            result[i] += alpha * array[i];                                                                      \
+        }                                                                                                       \
+    }                                                                                                           \
+    static const dr_matrix_kernels dr_matrix_kernels_##isa = {                                                  \
+        dr_matrix_kernels_isa_##isa,                                                                            \
+        &dr_matrix_kernels_##isa##_fill,                                                                        \
+        &dr_matrix_kernels_##isa##_multiplication,                                                              \
+        &dr_matrix_kernels_##isa##_addition,                                                                    \
+        &dr_matrix_kernels_##isa##_subtraction,                                                                 \
+        &dr_matrix_kernels_##isa##_scale,                                                                       \
+        &dr_matrix_kernels_##isa##_dot,                                                                         \
+        &dr_matrix_kernels_##isa##_axpy,                                                                        \
+        &gemm_tile,                                                                                             \
+        &bytes_to_floats,                                                                                       \
+        &dr_matrix_kernels_##isa##_sigmoid,                                                                     \
+        &dr_matrix_kernels_##isa##_sigmoid_derivative,                                                          \
+        &dr_matrix_kernels_##isa##_tanh,                                                                        \
+        &dr_matrix_kernels_##isa##_tanh_derivative,                                                             \
+        &dr_matrix_kernels_##isa##_relu,                                                                        \
+        &dr_matrix_kernels_##isa##_relu_derivative                                                              \
+    };
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////// SSE2
+
+DR_MATRIX_KERNELS_TARGET("sse2") static inline __m128 dr_matrix_kernels_sse2_fmadd(
+    const __m128 left, const __m128 right, const __m128 sum) {
+    return _mm_add_ps(_mm_mul_ps(left, right), sum);
+}
+
+DR_MATRIX_KERNELS_TARGET("sse2") static inline DR_FLOAT_TYPE dr_matrix_kernels_sse2_reduce(const __m128 vector) {
+    const __m128 sum_halves = _mm_add_ps(vector, _mm_movehl_ps(vector, vector));
+    const __m128 sum        = _mm_add_ss(sum_halves, _mm_shuffle_ps(sum_halves, sum_halves, 1));
+    return _mm_cvtss_f32(sum);
+}
+
+// the tile is kept in named variables, arrays of vectors are spilled to the stack by the compiler
+DR_MATRIX_KERNELS_TARGET("sse2") static void dr_matrix_kernels_sse2_gemm_tile(
+    const size_t kc, const DR_FLOAT_TYPE* packed_A, const DR_FLOAT_TYPE* packed_B, DR_FLOAT_TYPE* tile) {
+    __m128 row_0_left = _mm_setzero_ps(), row_0_right = _mm_setzero_ps();
+    __m128 row_1_left = _mm_setzero_ps(), row_1_right = _mm_setzero_ps();
+    __m128 row_2_left = _mm_setzero_ps(), row_2_right = _mm_setzero_ps();
+    __m128 row_3_left = _mm_setzero_ps(), row_3_right = _mm_setzero_ps();
+    for (size_t p = 0; p < kc; ++p) {
+        const __m128 b_left  = _mm_loadu_ps(packed_B);
+        const __m128 b_right = _mm_loadu_ps(packed_B + 4);
+        __m128 a = _mm_set1_ps(packed_A[0]);
+        row_0_left  = dr_matrix_kernels_sse2_fmadd(a, b_left, row_0_left);
+        row_0_right = dr_matrix_kernels_sse2_fmadd(a, b_right, row_0_right);
+        a = _mm_set1_ps(packed_A[1]);
+        row_1_left  = dr_matrix_kernels_sse2_fmadd(a, b_left, row_1_left);
+        row_1_right = dr_matrix_kernels_sse2_fmadd(a, b_right, row_1_right);
+        a = _mm_set1_ps(packed_A[2]);
+        row_2_left  = dr_matrix_kernels_sse2_fmadd(a, b_left, row_2_left);
+        row_2_right = dr_matrix_kernels_sse2_fmadd(a, b_right, row_2_right);
+        a = _mm_set1_ps(packed_A[3]);
+        row_3_left  = dr_matrix_kernels_sse2_fmadd(a, b_left, row_3_left);
+        row_3_right = dr_matrix_kernels_sse2_fmadd(a, b_right, row_3_right);
+        packed_A += DR_MATRIX_KERNELS_GEMM_MR;
+        packed_B += DR_MATRIX_KERNELS_GEMM_NR;
+    }
+    _mm_storeu_ps(tile, row_0_left);
+    _mm_storeu_ps(tile + 4, row_0_right);
+    _mm_storeu_ps(tile + 8, row_1_left);
+    _mm_storeu_ps(tile + 12, row_1_right);
+    _mm_storeu_ps(tile + 16, row_2_left);
+    _mm_storeu_ps(tile + 20, row_2_right);
+    _mm_storeu_ps(tile + 24, row_3_left);
+    _mm_storeu_ps(tile + 28, row_3_right);
+}
+
+DR_MATRIX_KERNELS_TARGET("sse2") static void dr_matrix_kernels_sse2_bytes_to_floats(
+    const unsigned char* bytes, const DR_FLOAT_TYPE scale, DR_FLOAT_TYPE* result, const size_t size) {
+    const __m128 scale_vector = _mm_set1_ps(scale);
+    const __m128i zero        = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        // the bytes are widened to 16 and then to 32 bits by interleaving them with zeros
+        const __m128i bytes_vector = _mm_loadu_si128((const __m128i*)(bytes + i));
+        const __m128i low_words    = _mm_unpacklo_epi8(bytes_vector, zero);
+        const __m128i high_words   = _mm_unpackhi_epi8(bytes_vector, zero);
+        _mm_storeu_ps(result + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(low_words, zero)), scale_vector));
+        _mm_storeu_ps(result + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(low_words, zero)), scale_vector));
+        _mm_storeu_ps(result + i + 8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(high_words, zero)), scale_vector));
+        _mm_storeu_ps(result + i + 12,
+            _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(high_words, zero)), scale_vector));
+    }
+    for (; i < size; ++i) {
+        result[i] = bytes[i] * scale;
+    }
+}
+
+DR_MATRIX_KERNELS_TARGET("sse2") static inline __m128 dr_matrix_kernels_sse2_exp(const __m128 value) {
+    const __m128 x = _mm_max_ps(_mm_set1_ps(DR_MATRIX_KERNELS_EXP_MIN),
+        _mm_min_ps(_mm_set1_ps(DR_MATRIX_KERNELS_EXP_MAX), value));
+    const __m128i n_integer = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(DR_MATRIX_KERNELS_EXP_LOG2E)));
+    const __m128 n = _mm_cvtepi32_ps(n_integer);
+    __m128 r = _mm_sub_ps(x, _mm_mul_ps(n, _mm_set1_ps(DR_MATRIX_KERNELS_EXP_LN2_HIGH)));
+    r = _mm_sub_ps(r, _mm_mul_ps(n, _mm_set1_ps(DR_MATRIX_KERNELS_EXP_LN2_LOW)));
+    __m128 p = _mm_set1_ps(DR_MATRIX_KERNELS_EXP_P0);
+    p = dr_matrix_kernels_sse2_fmadd(p, r, _mm_set1_ps(DR_MATRIX_KERNELS_EXP_P1));
+    p = dr_matrix_kernels_sse2_fmadd(p, r, _mm_set1_ps(DR_MATRIX_KERNELS_EXP_P2));
+    p = dr_matrix_kernels_sse2_fmadd(p, r, _mm_set1_ps(DR_MATRIX_KERNELS_EXP_P3));
+    p = dr_matrix_kernels_sse2_fmadd(p, r, _mm_set1_ps(DR_MATRIX_KERNELS_EXP_P4));
+    p = dr_matrix_kernels_sse2_fmadd(p, r, _mm_set1_ps(DR_MATRIX_KERNELS_EXP_P5));
+    p = dr_matrix_kernels_sse2_fmadd(p, _mm_mul_ps(r, r), _mm_add_ps(r, _mm_set1_ps(1)));
+    // 2^n is assembled in the exponent bits
+    const __m128i power = _mm_slli_epi32(_mm_add_epi32(n_integer, _mm_set1_epi32(127)), 23);
+    return _mm_mul_ps(p, _mm_castsi128_ps(power));
+}
+
+DR_MATRIX_KERNELS_TARGET("sse2") static inline __m128 dr_matrix_kernels_sse2_step(const __m128 vector) {
+    return _mm_and_ps(_mm_cmpgt_ps(vector, _mm_setzero_ps()), _mm_set1_ps(1));
+}
+
+DR_MATRIX_KERNELS_DEFINE(sse2, "sse2", __m128, 4,
+    _mm_loadu_ps, _mm_storeu_ps, _mm_set1_ps, _mm_mul_ps, _mm_add_ps, _mm_sub_ps,
+    dr_matrix_kernels_sse2_fmadd, dr_matrix_kernels_sse2_reduce, dr_matrix_kernels_sse2_gemm_tile,
+    dr_matrix_kernels_sse2_bytes_to_floats, _mm_div_ps, _mm_max_ps, dr_matrix_kernels_sse2_exp,
+    dr_matrix_kernels_sse2_step)
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////// AVX2
+
+DR_MATRIX_KERNELS_TARGET("avx2,fma") static inline DR_FLOAT_TYPE dr_matrix_kernels_avx2_reduce(const __m256 vector) {
+    return dr_matrix_kernels_sse2_reduce(_mm_add_ps(_mm256_castps256_ps128(vector), _mm256_extractf128_ps(vector, 1)));
+}
+
+DR_MATRIX_KERNELS_TARGET("avx2,fma") static void dr_matrix_kernels_avx2_gemm_tile(
+    const size_t kc, const DR_FLOAT_TYPE* packed_A, const DR_FLOAT_TYPE* packed_B, DR_FLOAT_TYPE* tile) {
+    // two sets of accumulators for the even and the odd steps hide the latency of the FMA
+    __m256 row_0 = _mm256_setzero_ps(), row_0_odd = _mm256_setzero_ps();
+    __m256 row_1 = _mm256_setzero_ps(), row_1_odd = _mm256_setzero_ps();
+    __m256 row_2 = _mm256_setzero_ps(), row_2_odd = _mm256_setzero_ps();
+    __m256 row_3 = _mm256_setzero_ps(), row_3_odd = _mm256_setzero_ps();
+    size_t p = 0;
+    for (; p + 2 <= kc; p += 2) {
+        const __m256 b     = _mm256_loadu_ps(packed_B);
+        const __m256 b_odd = _mm256_loadu_ps(packed_B + DR_MATRIX_KERNELS_GEMM_NR);
+        row_0     = _mm256_fmadd_ps(_mm256_set1_ps(packed_A[0]), b, row_0);
+        row_1     = _mm256_fmadd_ps(_mm256_set1_ps(packed_A[1]), b, row_1);
+        row_2     = _mm256_fmadd_ps(_mm256_set1_ps(packed_A[2]), b, row_2);
+        row_3     = _mm256_fmadd_ps(_mm256_set1_ps(packed_A[3]), b, row_3);
+        row_0_odd = _mm256_fmadd_ps(_mm256_set1_ps(packed_A[4]), b_odd, row_0_odd);
+        row_1_odd = _mm256_fmadd_ps(_mm256_set1_ps(packed_A[5]), b_odd, row_1_odd);
+        row_2_odd = _mm256_fmadd_ps(_mm256_set1_ps(packed_A[6]), b_odd, row_2_odd);
+        row_3_odd = _mm256_fmadd_ps(_mm256_set1_ps(packed_A[7]), b_odd, row_3_odd);
+        packed_A += 2 * DR_MATRIX_KERNELS_GEMM_MR;
+        packed_B += 2 * DR_MATRIX_KERNELS_GEMM_NR;
+    }
+    if (p < kc) {
+        const __m256 b = _mm256_loadu_ps(packed_B);
+        row_0 = _mm256_fmadd_ps(_mm256_set1_ps(packed_A[0]), b, row_0);
+        row_1 = _mm256_fmadd_ps(_mm256_set1_ps(packed_A[1]), b, row_1);
+        row_2 = _mm256_fmadd_ps(_mm256_set1_ps(packed_A[2]), b, row_2);
+        row_3 = _mm256_fmadd_ps(_mm256_set1_ps(packed_A[3]), b, row_3);
+    }
+    _mm256_storeu_ps(tile, _mm256_add_ps(row_0, row_0_odd));
+    _mm256_storeu_ps(tile + 8, _mm256_add_ps(row_1, row_1_odd));
+    _mm256_storeu_ps(tile + 16, _mm256_add_ps(row_2, row_2_odd));
+    _mm256_storeu_ps(tile + 24, _mm256_add_ps(row_3, row_3_odd));
+}
+
+DR_MATRIX_KERNELS_TARGET("avx2,fma") static void dr_matrix_kernels_avx2_bytes_to_floats(
+    const unsigned char* bytes, const DR_FLOAT_TYPE scale, DR_FLOAT_TYPE* result, const size_t size) {
+    const __m256 scale_vector = _mm256_set1_ps(scale);
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        const __m128i bytes_vector = _mm_loadu_si128((const __m128i*)(bytes + i));
+        const __m256i low_words    = _mm256_cvtepu8_epi32(bytes_vector);
+        const __m256i high_words   = _mm256_cvtepu8_epi32(_mm_srli_si128(bytes_vector, 8));
+        _mm256_storeu_ps(result + i, _mm256_mul_ps(_mm256_cvtepi32_ps(low_words), scale_vector));
+        _mm256_storeu_ps(result + i + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(high_words), scale_vector));
+    }
+    for (; i < size; ++i) {
+        result[i] = bytes[i] * scale;
+    }
+}
+
+DR_MATRIX_KERNELS_TARGET("avx2,fma") static inline __m256 dr_matrix_kernels_avx2_exp(const __m256 value) {
+    const __m256 x = _mm256_max_ps(_mm256_set1_ps(DR_MATRIX_KERNELS_EXP_MIN),
+        _mm256_min_ps(_mm256_set1_ps(DR_MATRIX_KERNELS_EXP_MAX), value));
+    const __m256i n_integer = _mm256_cvtps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(DR_MATRIX_KERNELS_EXP_LOG2E)));
+    const __m256 n = _mm256_cvtepi32_ps(n_integer);
+    __m256 r = _mm256_sub_ps(x, _mm256_mul_ps(n, _mm256_set1_ps(DR_MATRIX_KERNELS_EXP_LN2_HIGH)));
+    r = _mm256_sub_ps(r, _mm256_mul_ps(n, _mm256_set1_ps(DR_MATRIX_KERNELS_EXP_LN2_LOW)));
+    __m256 p = _mm256_set1_ps(DR_MATRIX_KERNELS_EXP_P0);
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(DR_MATRIX_KERNELS_EXP_P1));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(DR_MATRIX_KERNELS_EXP_P2));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(DR_MATRIX_KERNELS_EXP_P3));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(DR_MATRIX_KERNELS_EXP_P4));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(DR_MATRIX_KERNELS_EXP_P5));
+    p = _mm256_fmadd_ps(p, _mm256_mul_ps(r, r), _mm256_add_ps(r, _mm256_set1_ps(1)));
+    const __m256i power = _mm256_slli_epi32(_mm256_add_epi32(n_integer, _mm256_set1_epi32(127)), 23);
+    return _mm256_mul_ps(p, _mm256_castsi256_ps(power));
+}
+
+DR_MATRIX_KERNELS_TARGET("avx2,fma") static inline __m256 dr_matrix_kernels_avx2_step(const __m256 vector) {
+    return _mm256_and_ps(_mm256_cmp_ps(vector, _mm256_setzero_ps(), _CMP_GT_OQ), _mm256_set1_ps(1));
+}
+
+DR_MATRIX_KERNELS_DEFINE(avx2, "avx2,fma", __m256, 8,
+    _mm256_loadu_ps, _mm256_storeu_ps, _mm256_set1_ps, _mm256_mul_ps, _mm256_add_ps, _mm256_sub_ps,
+    _mm256_fmadd_ps, dr_matrix_kernels_avx2_reduce, dr_matrix_kernels_avx2_gemm_tile,
+    dr_matrix_kernels_avx2_bytes_to_floats, _mm256_div_ps, _mm256_max_ps, dr_matrix_kernels_avx2_exp,
+    dr_matrix_kernels_avx2_step)
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////// AVX512
+
+DR_MATRIX_KERNELS_TARGET("avx512f") static void dr_matrix_kernels_avx512_bytes_to_floats(
+    const unsigned char* bytes, const DR_FLOAT_TYPE scale, DR_FLOAT_TYPE* result, const size_t size) {
+    const __m512 scale_vector = _mm512_set1_ps(scale);
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        const __m512i words = _mm512_cvtepu8_epi32(_mm_loadu_si128((const __m128i*)(bytes + i)));
+        _mm512_storeu_ps(result + i, _mm512_mul_ps(_mm512_cvtepi32_ps(words), scale_vector));
+    }
+    for (; i < size; ++i) {
+        result[i] = bytes[i] * scale;
+    }
+}
+
+DR_MATRIX_KERNELS_TARGET("avx512f") static inline __m512 dr_matrix_kernels_avx512_exp(const __m512 value) {
+    const __m512 x = _mm512_max_ps(_mm512_set1_ps(DR_MATRIX_KERNELS_EXP_MIN),
+        _mm512_min_ps(_mm512_set1_ps(DR_MATRIX_KERNELS_EXP_MAX), value));
+    const __m512i n_integer = _mm512_cvtps_epi32(_mm512_mul_ps(x, _mm512_set1_ps(DR_MATRIX_KERNELS_EXP_LOG2E)));
+    const __m512 n = _mm512_cvtepi32_ps(n_integer);
+    __m512 r = _mm512_sub_ps(x, _mm512_mul_ps(n, _mm512_set1_ps(DR_MATRIX_KERNELS_EXP_LN2_HIGH)));
+    r = _mm512_sub_ps(r, _mm512_mul_ps(n, _mm512_set1_ps(DR_MATRIX_KERNELS_EXP_LN2_LOW)));
+    __m512 p = _mm512_set1_ps(DR_MATRIX_KERNELS_EXP_P0);
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(DR_MATRIX_KERNELS_EXP_P1));
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(DR_MATRIX_KERNELS_EXP_P2));
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(DR_MATRIX_KERNELS_EXP_P3));
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(DR_MATRIX_KERNELS_EXP_P4));
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(DR_MATRIX_KERNELS_EXP_P5));
+    p = _mm512_fmadd_ps(p, _mm512_mul_ps(r, r), _mm512_add_ps(r, _mm512_set1_ps(1)));
+    const __m512i power = _mm512_slli_epi32(_mm512_add_epi32(n_integer, _mm512_set1_epi32(127)), 23);
+    return _mm512_mul_ps(p, _mm512_castsi512_ps(power));
+}
+
+DR_MATRIX_KERNELS_TARGET("avx512f") static inline __m512 dr_matrix_kernels_avx512_step(const __m512 vector) {
+    return _mm512_maskz_mov_ps(_mm512_cmp_ps_mask(vector, _mm512_setzero_ps(), _CMP_GT_OQ), _mm512_set1_ps(1));
+}
+
+// a row of the GEMM tile is 8 floats wide, so the AVX2 tile is reused (and AVX-512 requires FMA below)
+DR_MATRIX_KERNELS_DEFINE(avx512, "avx512f", __m512, 16,
+    _mm512_loadu_ps, _mm512_storeu_ps, _mm512_set1_ps, _mm512_mul_ps, _mm512_add_ps, _mm512_sub_ps,
+    _mm512_fmadd_ps, _mm512_reduce_add_ps, dr_matrix_kernels_avx2_gemm_tile,
+    dr_matrix_kernels_avx512_bytes_to_floats, _mm512_div_ps, _mm512_max_ps, dr_matrix_kernels_avx512_exp,
+    dr_matrix_kernels_avx512_step)
+
+#endif // DR_MATRIX_KERNELS_X86
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////// DISPATCH
+
+// the selected kernels, published with the dr_atomic pointer functions
+static void* volatile dr_matrix_kernels_current = NULL;
+
+#if defined(DR_MATRIX_KERNELS_X86) && defined(_MSC_VER)
+static bool dr_matrix_kernels_msvc_cpu_supports(const dr_matrix_kernels_isa isa) {
+    int info[4] = { 0 };
+    __cpuid(info, 0);
+    const int max_leaf = info[0];
+    __cpuid(info, 1);
+    const bool sse2    = (info[3] & (1 << 26)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+    const bool os_avx    = (xcr0 & 0x6) == 0x6;
+    const bool os_avx512 = (xcr0 & 0xE6) == 0xE6;
+    const bool fma     = (info[2] & (1 << 12)) != 0;
+    bool avx2    = false;
+    bool avx512f = false;
+    if (max_leaf >= 7) {
+        __cpuidex(info, 7, 0);
+        avx2    = (info[1] & (1 << 5)) != 0;
+        avx512f = (info[1] & (1 << 16)) != 0;
+    }
+    switch (isa) {
+    case dr_matrix_kernels_isa_sse2:
+        return sse2;
+    case dr_matrix_kernels_isa_avx2:
+        return avx2 && fma && os_avx;
+    case dr_matrix_kernels_isa_avx512:
+        return avx512f && fma && os_avx512;
+    default:
+        return false;
+    }
+}
+#endif
+
+bool dr_matrix_kernels_isa_supported(const dr_matrix_kernels_isa isa) {
+    if (isa == dr_matrix_kernels_isa_scalar) {
+        return true;
+    }
+#if defined(DR_MATRIX_KERNELS_X86) && defined(_MSC_VER)
+    return dr_matrix_kernels_msvc_cpu_supports(isa);
+#elif defined(DR_MATRIX_KERNELS_X86)
+    __builtin_cpu_init();
+    switch (isa) {
+    case dr_matrix_kernels_isa_sse2:
+        return __builtin_cpu_supports("sse2");
+    case dr_matrix_kernels_isa_avx2:
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    case dr_matrix_kernels_isa_avx512:
+        return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("fma");
+    default:
+        return false;
+    }
+#else
+    return false;
+#endif
+}
+
+dr_matrix_kernels_isa dr_matrix_kernels_detect_isa() {
+    if (dr_matrix_kernels_isa_supported(dr_matrix_kernels_isa_avx512)) {
+        return dr_matrix_kernels_isa_avx512;
+    } else if (dr_matrix_kernels_isa_supported(dr_matrix_kernels_isa_avx2)) {
+        return dr_matrix_kernels_isa_avx2;
+    } else if (dr_matrix_kernels_isa_supported(dr_matrix_kernels_isa_sse2)) {
+        return dr_matrix_kernels_isa_sse2;
+    } else {
+        return dr_matrix_kernels_isa_scalar;
+    }
+}
+
+const char* dr_matrix_kernels_isa_to_string(const dr_matrix_kernels_isa isa) {
+    switch (isa) {
+    case dr_matrix_kernels_isa_scalar:
+        return "scalar";
+    case dr_matrix_kernels_isa_sse2:
+        return "SSE2";
+    case dr_matrix_kernels_isa_avx2:
+        return "AVX2";
+    case dr_matrix_kernels_isa_avx512:
+        return "AVX-512";
+    default:
+        return "unknown";
+    }
+}
+
+bool dr_matrix_kernels_select(const dr_matrix_kernels_isa isa) {
+    if (!dr_matrix_kernels_isa_supported(isa)) {
+        return false;
+    }
+    const dr_matrix_kernels* kernels = NULL;
+    switch (isa) {
+#ifdef DR_MATRIX_KERNELS_X86
+    case dr_matrix_kernels_isa_sse2:
+        kernels = &dr_matrix_kernels_sse2;
+        break;
+    case dr_matrix_kernels_isa_avx2:
+        kernels = &dr_matrix_kernels_avx2;
+        break;
+    case dr_matrix_kernels_isa_avx512:
+        kernels = &dr_matrix_kernels_avx512;
+        break;
+#endif // DR_MATRIX_KERNELS_X86
+    case dr_matrix_kernels_isa_scalar:
+        kernels = &dr_matrix_kernels_scalar;
+        break;
+    default:
+        return false;
+    }
+    dr_atomic_store_pointer_release(&dr_matrix_kernels_current, (void*)kernels);
+    return true;
+}
+
+const dr_matrix_kernels* dr_matrix_kernels_get() {
+    const dr_matrix_kernels* kernels = (const dr_matrix_kernels*)dr_atomic_load_pointer_acquire(
+        &dr_matrix_kernels_current);
+    if (!kernels) {
+        // threads racing on the first call store the same detected kernels
+        dr_matrix_kernels_select(dr_matrix_kernels_detect_isa());
+        kernels = (const dr_matrix_kernels*)dr_atomic_load_pointer_acquire(&dr_matrix_kernels_current);
+    }
+    return kernels;
+}
\ No newline at end of file
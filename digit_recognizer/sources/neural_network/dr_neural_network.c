@@ -1,29 +1,65 @@
 #include <neural_network/dr_neural_network.h>
+#include <neural_network/dr_matrix_kernels.h>
+#include <general/dr_parallel.h>
+#include <general/dr_time.h>
+#include <general/dr_file_mapping.h>
+#include <stdint.h>
+#include <limits.h>
+
+// number of samples propagated at once by the batch prediction, bounds the memory of the intermediate layers
+#define DR_NEURAL_NETWORK_PREDICT_BATCH_CHUNK 256
+
+// number of derivatives computed at once on the stack by the batch back propagation
+#define DR_NEURAL_NETWORK_DERIVATIVES_CHUNK 256
 
 DR_FLOAT_TYPE dr_sigmoid(const DR_FLOAT_TYPE value) {
-    return 1.0 / (1.0 + exp(-value));
+    return 1 / (1 + expf(-value));
+}
+
+void dr_sigmoid_array(const DR_FLOAT_TYPE* values, DR_FLOAT_TYPE* result, const size_t size) {
+    dr_matrix_kernels_get()->sigmoid(values, result, size);
 }
 
 DR_FLOAT_TYPE dr_sigmoid_derivative(const DR_FLOAT_TYPE value) {
-    return value * (1.0 - value);
+    return value * (1 - value);
+}
+
+void dr_sigmoid_derivative_array(const DR_FLOAT_TYPE* values, DR_FLOAT_TYPE* result, const size_t size) {
+    dr_matrix_kernels_get()->sigmoid_derivative(values, result, size);
 }
 
 DR_FLOAT_TYPE dr_tanh(const DR_FLOAT_TYPE value) {
-    return tanh(value);
+    return tanhf(value);
+}
+
+void dr_tanh_array(const DR_FLOAT_TYPE* values, DR_FLOAT_TYPE* result, const size_t size) {
+    dr_matrix_kernels_get()->tanh(values, result, size);
 }
 
 DR_FLOAT_TYPE dr_tanh_derivative(const DR_FLOAT_TYPE value) {
-    return 1.0 - pow(value, 2);
+    return 1 - value * value;
+}
+
+void dr_tanh_derivative_array(const DR_FLOAT_TYPE* values, DR_FLOAT_TYPE* result, const size_t size) {
+    dr_matrix_kernels_get()->tanh_derivative(values, result, size);
 }
 
 DR_FLOAT_TYPE dr_relu(const DR_FLOAT_TYPE value) {
     return value < 0.0 ? 0 : value;
 }
 
+void dr_relu_array(const DR_FLOAT_TYPE* values, DR_FLOAT_TYPE* result, const size_t size) {
+    dr_matrix_kernels_get()->relu(values, result, size);
+}
+
 DR_FLOAT_TYPE dr_relu_derivative(const DR_FLOAT_TYPE value) {
     return value > 0;
 }
 
+void dr_relu_derivative_array(const DR_FLOAT_TYPE* values, DR_FLOAT_TYPE* result, const size_t size) {
+    dr_matrix_kernels_get()->relu_derivative(values, result, size);
+}
+
 char* dr_default_activation_function_to_string(const dr_activation_function activation_function) {
     DR_ASSERT_MSG(activation_function, "attempt to convert a NULL activation function to the string");
     if (activation_function == &dr_sigmoid) {
@@ -77,6 +113,62 @@ dr_activation_function dr_default_activation_function_derivative_from_string(con
     }
 }
 
+dr_activation_function_id dr_default_activation_function_to_id(const dr_activation_function activation_function) {
+    DR_ASSERT_MSG(activation_function, "attempt to convert a NULL activation function to the id");
+    if (activation_function == &dr_sigmoid) {
+        return dr_activation_function_id_sigmoid;
+    } else if (activation_function == &dr_sigmoid_derivative) {
+        return dr_activation_function_id_sigmoid_derivative;
+    } else if (activation_function == &dr_tanh) {
+        return dr_activation_function_id_tanh;
+    } else if (activation_function == &dr_tanh_derivative) {
+        return dr_activation_function_id_tanh_derivative;
+    } else if (activation_function == &dr_relu) {
+        return dr_activation_function_id_relu;
+    } else if (activation_function == &dr_relu_derivative) {
+        return dr_activation_function_id_relu_derivative;
+    } else {
+        return dr_activation_function_id_none;
+    }
+}
+
+dr_activation_function dr_default_activation_function_from_id(const dr_activation_function_id id) {
+    switch (id) {
+    case dr_activation_function_id_sigmoid:
+        return &dr_sigmoid;
+    case dr_activation_function_id_sigmoid_derivative:
+        return &dr_sigmoid_derivative;
+    case dr_activation_function_id_tanh:
+        return &dr_tanh;
+    case dr_activation_function_id_tanh_derivative:
+        return &dr_tanh_derivative;
+    case dr_activation_function_id_relu:
+        return &dr_relu;
+    case dr_activation_function_id_relu_derivative:
+        return &dr_relu_derivative;
+    default:
+        return NULL;
+    }
+}
+
+dr_activation_function_array dr_default_activation_function_to_array(const dr_activation_function activation_function) {
+    if (activation_function == &dr_sigmoid) {
+        return &dr_sigmoid_array;
+    } else if (activation_function == &dr_sigmoid_derivative) {
+        return &dr_sigmoid_derivative_array;
+    } else if (activation_function == &dr_tanh) {
+        return &dr_tanh_array;
+    } else if (activation_function == &dr_tanh_derivative) {
+        return &dr_tanh_derivative_array;
+    } else if (activation_function == &dr_relu) {
+        return &dr_relu_array;
+    } else if (activation_function == &dr_relu_derivative) {
+        return &dr_relu_derivative_array;
+    } else {
+        return NULL;
+    }
+}
+
 bool dr_neural_network_valid(const dr_neural_network neural_network) {
     return (neural_network.layers_count >= 2) &&
         neural_network.layers &&
@@ -98,6 +190,7 @@ dr_neural_network dr_neural_network_create(
     dr_neural_network nn;
     nn.layers_count      = layers_count;
     nn.connections_count = layers_count - 1; // <- number of connections less than count of layers by 1
+    nn.mapping           = NULL;
 
     nn.activation_functions = (dr_activation_function*)DR_MALLOC(sizeof(dr_activation_function) * nn.connections_count);
     DR_ASSERT_MSG(nn.activation_functions, "alloc neural network activation functions error");
@@ -126,6 +219,7 @@ dr_neural_network dr_neural_network_unchecked_copy_create(const dr_neural_networ
     dr_neural_network new_neural_network;
     new_neural_network.layers_count      = neural_network.layers_count;
     new_neural_network.connections_count = neural_network.connections_count;
+    new_neural_network.mapping           = NULL; // <- the copy owns its weights, so it can be trained
 
     new_neural_network.activation_functions =
         (dr_activation_function*)DR_MALLOC(sizeof(dr_activation_function) * new_neural_network.connections_count);
@@ -174,8 +268,15 @@ void dr_neural_network_free(dr_neural_network* neural_network) {
     neural_network->layers_count = 0;
     neural_network->layers       = NULL;
 
-    for (size_t i = 0; i < neural_network->connections_count; ++i) {
-        dr_matrix_free(neural_network->connections + i);
+    // the connections of a mapped neural network point into the mapping
+    if (neural_network->mapping) {
+        dr_file_mapping_close(neural_network->mapping);
+        DR_FREE(neural_network->mapping);
+        neural_network->mapping = NULL;
+    } else {
+        for (size_t i = 0; i < neural_network->connections_count; ++i) {
+            dr_matrix_free(neural_network->connections + i);
+        }
     }
     DR_FREE(neural_network->connections);
     neural_network->connections_count = 0;
@@ -225,6 +326,19 @@ void dr_neural_network_set_input(dr_neural_network neural_network, const DR_FLOA
     dr_neural_network_unchecked_set_input(neural_network, input);
 }
 
+void dr_neural_network_unchecked_set_input_bytes(
+    dr_neural_network neural_network, const unsigned char* input, const DR_FLOAT_TYPE scale) {
+    const dr_matrix input_layer = neural_network.layers[0];
+    dr_matrix_kernels_get()->bytes_to_floats(input, scale, input_layer.elements, dr_matrix_unchecked_size(input_layer));
+}
+
+void dr_neural_network_set_input_bytes(
+    dr_neural_network neural_network, const unsigned char* input, const DR_FLOAT_TYPE scale) {
+    DR_ASSERT_MSG(input, "attempt to set a NULL input array for a neural network");
+    DR_ASSERT_MSG(dr_neural_network_valid(neural_network), "attempt to set input for a not valid neural network");
+    dr_neural_network_unchecked_set_input_bytes(neural_network, input, scale);
+}
+
 void dr_neural_network_unchecked_get_output(const dr_neural_network neural_network, DR_FLOAT_TYPE* output) {
     dr_matrix_copy_to_array(neural_network.layers[neural_network.layers_count - 1], output);
 }
@@ -235,107 +349,162 @@ void dr_neural_network_get_output(const dr_neural_network neural_network, DR_FLO
     dr_neural_network_unchecked_get_output(neural_network, output);
 }
 
-void dr_neural_network_unchecked_forward_propagation(dr_neural_network neural_network) {
+// the default activation functions go through the vector kernels, the other ones are applied element by element
+static inline void dr_neural_network_details_activate(
+    const dr_activation_function activation, DR_FLOAT_TYPE* values, const size_t size) {
+    const dr_activation_function_array activation_array = dr_default_activation_function_to_array(activation);
+    if (activation_array) {
+        activation_array(values, values, size);
+        return;
+    }
+    for (size_t i = 0; i < size; ++i) {
+        values[i] = activation(values[i]);
+    }
+}
+
+// errors o= f'(outputs), the outputs are kept, so the derivatives are computed into a buffer on the stack
+static inline void dr_neural_network_details_multiply_by_derivative(const dr_activation_function derivative,
+    const DR_FLOAT_TYPE* outputs, DR_FLOAT_TYPE* errors, const size_t size) {
+    const dr_activation_function_array derivative_array = dr_default_activation_function_to_array(derivative);
+    if (!derivative_array) {
+        for (size_t i = 0; i < size; ++i) {
+            errors[i] *= derivative(outputs[i]);
+        }
+        return;
+    }
+    const dr_matrix_kernel_binary multiplication = dr_matrix_kernels_get()->multiplication;
+    DR_FLOAT_TYPE derivatives[DR_NEURAL_NETWORK_DERIVATIVES_CHUNK];
+    for (size_t begin = 0; begin < size; begin += DR_NEURAL_NETWORK_DERIVATIVES_CHUNK) {
+        const size_t count = size - begin < DR_NEURAL_NETWORK_DERIVATIVES_CHUNK ?
+            size - begin : DR_NEURAL_NETWORK_DERIVATIVES_CHUNK;
+        derivative_array(outputs + begin, derivatives, count);
+        multiplication(errors + begin, derivatives, errors + begin, count);
+    }
+}
+
+// propagates layers[0] through the connections of the neural network into the other layers
+static inline void dr_neural_network_details_forward_propagation(
+    const dr_neural_network neural_network, dr_matrix* layers) {
     for (size_t i = 1; i < neural_network.layers_count; ++i) {
         const size_t prev_index    = i - 1;
         const dr_matrix connection = neural_network.connections[prev_index];
-        const dr_matrix layer      = neural_network.layers[prev_index];
-        dr_matrix result_layer     = *(neural_network.layers + i);
-        dr_matrix_unchecked_dot_write(connection, layer, result_layer);
-        // activating
-        const size_t result_layer_size = dr_matrix_unchecked_size(result_layer);
-        for (size_t j = 0; j < result_layer_size; ++j) {
-            DR_FLOAT_TYPE* element = result_layer.elements + j;
-            *element = neural_network.activation_functions[prev_index](*element);
-        }
+        const dr_matrix layer      = layers[prev_index];
+        dr_matrix result_layer     = layers[i];
+        dr_matrix_unchecked_gemv_write(connection, layer, result_layer);
+        dr_neural_network_details_activate(neural_network.activation_functions[prev_index],
+            result_layer.elements, dr_matrix_unchecked_size(result_layer));
     }
 }
 
+void dr_neural_network_unchecked_forward_propagation(dr_neural_network neural_network) {
+    dr_neural_network_details_forward_propagation(neural_network, neural_network.layers);
+}
+
 void dr_neural_network_forward_propagation(dr_neural_network neural_network) {
     DR_ASSERT_MSG(dr_neural_network_valid(neural_network),
         "attempt to call a forward propagation on a not valid neural network");
     dr_neural_network_unchecked_forward_propagation(neural_network);
 }
 
-static inline dr_matrix dr_neural_network_details_activation_functions_derivatives_for_layer_matrix_create(
-    const dr_neural_network neural_network, const size_t layer_index) {
-    const dr_matrix layer       = neural_network.layers[layer_index];
-    dr_matrix result            = dr_matrix_alloc(layer.width, layer.height);
-    const size_t layer_size     = dr_matrix_unchecked_size(layer);
-    dr_activation_function func = neural_network.activation_functions_derivatives[layer_index - 1];
-    for (size_t i = 0; i < layer_size; ++i) {
-        result.elements[i] = func(layer.elements[i]);
+dr_training_workspace dr_training_workspace_unchecked_create(const dr_neural_network neural_network) {
+    dr_training_workspace training_workspace;
+    training_workspace.layers_count = neural_network.layers_count;
+
+    training_workspace.errors = (dr_matrix*)DR_MALLOC(sizeof(dr_matrix) * training_workspace.layers_count);
+    DR_ASSERT_MSG(training_workspace.errors, "alloc training workspace errors error");
+    training_workspace.errors[0] = dr_matrix_create_empty();
+    for (size_t i = 1; i < training_workspace.layers_count; ++i) {
+        training_workspace.errors[i] = dr_matrix_create_filled(1, neural_network.layers[i].height, 0);
     }
-    return result;
-}
 
-static inline void dr_neural_network_details_update_E_W_next_output_layer(const dr_neural_network neural_network,
-    const DR_FLOAT_TYPE* output_errors, const dr_matrix W, dr_matrix* E, dr_matrix* W_next) {
-    const size_t last_layer_size = neural_network.layers[neural_network.layers_count - 1].height;
-    *E      = dr_matrix_create_from_array(output_errors, 1, last_layer_size);
-    *W_next = dr_matrix_unchecked_copy_create(W);
+    const size_t output_size  = dr_neural_network_unchecked_output_size(neural_network);
+    training_workspace.output = (DR_FLOAT_TYPE*)DR_MALLOC(sizeof(DR_FLOAT_TYPE) * output_size);
+    DR_ASSERT_MSG(training_workspace.output, "alloc training workspace output error");
+
+    return training_workspace;
 }
 
-static inline void dr_neural_network_details_update_E_W_next_hidden_layer(
-    const dr_matrix W, dr_matrix* E, dr_matrix* W_next) {
-    dr_matrix W_next_T = dr_matrix_unchecked_transpose_create(*W_next);
-    dr_matrix_unchecked_free(W_next);
-    const dr_matrix E_new = dr_matrix_unchecked_dot_create(W_next_T, *E);
-    dr_matrix_unchecked_free(E);
-    *E = E_new;
-    dr_matrix_unchecked_free(&W_next_T);
-    *W_next = dr_matrix_unchecked_copy_create(W);
+dr_training_workspace dr_training_workspace_create(const dr_neural_network neural_network) {
+    DR_ASSERT_MSG(dr_neural_network_valid(neural_network),
+        "attempt to create a training workspace for a not valid neural network");
+    return dr_training_workspace_unchecked_create(neural_network);
 }
 
-static inline void dr_neural_network_details_update_E_W_next(const dr_neural_network neural_network,
-    const DR_FLOAT_TYPE* output_errors, const dr_matrix W, dr_matrix* E, dr_matrix* W_next, const size_t layer_index) {
-    if (layer_index - 1 == neural_network.connections_count - 1) {
-        dr_neural_network_details_update_E_W_next_output_layer(neural_network, output_errors, W, E, W_next);
-    } else {
-        dr_neural_network_details_update_E_W_next_hidden_layer(W, E, W_next);
+bool dr_training_workspace_compatible(
+    const dr_training_workspace training_workspace, const dr_neural_network neural_network) {
+    if (!training_workspace.errors || !training_workspace.output ||
+        training_workspace.layers_count != neural_network.layers_count) {
+        return false;
+    }
+    for (size_t i = 1; i < training_workspace.layers_count; ++i) {
+        if (training_workspace.errors[i].height != neural_network.layers[i].height) {
+            return false;
+        }
     }
+    return true;
 }
 
-static inline dr_matrix dr_neural_network_details_W_delta_create(
-    const dr_neural_network neural_network, const dr_matrix E,
-    const DR_FLOAT_TYPE learning_rate, const size_t layer_index) {
-    dr_matrix AFD = dr_neural_network_details_activation_functions_derivatives_for_layer_matrix_create(
-        neural_network, layer_index);
-
-    dr_matrix AFD_mult_E = dr_matrix_unchecked_multiplication_create(AFD, E);
-    dr_matrix_unchecked_free(&AFD);
-
-    const dr_matrix O = neural_network.layers[layer_index - 1];
-    dr_matrix O_T     = dr_matrix_unchecked_transpose_create(O);
-
-    dr_matrix W_delta = dr_matrix_unchecked_dot_create(AFD_mult_E, O_T);
-    dr_matrix_unchecked_scale_write(W_delta, learning_rate, W_delta);
-    dr_matrix_unchecked_free(&AFD_mult_E);
-    dr_matrix_unchecked_free(&O_T);
-
-    return W_delta;
+void dr_training_workspace_free(dr_training_workspace* training_workspace) {
+    for (size_t i = 0; i < training_workspace->layers_count; ++i) {
+        dr_matrix_free(training_workspace->errors + i);
+    }
+    DR_FREE(training_workspace->errors);
+    training_workspace->errors       = NULL;
+    training_workspace->layers_count = 0;
+    DR_FREE(training_workspace->output);
+    training_workspace->output = NULL;
 }
 
 static inline void dr_neural_network_details_apply_W_delta(const dr_neural_network neural_network, const dr_matrix E,
     dr_matrix W, const DR_FLOAT_TYPE learning_rate, const size_t layer_index) {
-    dr_matrix W_delta = dr_neural_network_details_W_delta_create(neural_network, E, learning_rate, layer_index);
-    dr_matrix_unchecked_addition_write(W, W_delta, W);
-    dr_matrix_unchecked_free(&W_delta);
+    // W += learning_rate * (f'(O) o E) * O_prev^T as a rank-1 update done in a single pass over W,
+    // the coefficient of each row is computed on the fly, so no temporary matrices are needed
+    const dr_matrix O                 = neural_network.layers[layer_index];
+    const dr_matrix O_prev            = neural_network.layers[layer_index - 1];
+    const dr_activation_function func = neural_network.activation_functions_derivatives[layer_index - 1];
+    const dr_matrix_kernel_axpy axpy  = dr_matrix_kernels_get()->axpy;
+    for (size_t row = 0; row < W.height; ++row) {
+        const DR_FLOAT_TYPE coefficient = learning_rate * func(O.elements[row]) * E.elements[row];
+        if (coefficient != 0) {
+            axpy(coefficient, O_prev.elements, W.elements + row * W.width, W.width);
+        }
+    }
 }
 
-void dr_neural_network_unchecked_back_propagation(
-    dr_neural_network neural_network, const DR_FLOAT_TYPE learning_rate, const DR_FLOAT_TYPE* output_errors) {
-    dr_matrix E      = dr_matrix_create_empty();
-    dr_matrix W_next = dr_matrix_create_empty();
-
-    for (size_t layer_index = neural_network.layers_count - 1; layer_index > 0; --layer_index) {
-        dr_matrix W = neural_network.connections[layer_index - 1];
-        dr_neural_network_details_update_E_W_next(neural_network, output_errors, W, &E, &W_next, layer_index);
+void dr_neural_network_unchecked_back_propagation_workspace(dr_neural_network neural_network,
+    dr_training_workspace training_workspace, const DR_FLOAT_TYPE learning_rate, const DR_FLOAT_TYPE* output_errors) {
+    const size_t output_index = neural_network.layers_count - 1;
+    dr_matrix_unchecked_copy_array(training_workspace.errors[output_index], output_errors);
+
+    for (size_t layer_index = output_index; layer_index > 0; --layer_index) {
+        dr_matrix W       = neural_network.connections[layer_index - 1];
+        const dr_matrix E = training_workspace.errors[layer_index];
+        // the error of the previous layer is propagated through the weights before they are updated,
+        // so no copy of W is needed
+        if (layer_index > 1) {
+            dr_matrix_unchecked_dot_write_ex(W, true, E, false, 1, 0, training_workspace.errors[layer_index - 1]);
+        }
         dr_neural_network_details_apply_W_delta(neural_network, E, W, learning_rate, layer_index);
     }
+}
 
-    dr_matrix_unchecked_free(&E);
-    dr_matrix_unchecked_free(&W_next);
+void dr_neural_network_back_propagation_workspace(dr_neural_network neural_network,
+    dr_training_workspace training_workspace, const DR_FLOAT_TYPE learning_rate, const DR_FLOAT_TYPE* output_errors) {
+    DR_ASSERT_MSG(dr_neural_network_valid(neural_network),
+        "attempt to call a back propagation for a not valid neural network");
+    DR_ASSERT_MSG(dr_training_workspace_compatible(training_workspace, neural_network),
+        "attempt to call a back propagation with a training workspace of another neural network");
+    DR_ASSERT_MSG(output_errors, "attempt to call back_propagation for the neural network with NULL output_errors");
+    dr_neural_network_unchecked_back_propagation_workspace(
+        neural_network, training_workspace, learning_rate, output_errors);
+}
+
+void dr_neural_network_unchecked_back_propagation(
+    dr_neural_network neural_network, const DR_FLOAT_TYPE learning_rate, const DR_FLOAT_TYPE* output_errors) {
+    dr_training_workspace training_workspace = dr_training_workspace_unchecked_create(neural_network);
+    dr_neural_network_unchecked_back_propagation_workspace(
+        neural_network, training_workspace, learning_rate, output_errors);
+    dr_training_workspace_free(&training_workspace);
 }
 
 void dr_neural_network_back_propagation(
@@ -346,35 +515,229 @@ void dr_neural_network_back_propagation(
     dr_neural_network_unchecked_back_propagation(neural_network, learning_rate, output_errors);
 }
 
-void dr_neural_network_unchecked_train(
-    dr_neural_network neural_network, const DR_FLOAT_TYPE learning_rate, const size_t epochs,
+// the SGD step of train_sample after the input layer is set
+static inline DR_FLOAT_TYPE dr_neural_network_details_train_sample(dr_neural_network neural_network,
+    dr_training_workspace training_workspace, const DR_FLOAT_TYPE learning_rate, const DR_FLOAT_TYPE* train_output) {
+    const dr_matrix output = neural_network.layers[neural_network.layers_count - 1];
+    DR_FLOAT_TYPE* errors  = training_workspace.output;
+
+    dr_neural_network_unchecked_forward_propagation(neural_network);
+
+    DR_FLOAT_TYPE error_sum = 0;
+    for (size_t i = 0; i < output.height; ++i) {
+        errors[i] = train_output[i] - output.elements[i];
+        error_sum += errors[i];
+    }
+
+    dr_neural_network_unchecked_back_propagation_workspace(neural_network, training_workspace, learning_rate, errors);
+    return error_sum;
+}
+
+DR_FLOAT_TYPE dr_neural_network_unchecked_train_sample(dr_neural_network neural_network,
+    dr_training_workspace training_workspace, const DR_FLOAT_TYPE learning_rate,
+    const DR_FLOAT_TYPE* train_input, const DR_FLOAT_TYPE* train_output) {
+    dr_neural_network_unchecked_set_input(neural_network, train_input);
+    return dr_neural_network_details_train_sample(neural_network, training_workspace, learning_rate, train_output);
+}
+
+DR_FLOAT_TYPE dr_neural_network_train_sample(dr_neural_network neural_network,
+    dr_training_workspace training_workspace, const DR_FLOAT_TYPE learning_rate,
+    const DR_FLOAT_TYPE* train_input, const DR_FLOAT_TYPE* train_output) {
+    DR_ASSERT_MSG(dr_neural_network_valid(neural_network), "attempt to train a not valid neural network");
+    DR_ASSERT_MSG(dr_training_workspace_compatible(training_workspace, neural_network),
+        "attempt to train a neural network with a training workspace of another neural network");
+    DR_ASSERT_MSG(train_input, "attempt to train a neural network with a null train_input");
+    DR_ASSERT_MSG(train_output, "attempt to train a neural network with a null train_output");
+    return dr_neural_network_unchecked_train_sample(
+        neural_network, training_workspace, learning_rate, train_input, train_output);
+}
+
+DR_FLOAT_TYPE dr_neural_network_unchecked_train_sample_bytes(dr_neural_network neural_network,
+    dr_training_workspace training_workspace, const DR_FLOAT_TYPE learning_rate,
+    const unsigned char* train_input, const DR_FLOAT_TYPE input_scale, const DR_FLOAT_TYPE* train_output) {
+    dr_neural_network_unchecked_set_input_bytes(neural_network, train_input, input_scale);
+    return dr_neural_network_details_train_sample(neural_network, training_workspace, learning_rate, train_output);
+}
+
+DR_FLOAT_TYPE dr_neural_network_train_sample_bytes(dr_neural_network neural_network,
+    dr_training_workspace training_workspace, const DR_FLOAT_TYPE learning_rate,
+    const unsigned char* train_input, const DR_FLOAT_TYPE input_scale, const DR_FLOAT_TYPE* train_output) {
+    DR_ASSERT_MSG(dr_neural_network_valid(neural_network), "attempt to train a not valid neural network");
+    DR_ASSERT_MSG(dr_training_workspace_compatible(training_workspace, neural_network),
+        "attempt to train a neural network with a training workspace of another neural network");
+    DR_ASSERT_MSG(train_input, "attempt to train a neural network with a null train_input");
+    DR_ASSERT_MSG(train_output, "attempt to train a neural network with a null train_output");
+    return dr_neural_network_unchecked_train_sample_bytes(
+        neural_network, training_workspace, learning_rate, train_input, input_scale, train_output);
+}
+
+dr_batch_workspace dr_batch_workspace_unchecked_create(
+    const dr_neural_network neural_network, const size_t batch_size) {
+    dr_batch_workspace batch_workspace;
+    batch_workspace.layers_count = neural_network.layers_count;
+    batch_workspace.batch_size   = batch_size;
+
+    batch_workspace.layers = (dr_matrix*)DR_MALLOC(sizeof(dr_matrix) * batch_workspace.layers_count);
+    DR_ASSERT_MSG(batch_workspace.layers, "alloc batch workspace layers error");
+    batch_workspace.errors = (dr_matrix*)DR_MALLOC(sizeof(dr_matrix) * batch_workspace.layers_count);
+    DR_ASSERT_MSG(batch_workspace.errors, "alloc batch workspace errors error");
+
+    batch_workspace.layers[0] = dr_matrix_create_filled(batch_size, neural_network.layers[0].height, 0);
+    batch_workspace.errors[0] = dr_matrix_create_empty();
+    for (size_t i = 1; i < batch_workspace.layers_count; ++i) {
+        batch_workspace.layers[i] = dr_matrix_create_filled(batch_size, neural_network.layers[i].height, 0);
+        batch_workspace.errors[i] = dr_matrix_create_filled(batch_size, neural_network.layers[i].height, 0);
+    }
+
+    return batch_workspace;
+}
+
+dr_batch_workspace dr_batch_workspace_create(const dr_neural_network neural_network, const size_t batch_size) {
+    DR_ASSERT_MSG(dr_neural_network_valid(neural_network),
+        "attempt to create a batch workspace for a not valid neural network");
+    DR_ASSERT_MSG(batch_size > 0, "attempt to create a batch workspace with zero batch size");
+    return dr_batch_workspace_unchecked_create(neural_network, batch_size);
+}
+
+bool dr_batch_workspace_compatible(const dr_batch_workspace batch_workspace, const dr_neural_network neural_network) {
+    if (!batch_workspace.layers || !batch_workspace.errors ||
+        batch_workspace.layers_count != neural_network.layers_count) {
+        return false;
+    }
+    for (size_t i = 0; i < batch_workspace.layers_count; ++i) {
+        if (batch_workspace.layers[i].height != neural_network.layers[i].height) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void dr_batch_workspace_free(dr_batch_workspace* batch_workspace) {
+    for (size_t i = 0; i < batch_workspace->layers_count; ++i) {
+        dr_matrix_free(batch_workspace->layers + i);
+        dr_matrix_free(batch_workspace->errors + i);
+    }
+    DR_FREE(batch_workspace->layers);
+    batch_workspace->layers = NULL;
+    DR_FREE(batch_workspace->errors);
+    batch_workspace->errors       = NULL;
+    batch_workspace->layers_count = 0;
+    batch_workspace->batch_size   = 0;
+}
+
+// the first count columns of the batch matrix, the buffer is repacked for every batch,
+// so a smaller batch simply uses the beginning of it
+static inline dr_matrix dr_neural_network_details_batch_view(const dr_matrix matrix, const size_t count) {
+    dr_matrix view;
+    view.elements = matrix.elements;
+    view.width    = count;
+    view.height   = matrix.height;
+    return view;
+}
+
+static inline void dr_neural_network_details_forward_propagation_batch(
+    const dr_neural_network neural_network, const dr_batch_workspace batch_workspace, const size_t count) {
+    for (size_t i = 1; i < neural_network.layers_count; ++i) {
+        const size_t prev_index = i - 1;
+        const dr_matrix layer   = dr_neural_network_details_batch_view(batch_workspace.layers[prev_index], count);
+        dr_matrix result_layer  = dr_neural_network_details_batch_view(batch_workspace.layers[i], count);
+        dr_matrix_unchecked_dot_write(neural_network.connections[prev_index], layer, result_layer);
+        dr_neural_network_details_activate(neural_network.activation_functions[prev_index],
+            result_layer.elements, dr_matrix_unchecked_size(result_layer));
+    }
+}
+
+// writes alpha * (f'(O) o E) * O_prev^T + beta * targets[i] into targets[i] for every connection,
+// targets are either the connections themselves (the update) or the buffers of the gradients
+static inline void dr_neural_network_details_back_propagation_batch(const dr_neural_network neural_network,
+    const dr_batch_workspace batch_workspace, const size_t count,
+    const DR_FLOAT_TYPE alpha, const DR_FLOAT_TYPE beta, dr_matrix* targets) {
+    for (size_t layer_index = neural_network.layers_count - 1; layer_index > 0; --layer_index) {
+        const dr_matrix W      = neural_network.connections[layer_index - 1];
+        const dr_matrix O      = dr_neural_network_details_batch_view(batch_workspace.layers[layer_index], count);
+        const dr_matrix O_prev = dr_neural_network_details_batch_view(batch_workspace.layers[layer_index - 1], count);
+        dr_matrix E            = dr_neural_network_details_batch_view(batch_workspace.errors[layer_index], count);
+        if (layer_index > 1) {
+            dr_matrix E_prev = dr_neural_network_details_batch_view(batch_workspace.errors[layer_index - 1], count);
+            dr_matrix_unchecked_dot_write_ex(W, true, E, false, 1, 0, E_prev);
+        }
+        // E becomes f'(O) o E and E * O_prev^T sums the updates of all samples of the batch
+        const dr_activation_function derivative = neural_network.activation_functions_derivatives[layer_index - 1];
+        const size_t E_size = dr_matrix_unchecked_size(E);
+        dr_neural_network_details_multiply_by_derivative(derivative, O.elements, E.elements, E_size);
+        dr_matrix_unchecked_dot_write_ex(E, false, O_prev, true, alpha, beta, targets[layer_index - 1]);
+    }
+}
+
+// packs the inputs into the workspace, propagates them forward and writes the output errors,
+// returns the sum of the output errors
+static inline DR_FLOAT_TYPE dr_neural_network_details_forward_errors_batch(const dr_neural_network neural_network,
+    const dr_batch_workspace batch_workspace,
     const DR_FLOAT_TYPE** train_inputs, const DR_FLOAT_TYPE** train_outputs, const size_t train_count) {
-    const size_t neural_network_output_size = dr_neural_network_unchecked_output_size(neural_network);
+    const size_t output_index = neural_network.layers_count - 1;
+
+    // the inputs of the batch become the columns of the input matrix
+    const dr_matrix input = dr_neural_network_details_batch_view(batch_workspace.layers[0], train_count);
+    for (size_t row = 0; row < input.height; ++row) {
+        DR_FLOAT_TYPE* input_row = input.elements + row * train_count;
+        for (size_t sample = 0; sample < train_count; ++sample) {
+            input_row[sample] = train_inputs[sample][row];
+        }
+    }
 
-    DR_FLOAT_TYPE* errors      = (DR_FLOAT_TYPE*)DR_MALLOC(sizeof(DR_FLOAT_TYPE) * neural_network_output_size);
-    DR_ASSERT_MSG(errors, "buffer for errors alloc error, when training neural network");
-    DR_FLOAT_TYPE* real_output = (DR_FLOAT_TYPE*)DR_MALLOC(sizeof(DR_FLOAT_TYPE) * neural_network_output_size);
-    DR_ASSERT_MSG(real_output, "buffer for real output alloc error, when training neural network");
+    dr_neural_network_details_forward_propagation_batch(neural_network, batch_workspace, train_count);
 
-    for (size_t epoch = 0; epoch < epochs; ++epoch) {
-        for (size_t data_index = 0; data_index < train_count; ++data_index) {
-            const DR_FLOAT_TYPE* input         = train_inputs[data_index];
-            const DR_FLOAT_TYPE* target_output = train_outputs[data_index];
+    const dr_matrix output = dr_neural_network_details_batch_view(batch_workspace.layers[output_index], train_count);
+    const dr_matrix errors = dr_neural_network_details_batch_view(batch_workspace.errors[output_index], train_count);
+    DR_FLOAT_TYPE error_sum = 0;
+    for (size_t row = 0; row < output.height; ++row) {
+        for (size_t sample = 0; sample < train_count; ++sample) {
+            const size_t index     = row * train_count + sample;
+            errors.elements[index] = train_outputs[sample][row] - output.elements[index];
+            error_sum += errors.elements[index];
+        }
+    }
+    return error_sum;
+}
 
-            dr_neural_network_unchecked_set_input(neural_network, input);
-            dr_neural_network_unchecked_forward_propagation(neural_network);
-            dr_neural_network_unchecked_get_output(neural_network, real_output);
+DR_FLOAT_TYPE dr_neural_network_unchecked_train_batch(dr_neural_network neural_network,
+    dr_batch_workspace batch_workspace, const DR_FLOAT_TYPE learning_rate,
+    const DR_FLOAT_TYPE** train_inputs, const DR_FLOAT_TYPE** train_outputs, const size_t train_count) {
+    const DR_FLOAT_TYPE error_sum = dr_neural_network_details_forward_errors_batch(
+        neural_network, batch_workspace, train_inputs, train_outputs, train_count);
+    // the updates are averaged, so the step doesn't grow with the batch size
+    dr_neural_network_details_back_propagation_batch(
+        neural_network, batch_workspace, train_count, learning_rate / train_count, 1, neural_network.connections);
+    return error_sum;
+}
 
-            for (size_t i = 0; i < neural_network_output_size; ++i) {
-                errors[i] = target_output[i] - real_output[i];
-            }
+DR_FLOAT_TYPE dr_neural_network_train_batch(dr_neural_network neural_network,
+    dr_batch_workspace batch_workspace, const DR_FLOAT_TYPE learning_rate,
+    const DR_FLOAT_TYPE** train_inputs, const DR_FLOAT_TYPE** train_outputs, const size_t train_count) {
+    DR_ASSERT_MSG(dr_neural_network_valid(neural_network), "attempt to train a not valid neural network");
+    DR_ASSERT_MSG(dr_batch_workspace_compatible(batch_workspace, neural_network),
+        "attempt to train a neural network with a batch workspace of another neural network");
+    DR_ASSERT_MSG(train_inputs, "attempt to train a neural network with a null train_inputs");
+    DR_ASSERT_MSG(train_outputs, "attempt to train a neural network with a null train_outputs");
+    DR_ASSERT_MSG(train_count > 0 && train_count <= batch_workspace.batch_size,
+        "the number of samples to train should be in the range from 1 to the batch size of the workspace");
+    return dr_neural_network_unchecked_train_batch(
+        neural_network, batch_workspace, learning_rate, train_inputs, train_outputs, train_count);
+}
+
+void dr_neural_network_unchecked_train(
+    dr_neural_network neural_network, const DR_FLOAT_TYPE learning_rate, const size_t epochs,
+    const DR_FLOAT_TYPE** train_inputs, const DR_FLOAT_TYPE** train_outputs, const size_t train_count) {
+    dr_training_workspace training_workspace = dr_training_workspace_unchecked_create(neural_network);
 
-            dr_neural_network_unchecked_back_propagation(neural_network, learning_rate, errors);
+    for (size_t epoch = 0; epoch < epochs; ++epoch) {
+        for (size_t data_index = 0; data_index < train_count; ++data_index) {
+            dr_neural_network_unchecked_train_sample(neural_network, training_workspace, learning_rate,
+                train_inputs[data_index], train_outputs[data_index]);
         }
     }
 
-    DR_FREE(errors);
-    DR_FREE(real_output);
+    dr_training_workspace_free(&training_workspace);
 }
 
 void dr_neural_network_train(
@@ -388,6 +751,66 @@ void dr_neural_network_train(
     dr_neural_network_unchecked_train(neural_network, learning_rate, epochs, train_inputs, train_outputs, train_count);
 }
 
+DR_FLOAT_TYPE dr_neural_network_unchecked_batch_gradients_write(const dr_neural_network neural_network,
+    dr_batch_workspace batch_workspace, const DR_FLOAT_TYPE** train_inputs, const DR_FLOAT_TYPE** train_outputs,
+    const size_t train_count, dr_matrix* gradients) {
+    const DR_FLOAT_TYPE error_sum = dr_neural_network_details_forward_errors_batch(
+        neural_network, batch_workspace, train_inputs, train_outputs, train_count);
+    dr_neural_network_details_back_propagation_batch(neural_network, batch_workspace, train_count, 1, 0, gradients);
+    return error_sum;
+}
+
+DR_FLOAT_TYPE dr_neural_network_batch_gradients_write(const dr_neural_network neural_network,
+    dr_batch_workspace batch_workspace, const DR_FLOAT_TYPE** train_inputs, const DR_FLOAT_TYPE** train_outputs,
+    const size_t train_count, dr_matrix* gradients) {
+    DR_ASSERT_MSG(dr_neural_network_valid(neural_network),
+        "attempt to compute the gradients of a not valid neural network");
+    DR_ASSERT_MSG(dr_batch_workspace_compatible(batch_workspace, neural_network),
+        "attempt to compute the gradients with a batch workspace of another neural network");
+    DR_ASSERT_MSG(train_inputs, "attempt to compute the gradients with a null train_inputs");
+    DR_ASSERT_MSG(train_outputs, "attempt to compute the gradients with a null train_outputs");
+    DR_ASSERT_MSG(gradients, "attempt to write the gradients of a neural network to a NULL array");
+    DR_ASSERT_MSG(train_count > 0 && train_count <= batch_workspace.batch_size,
+        "the number of samples to train should be in the range from 1 to the batch size of the workspace");
+    for (size_t i = 0; i < neural_network.connections_count; ++i) {
+        DR_ASSERT_MSG(gradients[i].width == neural_network.connections[i].width &&
+            gradients[i].height == neural_network.connections[i].height,
+            "the sizes of the gradients should be the same as the sizes of the connections");
+    }
+    return dr_neural_network_unchecked_batch_gradients_write(
+        neural_network, batch_workspace, train_inputs, train_outputs, train_count, gradients);
+}
+
+void dr_neural_network_unchecked_train_batched(
+    dr_neural_network neural_network, const DR_FLOAT_TYPE learning_rate, const size_t epochs, const size_t batch_size,
+    const DR_FLOAT_TYPE** train_inputs, const DR_FLOAT_TYPE** train_outputs, const size_t train_count) {
+    dr_batch_workspace batch_workspace = dr_batch_workspace_unchecked_create(neural_network, batch_size);
+
+    for (size_t epoch = 0; epoch < epochs; ++epoch) {
+        for (size_t data_index = 0; data_index < train_count; data_index += batch_size) {
+            const size_t rest  = train_count - data_index;
+            const size_t count = rest < batch_size ? rest : batch_size;
+            dr_neural_network_unchecked_train_batch(neural_network, batch_workspace, learning_rate,
+                train_inputs + data_index, train_outputs + data_index, count);
+        }
+    }
+
+    dr_batch_workspace_free(&batch_workspace);
+}
+
+void dr_neural_network_train_batched(
+    dr_neural_network neural_network, const DR_FLOAT_TYPE learning_rate, const size_t epochs, const size_t batch_size,
+    const DR_FLOAT_TYPE** train_inputs, const DR_FLOAT_TYPE** train_outputs, const size_t train_count) {
+    DR_ASSERT_MSG(dr_neural_network_valid(neural_network), "attempt to train a not valid neural network");
+    DR_ASSERT_MSG(train_inputs, "attempt to train a neural network with a null train_inputs");
+    DR_ASSERT_MSG(train_outputs, "attempt to train a neural network with a null train_outputs");
+    DR_ASSERT_MSG(epochs > 0, "attempt to train a neural network with zero epochs");
+    DR_ASSERT_MSG(batch_size > 0, "attempt to train a neural network with zero batch size");
+    DR_ASSERT_MSG(train_count > 0, "attempt to train a neural network with empty train data");
+    dr_neural_network_unchecked_train_batched(
+        neural_network, learning_rate, epochs, batch_size, train_inputs, train_outputs, train_count);
+}
+
 void dr_neural_network_unchecked_prediction_write(
     const dr_neural_network neural_network, const DR_FLOAT_TYPE* input, DR_FLOAT_TYPE* prediction) {
     dr_neural_network_unchecked_set_input(neural_network, input);
@@ -408,6 +831,182 @@ void dr_neural_network_prediction_write(
     dr_neural_network_unchecked_prediction_write(neural_network, input, prediction);
 }
 
+dr_inference_context dr_inference_context_unchecked_create(const dr_neural_network neural_network) {
+    dr_inference_context inference_context;
+    inference_context.layers_count = neural_network.layers_count;
+    inference_context.layers = (dr_matrix*)DR_MALLOC(sizeof(dr_matrix) * inference_context.layers_count);
+    DR_ASSERT_MSG(inference_context.layers, "alloc inference context layers error");
+    for (size_t i = 0; i < inference_context.layers_count; ++i) {
+        inference_context.layers[i] = dr_matrix_create_filled(1, neural_network.layers[i].height, 0);
+    }
+    return inference_context;
+}
+
+dr_inference_context dr_inference_context_create(const dr_neural_network neural_network) {
+    DR_ASSERT_MSG(dr_neural_network_valid(neural_network),
+        "attempt to create an inference context for a not valid neural network");
+    return dr_inference_context_unchecked_create(neural_network);
+}
+
+bool dr_inference_context_compatible(
+    const dr_inference_context inference_context, const dr_neural_network neural_network) {
+    if (!inference_context.layers || inference_context.layers_count != neural_network.layers_count) {
+        return false;
+    }
+    for (size_t i = 0; i < inference_context.layers_count; ++i) {
+        if (inference_context.layers[i].height != neural_network.layers[i].height) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void dr_inference_context_free(dr_inference_context* inference_context) {
+    for (size_t i = 0; i < inference_context->layers_count; ++i) {
+        dr_matrix_free(inference_context->layers + i);
+    }
+    DR_FREE(inference_context->layers);
+    inference_context->layers       = NULL;
+    inference_context->layers_count = 0;
+}
+
+void dr_neural_network_unchecked_prediction_write_context(const dr_neural_network neural_network,
+    dr_inference_context inference_context, const DR_FLOAT_TYPE* input, DR_FLOAT_TYPE* prediction) {
+    dr_matrix_unchecked_copy_array(inference_context.layers[0], input);
+    dr_neural_network_details_forward_propagation(neural_network, inference_context.layers);
+    dr_matrix_unchecked_copy_to_array(inference_context.layers[inference_context.layers_count - 1], prediction);
+}
+
+void dr_neural_network_prediction_write_context(const dr_neural_network neural_network,
+    dr_inference_context inference_context, const DR_FLOAT_TYPE* input, DR_FLOAT_TYPE* prediction) {
+    DR_ASSERT_MSG(dr_neural_network_valid(neural_network),
+        "attempt to write a prediction with a not valid neural network");
+    DR_ASSERT_MSG(dr_inference_context_compatible(inference_context, neural_network),
+        "attempt to write a prediction with an inference context of another neural network");
+    DR_ASSERT_MSG(input, "attempt to write a neural network prediction with a NULL input");
+    DR_ASSERT_MSG(prediction, "attempt to write a neural network prediction to a NULL array");
+    dr_neural_network_unchecked_prediction_write_context(neural_network, inference_context, input, prediction);
+}
+
+void dr_neural_network_unchecked_predict_batch(const dr_neural_network neural_network,
+    const DR_FLOAT_TYPE* inputs, const size_t count, DR_FLOAT_TYPE* outputs) {
+    // the empty parts of a parallel prediction get here too, they must not allocate zero bytes
+    if (count == 0) {
+        return;
+    }
+    const size_t input_size  = dr_neural_network_unchecked_input_size(neural_network);
+    const size_t output_size = dr_neural_network_unchecked_output_size(neural_network);
+    const size_t chunk_size  =
+        count < DR_NEURAL_NETWORK_PREDICT_BATCH_CHUNK ? count : DR_NEURAL_NETWORK_PREDICT_BATCH_CHUNK;
+
+    size_t hidden_size = 0;
+    for (size_t i = 1; i + 1 < neural_network.layers_count; ++i) {
+        if (neural_network.layers[i].height > hidden_size) {
+            hidden_size = neural_network.layers[i].height;
+        }
+    }
+
+    // the hidden layers of a chunk alternate between two buffers
+    DR_FLOAT_TYPE* buffers[2] = { NULL, NULL };
+    if (hidden_size > 0) {
+        for (size_t i = 0; i < DR_ARRAY_LENGTH(buffers); ++i) {
+            buffers[i] = (DR_FLOAT_TYPE*)DR_MALLOC(sizeof(DR_FLOAT_TYPE) * chunk_size * hidden_size);
+            DR_ASSERT_MSG(buffers[i], "alloc buffer for the batch prediction error");
+        }
+    }
+
+    // a chunk is a count x size matrix with a sample in every row, so the inputs and the outputs are used in place
+    // and every layer is computed as X * W^T
+    for (size_t begin = 0; begin < count; begin += chunk_size) {
+        const size_t rest = count - begin;
+        const size_t rows = rest < chunk_size ? rest : chunk_size;
+
+        dr_matrix layer;
+        layer.elements = (DR_FLOAT_TYPE*)(inputs + begin * input_size);
+        layer.width    = input_size;
+        layer.height   = rows;
+        for (size_t i = 1; i < neural_network.layers_count; ++i) {
+            const bool output_layer = i + 1 == neural_network.layers_count;
+            dr_matrix result_layer;
+            result_layer.elements = output_layer ? outputs + begin * output_size : buffers[i % 2];
+            result_layer.width    = neural_network.layers[i].height;
+            result_layer.height   = rows;
+            dr_matrix_unchecked_dot_write_ex(layer, false, neural_network.connections[i - 1], true, 1, 0, result_layer);
+            dr_neural_network_details_activate(neural_network.activation_functions[i - 1],
+                result_layer.elements, dr_matrix_unchecked_size(result_layer));
+            layer = result_layer;
+        }
+    }
+
+    DR_FREE(buffers[0]);
+    DR_FREE(buffers[1]);
+}
+
+void dr_neural_network_predict_batch(const dr_neural_network neural_network,
+    const DR_FLOAT_TYPE* inputs, const size_t count, DR_FLOAT_TYPE* outputs) {
+    DR_ASSERT_MSG(dr_neural_network_valid(neural_network),
+        "attempt to predict a batch with a not valid neural network");
+    DR_ASSERT_MSG(inputs, "attempt to predict a batch with NULL inputs");
+    DR_ASSERT_MSG(outputs, "attempt to write the predictions of a batch to a NULL array");
+    dr_neural_network_unchecked_predict_batch(neural_network, inputs, count, outputs);
+}
+
+typedef struct {
+    const dr_neural_network* neural_network;
+    const DR_FLOAT_TYPE* inputs;
+    size_t count;
+    DR_FLOAT_TYPE* outputs;
+    size_t parts_count;
+} dr_neural_network_details_predict_batch_parts;
+
+static void dr_neural_network_details_predict_batch_parts_run(void* data, const size_t begin, const size_t end) {
+    const dr_neural_network_details_predict_batch_parts* parts =
+        (const dr_neural_network_details_predict_batch_parts*)data;
+    const size_t input_size  = dr_neural_network_unchecked_input_size(*parts->neural_network);
+    const size_t output_size = dr_neural_network_unchecked_output_size(*parts->neural_network);
+    for (size_t i = begin; i < end; ++i) {
+        const size_t part_begin = parts->count * i / parts->parts_count;
+        const size_t part_end   = parts->count * (i + 1) / parts->parts_count;
+        dr_neural_network_unchecked_predict_batch(*parts->neural_network, parts->inputs + part_begin * input_size,
+            part_end - part_begin, parts->outputs + part_begin * output_size);
+    }
+}
+
+void dr_neural_network_unchecked_predict_batch_parallel(const dr_neural_network neural_network,
+    const DR_FLOAT_TYPE* inputs, const size_t count, DR_FLOAT_TYPE* outputs,
+    const size_t threads_count, dr_prediction_stats* stats) {
+    const double begin_time = dr_time_seconds();
+
+    // the parts and the GEMMs inside them run on the default scheduler, the calling thread takes its share as well
+    dr_neural_network_details_predict_batch_parts parts;
+    parts.neural_network = &neural_network;
+    parts.inputs         = inputs;
+    parts.count          = count;
+    parts.outputs        = outputs;
+    parts.parts_count    = threads_count;
+    dr_parallel_unchecked_for(dr_parallel_scheduler_get_default(), 0, threads_count, 1,
+        dr_neural_network_details_predict_batch_parts_run, &parts);
+
+    if (stats) {
+        stats->images_count      = count;
+        stats->threads_count     = threads_count;
+        stats->seconds           = dr_time_seconds() - begin_time;
+        stats->images_per_second = stats->seconds > 0 ? count / stats->seconds : 0;
+    }
+}
+
+void dr_neural_network_predict_batch_parallel(const dr_neural_network neural_network,
+    const DR_FLOAT_TYPE* inputs, const size_t count, DR_FLOAT_TYPE* outputs,
+    const size_t threads_count, dr_prediction_stats* stats) {
+    DR_ASSERT_MSG(dr_neural_network_valid(neural_network),
+        "attempt to predict a batch with a not valid neural network");
+    DR_ASSERT_MSG(inputs, "attempt to predict a batch with NULL inputs");
+    DR_ASSERT_MSG(outputs, "attempt to write the predictions of a batch to a NULL array");
+    DR_ASSERT_MSG(threads_count > 0, "attempt to predict a batch with zero threads");
+    dr_neural_network_unchecked_predict_batch_parallel(
+        neural_network, inputs, count, outputs, threads_count, stats);
+}
+
 DR_FLOAT_TYPE* dr_neural_network_unchecked_prediction_create(
     const dr_neural_network neural_network, const DR_FLOAT_TYPE* input) {
     const size_t output_size = dr_neural_network_output_size(neural_network);
@@ -580,6 +1179,340 @@ dr_neural_network dr_neural_network_load_from_file(const char* file_path) {
         dr_default_activation_function_from_string, dr_default_activation_function_derivative_from_string, file_path);
 }
 
+// magic, version, element size and layers count
+#define DR_NEURAL_NETWORK_DETAILS_BINARY_PREFIX_SIZE 16
+// a sanity limit, so a corrupted header doesn't make the loader allocate arbitrary amounts of memory
+#define DR_NEURAL_NETWORK_DETAILS_BINARY_MAX_LAYERS_COUNT 4096
+
+static inline bool dr_neural_network_details_little_endian() {
+    const uint16_t value = 1;
+    return *(const uint8_t*)&value == 1;
+}
+
+static inline void dr_neural_network_details_write_u32(uint8_t* bytes, const uint32_t value) {
+    bytes[0] = (uint8_t)(value & 0xFF);
+    bytes[1] = (uint8_t)((value >> 8) & 0xFF);
+    bytes[2] = (uint8_t)((value >> 16) & 0xFF);
+    bytes[3] = (uint8_t)((value >> 24) & 0xFF);
+}
+
+static inline uint32_t dr_neural_network_details_read_u32(const uint8_t* bytes) {
+    return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+static inline void dr_neural_network_details_swap_bytes(DR_FLOAT_TYPE* elements, const size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        uint8_t* bytes = (uint8_t*)(elements + i);
+        for (size_t j = 0; j < sizeof(DR_FLOAT_TYPE) / 2; ++j) {
+            const uint8_t temp                   = bytes[j];
+            bytes[j]                             = bytes[sizeof(DR_FLOAT_TYPE) - 1 - j];
+            bytes[sizeof(DR_FLOAT_TYPE) - 1 - j] = temp;
+        }
+    }
+}
+
+static inline size_t dr_neural_network_details_binary_align(const size_t offset) {
+    return (offset + DR_NEURAL_NETWORK_BINARY_ALIGNMENT - 1) / DR_NEURAL_NETWORK_BINARY_ALIGNMENT *
+        DR_NEURAL_NETWORK_BINARY_ALIGNMENT;
+}
+
+static inline size_t dr_neural_network_details_binary_header_size(const size_t layers_count) {
+    return DR_NEURAL_NETWORK_DETAILS_BINARY_PREFIX_SIZE + 4 * layers_count + 2 * 4 * (layers_count - 1);
+}
+
+bool dr_neural_network_save_to_binary_file(const dr_neural_network neural_network, const char* file_path) {
+    DR_ASSERT_MSG(dr_neural_network_valid(neural_network),
+        "attempt to save the not valid neural network to the binary file");
+    DR_ASSERT_MSG(file_path, "attempt to save the neural network to the binary file with NULL file_path");
+
+    const size_t header_size = dr_neural_network_details_binary_header_size(neural_network.layers_count);
+    uint8_t* header = (uint8_t*)DR_MALLOC(header_size);
+    DR_ASSERT_MSG(header, "alloc header error when saving the neural network to the binary file");
+
+    memcpy(header, DR_NEURAL_NETWORK_BINARY_MAGIC, 4);
+    dr_neural_network_details_write_u32(header + 4, DR_NEURAL_NETWORK_BINARY_VERSION);
+    dr_neural_network_details_write_u32(header + 8, sizeof(DR_FLOAT_TYPE));
+    dr_neural_network_details_write_u32(header + 12, (uint32_t)neural_network.layers_count);
+    uint8_t* position = header + DR_NEURAL_NETWORK_DETAILS_BINARY_PREFIX_SIZE;
+    for (size_t i = 0; i < neural_network.layers_count; ++i, position += 4) {
+        dr_neural_network_details_write_u32(position, (uint32_t)neural_network.layers[i].height);
+    }
+    for (size_t i = 0; i < neural_network.connections_count; ++i, position += 8) {
+        const dr_activation_function_id activation_function_id =
+            dr_default_activation_function_to_id(neural_network.activation_functions[i]);
+        const dr_activation_function_id activation_function_derivative_id =
+            dr_default_activation_function_to_id(neural_network.activation_functions_derivatives[i]);
+        if (activation_function_id == dr_activation_function_id_none ||
+            activation_function_derivative_id == dr_activation_function_id_none) {
+            DR_FREE(header);
+            return false;
+        }
+        dr_neural_network_details_write_u32(position, activation_function_id);
+        dr_neural_network_details_write_u32(position + 4, activation_function_derivative_id);
+    }
+
+    FILE* file = fopen(file_path, "wb");
+    if (!file) {
+        DR_FREE(header);
+        return false;
+    }
+
+    bool result = fwrite(header, 1, header_size, file) == header_size;
+    DR_FREE(header);
+
+    const uint8_t padding[DR_NEURAL_NETWORK_BINARY_ALIGNMENT] = { 0 };
+    size_t offset = header_size;
+    const bool little_endian = dr_neural_network_details_little_endian();
+    for (size_t i = 0; i < neural_network.connections_count && result; ++i) {
+        const size_t padding_size = dr_neural_network_details_binary_align(offset) - offset;
+        result = fwrite(padding, 1, padding_size, file) == padding_size;
+
+        const dr_matrix connection = neural_network.connections[i];
+        const size_t size          = dr_matrix_unchecked_size(connection);
+        if (little_endian) {
+            result = result && fwrite(connection.elements, sizeof(DR_FLOAT_TYPE), size, file) == size;
+        } else {
+            for (size_t j = 0; j < size && result; ++j) {
+                DR_FLOAT_TYPE element = connection.elements[j];
+                dr_neural_network_details_swap_bytes(&element, 1);
+                result = fwrite(&element, sizeof(DR_FLOAT_TYPE), 1, file) == 1;
+            }
+        }
+        offset += padding_size + size * sizeof(DR_FLOAT_TYPE);
+    }
+
+    return fclose(file) == 0 && result;
+}
+
+// checks the magic, the version, the element size and the layers count of the first
+// DR_NEURAL_NETWORK_DETAILS_BINARY_PREFIX_SIZE bytes of a binary file
+static inline bool dr_neural_network_details_binary_prefix_parse(const uint8_t* prefix, size_t* layers_count) {
+    if (memcmp(prefix, DR_NEURAL_NETWORK_BINARY_MAGIC, 4) != 0 ||
+        dr_neural_network_details_read_u32(prefix + 4) != DR_NEURAL_NETWORK_BINARY_VERSION ||
+        dr_neural_network_details_read_u32(prefix + 8) != sizeof(DR_FLOAT_TYPE)) {
+        return false;
+    }
+    *layers_count = dr_neural_network_details_read_u32(prefix + 12);
+    return *layers_count >= 2 && *layers_count <= DR_NEURAL_NETWORK_DETAILS_BINARY_MAX_LAYERS_COUNT;
+}
+
+// parses the layers sizes and the activation functions that follow the prefix,
+// activation_functions receives the activation functions followed by their derivatives
+static inline bool dr_neural_network_details_binary_header_parse(const uint8_t* header, const size_t layers_count,
+    size_t* layers_sizes, dr_activation_function* activation_functions) {
+    const uint8_t* position = header;
+    for (size_t i = 0; i < layers_count; ++i, position += 4) {
+        layers_sizes[i] = dr_neural_network_details_read_u32(position);
+        if (layers_sizes[i] == 0) {
+            return false;
+        }
+    }
+    const size_t connections_count = layers_count - 1;
+    for (size_t i = 0; i < connections_count; ++i, position += 8) {
+        activation_functions[i] = dr_default_activation_function_from_id(
+            (dr_activation_function_id)dr_neural_network_details_read_u32(position));
+        activation_functions[connections_count + i] = dr_default_activation_function_from_id(
+            (dr_activation_function_id)dr_neural_network_details_read_u32(position + 4));
+        if (!activation_functions[i] || !activation_functions[connections_count + i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// the offset of every connection is written to connections_offsets and the size of the whole file to file_size,
+// returns false if the sizes of the header don't fit in size_t (a crafted header could wrap them around otherwise)
+static inline bool dr_neural_network_details_binary_layout(
+    const size_t* layers_sizes, const size_t layers_count, size_t* connections_offsets, size_t* file_size) {
+    size_t offset = dr_neural_network_details_binary_header_size(layers_count);
+    for (size_t i = 0; i + 1 < layers_count; ++i) {
+        if (offset > SIZE_MAX - (DR_NEURAL_NETWORK_BINARY_ALIGNMENT - 1)) {
+            return false;
+        }
+        offset = dr_neural_network_details_binary_align(offset);
+        connections_offsets[i] = offset;
+        if (layers_sizes[i + 1] > SIZE_MAX / sizeof(DR_FLOAT_TYPE) / layers_sizes[i]) {
+            return false;
+        }
+        const size_t connection_size = layers_sizes[i] * layers_sizes[i + 1] * sizeof(DR_FLOAT_TYPE);
+        if (connection_size > SIZE_MAX - offset) {
+            return false;
+        }
+        offset += connection_size;
+    }
+    *file_size = offset;
+    return true;
+}
+
+dr_neural_network dr_neural_network_load_from_binary_file(const char* file_path) {
+    DR_ASSERT_MSG(file_path, "attempt to load a neural network from a binary file with NULL file_path");
+
+    dr_neural_network neural_network = { 0 };
+
+    FILE* file = fopen(file_path, "rb");
+    if (!file) {
+        return neural_network;
+    }
+
+    uint8_t prefix[DR_NEURAL_NETWORK_DETAILS_BINARY_PREFIX_SIZE] = { 0 };
+    size_t layers_count = 0;
+    if (fread(prefix, 1, sizeof(prefix), file) != sizeof(prefix) ||
+        !dr_neural_network_details_binary_prefix_parse(prefix, &layers_count)) {
+        fclose(file);
+        return neural_network;
+    }
+
+    const size_t rest_size = dr_neural_network_details_binary_header_size(layers_count) - sizeof(prefix);
+    uint8_t* header = (uint8_t*)DR_MALLOC(rest_size);
+    DR_ASSERT_MSG(header, "alloc header error when loading the neural network from the binary file");
+    size_t* layers_sizes = (size_t*)DR_MALLOC(sizeof(size_t) * (2 * layers_count - 1));
+    DR_ASSERT_MSG(layers_sizes, "alloc layers sizes error when loading the neural network from the binary file");
+    size_t* connections_offsets = layers_sizes + layers_count;
+    dr_activation_function* activation_functions =
+        (dr_activation_function*)DR_MALLOC(sizeof(dr_activation_function) * 2 * (layers_count - 1));
+    DR_ASSERT_MSG(activation_functions,
+        "alloc activation functions error when loading the neural network from the binary file");
+
+    const bool header_valid = fread(header, 1, rest_size, file) == rest_size &&
+        dr_neural_network_details_binary_header_parse(header, layers_count, layers_sizes, activation_functions);
+    DR_FREE(header);
+
+    // the file must contain all the weights the header describes before anything is allocated for them,
+    // the offsets are passed to fseek as long, so the files beyond LONG_MAX bytes are rejected
+    // (ftell fails for them anyway where long is 32 bits)
+    long file_size = -1;
+    if (header_valid && fseek(file, 0, SEEK_END) == 0) {
+        file_size = ftell(file);
+    }
+    size_t layout_size = 0;
+    if (!header_valid || file_size < 0 ||
+        !dr_neural_network_details_binary_layout(layers_sizes, layers_count, connections_offsets, &layout_size) ||
+        layout_size > LONG_MAX || (size_t)file_size < layout_size) {
+        DR_FREE(layers_sizes);
+        DR_FREE(activation_functions);
+        fclose(file);
+        return neural_network;
+    }
+
+    neural_network = dr_neural_network_create(
+        layers_sizes, layers_count, activation_functions, activation_functions + layers_count - 1);
+    DR_FREE(activation_functions);
+
+    bool result = true;
+    for (size_t i = 0; i < neural_network.connections_count && result; ++i) {
+        const dr_matrix connection = neural_network.connections[i];
+        const size_t size          = dr_matrix_unchecked_size(connection);
+        result = fseek(file, (long)connections_offsets[i], SEEK_SET) == 0 &&
+            fread(connection.elements, sizeof(DR_FLOAT_TYPE), size, file) == size;
+    }
+    DR_FREE(layers_sizes);
+    fclose(file);
+
+    if (!result) {
+        dr_neural_network_free(&neural_network);
+        return neural_network;
+    }
+
+    if (!dr_neural_network_details_little_endian()) {
+        for (size_t i = 0; i < neural_network.connections_count; ++i) {
+            dr_neural_network_details_swap_bytes(
+                neural_network.connections[i].elements, dr_matrix_unchecked_size(neural_network.connections[i]));
+        }
+    }
+
+    return neural_network;
+}
+
+dr_neural_network dr_neural_network_load_mmap(const char* file_path) {
+    DR_ASSERT_MSG(file_path, "attempt to map a neural network from a file with NULL file_path");
+
+    // the weights are used in place, so they must have the byte order of the CPU
+    if (!dr_neural_network_details_little_endian()) {
+        return dr_neural_network_load_from_binary_file(file_path);
+    }
+
+    dr_neural_network neural_network = { 0 };
+
+    dr_file_mapping* mapping = (dr_file_mapping*)DR_MALLOC(sizeof(dr_file_mapping));
+    DR_ASSERT_MSG(mapping, "alloc file mapping error when mapping the neural network");
+    if (!dr_file_mapping_open(mapping, file_path)) {
+        DR_FREE(mapping);
+        return neural_network;
+    }
+
+    const uint8_t* data = (const uint8_t*)mapping->data;
+    size_t layers_count = 0;
+    if (mapping->size < DR_NEURAL_NETWORK_DETAILS_BINARY_PREFIX_SIZE ||
+        !dr_neural_network_details_binary_prefix_parse(data, &layers_count) ||
+        mapping->size < dr_neural_network_details_binary_header_size(layers_count)) {
+        dr_file_mapping_close(mapping);
+        DR_FREE(mapping);
+        return neural_network;
+    }
+
+    size_t* layers_sizes = (size_t*)DR_MALLOC(sizeof(size_t) * (2 * layers_count - 1));
+    DR_ASSERT_MSG(layers_sizes, "alloc layers sizes error when mapping the neural network");
+    size_t* connections_offsets = layers_sizes + layers_count;
+    dr_activation_function* activation_functions =
+        (dr_activation_function*)DR_MALLOC(sizeof(dr_activation_function) * 2 * (layers_count - 1));
+    DR_ASSERT_MSG(activation_functions, "alloc activation functions error when mapping the neural network");
+
+    size_t layout_size = 0;
+    if (!dr_neural_network_details_binary_header_parse(data + DR_NEURAL_NETWORK_DETAILS_BINARY_PREFIX_SIZE,
+            layers_count, layers_sizes, activation_functions) ||
+        !dr_neural_network_details_binary_layout(layers_sizes, layers_count, connections_offsets, &layout_size) ||
+        mapping->size < layout_size) {
+        DR_FREE(layers_sizes);
+        DR_FREE(activation_functions);
+        dr_file_mapping_close(mapping);
+        DR_FREE(mapping);
+        return neural_network;
+    }
+
+    neural_network.layers_count      = layers_count;
+    neural_network.connections_count = layers_count - 1;
+    neural_network.mapping           = mapping;
+
+    // only the activation functions and the layers are allocated, the connections point into the mapping
+    neural_network.activation_functions = activation_functions;
+    neural_network.activation_functions_derivatives =
+        (dr_activation_function*)DR_MALLOC(sizeof(dr_activation_function) * neural_network.connections_count);
+    DR_ASSERT_MSG(neural_network.activation_functions_derivatives,
+        "alloc activation functions derivatives error when mapping the neural network");
+    memcpy(neural_network.activation_functions_derivatives, activation_functions + neural_network.connections_count,
+        sizeof(dr_activation_function) * neural_network.connections_count);
+
+    neural_network.layers = (dr_matrix*)DR_MALLOC(sizeof(dr_matrix) * neural_network.layers_count);
+    DR_ASSERT_MSG(neural_network.layers, "alloc layers error when mapping the neural network");
+    neural_network.connections = (dr_matrix*)DR_MALLOC(sizeof(dr_matrix) * neural_network.connections_count);
+    DR_ASSERT_MSG(neural_network.connections, "alloc connections error when mapping the neural network");
+
+    neural_network.layers[0] = dr_matrix_create_filled(1, layers_sizes[0], 0);
+    for (size_t i = 0; i < neural_network.connections_count; ++i) {
+        dr_matrix* connection = neural_network.connections + i;
+        connection->elements  = (DR_FLOAT_TYPE*)(data + connections_offsets[i]);
+        connection->width     = layers_sizes[i];
+        connection->height    = layers_sizes[i + 1];
+        neural_network.layers[i + 1] = dr_matrix_create_filled(1, layers_sizes[i + 1], 0);
+    }
+    DR_FREE(layers_sizes);
+
+    return neural_network;
+}
+
+bool dr_neural_network_convert_text_file_to_binary_file(const char* text_file_path, const char* binary_file_path) {
+    DR_ASSERT_MSG(text_file_path, "attempt to convert a neural network with NULL text_file_path");
+    DR_ASSERT_MSG(binary_file_path, "attempt to convert a neural network with NULL binary_file_path");
+
+    dr_neural_network neural_network = dr_neural_network_load_from_file(text_file_path);
+    if (!dr_neural_network_valid(neural_network)) {
+        return false;
+    }
+    const bool result = dr_neural_network_save_to_binary_file(neural_network, binary_file_path);
+    dr_neural_network_free(&neural_network);
+    return result;
+}
+
 void dr_neural_network_print(const dr_neural_network neural_network) {
     DR_ASSERT_MSG(dr_neural_network_valid(neural_network), "attempt to print the not valid neural netowrk");
 
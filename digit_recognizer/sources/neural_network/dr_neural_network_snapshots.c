@@ -0,0 +1,90 @@
+#include <neural_network/dr_neural_network_snapshots.h>
+#include <general/dr_time.h>
+
+static inline bool dr_neural_network_snapshots_details_same_topology(
+    const dr_neural_network left, const dr_neural_network right) {
+    if (left.connections_count != right.connections_count) {
+        return false;
+    }
+    for (size_t i = 0; i < left.connections_count; ++i) {
+        if (left.connections[i].width != right.connections[i].width ||
+            left.connections[i].height != right.connections[i].height) {
+            return false;
+        }
+    }
+    return true;
+}
+
+dr_neural_network_snapshots* dr_neural_network_snapshots_unchecked_create(
+    const dr_neural_network neural_network, const double publish_interval) {
+    dr_neural_network_snapshots* snapshots =
+        (dr_neural_network_snapshots*)DR_MALLOC(sizeof(dr_neural_network_snapshots));
+    DR_ASSERT_MSG(snapshots, "alloc neural network snapshots error");
+    for (size_t i = 0; i < DR_NEURAL_NETWORK_SNAPSHOTS_COUNT; ++i) {
+        snapshots->snapshots[i] = dr_neural_network_unchecked_copy_create(neural_network);
+    }
+    snapshots->back_index        = 0;
+    snapshots->shared            = 1;
+    snapshots->front_index       = 2;
+    snapshots->publish_interval  = publish_interval;
+    snapshots->last_publish_time = dr_time_seconds() - publish_interval; // <- the first snapshot goes at once
+    return snapshots;
+}
+
+dr_neural_network_snapshots* dr_neural_network_snapshots_create(
+    const dr_neural_network neural_network, const double publish_interval) {
+    DR_ASSERT_MSG(dr_neural_network_valid(neural_network),
+        "attempt to create the snapshots of a not valid neural network");
+    DR_ASSERT_MSG(publish_interval >= 0, "attempt to create the neural network snapshots with a negative interval");
+    return dr_neural_network_snapshots_unchecked_create(neural_network, publish_interval);
+}
+
+void dr_neural_network_snapshots_free(dr_neural_network_snapshots* snapshots) {
+    if (!snapshots) {
+        return;
+    }
+    for (size_t i = 0; i < DR_NEURAL_NETWORK_SNAPSHOTS_COUNT; ++i) {
+        dr_neural_network_free(snapshots->snapshots + i);
+    }
+    DR_FREE(snapshots);
+}
+
+void dr_neural_network_snapshots_unchecked_publish(
+    dr_neural_network_snapshots* snapshots, const dr_neural_network neural_network) {
+    const dr_neural_network back = snapshots->snapshots[snapshots->back_index];
+    for (size_t i = 0; i < neural_network.connections_count; ++i) {
+        dr_matrix_unchecked_copy_write(neural_network.connections[i], back.connections[i]);
+    }
+    // the exchange publishes the copied weights, the reader may take the previous shared snapshot
+    // or give back its front one, either way the writer gets a snapshot nobody reads
+    const size_t previous_shared = dr_atomic_exchange(
+        &snapshots->shared, snapshots->back_index | DR_NEURAL_NETWORK_SNAPSHOTS_FRESH);
+    snapshots->back_index        = previous_shared & ~DR_NEURAL_NETWORK_SNAPSHOTS_FRESH;
+    snapshots->last_publish_time = dr_time_seconds();
+}
+
+void dr_neural_network_snapshots_publish(
+    dr_neural_network_snapshots* snapshots, const dr_neural_network neural_network) {
+    DR_ASSERT_MSG(snapshots, "attempt to publish the weights to NULL snapshots");
+    DR_ASSERT_MSG(dr_neural_network_valid(neural_network), "attempt to publish a not valid neural network");
+    DR_ASSERT_MSG(dr_neural_network_snapshots_details_same_topology(neural_network, snapshots->snapshots[0]),
+        "attempt to publish a neural network of another topology to the snapshots");
+    dr_neural_network_snapshots_unchecked_publish(snapshots, neural_network);
+}
+
+bool dr_neural_network_snapshots_publish_throttled(
+    dr_neural_network_snapshots* snapshots, const dr_neural_network neural_network) {
+    if (dr_time_seconds() - snapshots->last_publish_time < snapshots->publish_interval) {
+        return false;
+    }
+    dr_neural_network_snapshots_publish(snapshots, neural_network);
+    return true;
+}
+
+dr_neural_network dr_neural_network_snapshots_acquire(dr_neural_network_snapshots* snapshots) {
+    if (dr_atomic_load_acquire(&snapshots->shared) & DR_NEURAL_NETWORK_SNAPSHOTS_FRESH) {
+        const size_t previous_shared = dr_atomic_exchange(&snapshots->shared, snapshots->front_index);
+        snapshots->front_index = previous_shared & ~DR_NEURAL_NETWORK_SNAPSHOTS_FRESH;
+    }
+    return snapshots->snapshots[snapshots->front_index];
+}
\ No newline at end of file
@@ -0,0 +1,225 @@
+#include <neural_network/dr_trainer.h>
+#include <neural_network/dr_matrix_kernels.h>
+
+// the rows of a connection summed and updated by a single task
+#define DR_TRAINER_APPLY_MIN_ELEMENTS 4096
+
+static void dr_trainer_details_gradients(void* data, const size_t begin, const size_t end) {
+    dr_trainer* trainer = (dr_trainer*)data;
+    for (size_t index = begin; index < end; ++index) {
+        const size_t sample_begin = trainer->train_count * index / trainer->threads_count;
+        const size_t sample_end   = trainer->train_count * (index + 1) / trainer->threads_count;
+        if (sample_begin < sample_end) {
+            trainer->errors[index] = dr_neural_network_unchecked_batch_gradients_write(trainer->neural_network,
+                trainer->workspaces[index], trainer->train_inputs + sample_begin,
+                trainer->train_outputs + sample_begin, sample_end - sample_begin, trainer->gradients[index]);
+        } else {
+            // the batch is smaller than the number of parts
+            trainer->errors[index] = 0;
+            for (size_t i = 0; i < trainer->neural_network.connections_count; ++i) {
+                dr_matrix_unchecked_fill(trainer->gradients[index][i], 0);
+            }
+        }
+    }
+}
+
+typedef struct {
+    dr_trainer* trainer;
+    size_t connection;
+} dr_trainer_details_apply_data;
+
+// sums the gradients of every part into the ones of the part 0 and updates the rows of the connection
+// with their average over the batch. Pairwise tree: on the level with the stride s the part i (i % 2s == 0)
+// takes the gradients of i + s, so every sum goes through log2(threads_count) additions at most
+static void dr_trainer_details_apply(void* data, const size_t begin, const size_t end) {
+    const dr_trainer_details_apply_data* apply_data = (const dr_trainer_details_apply_data*)data;
+    const dr_trainer* trainer        = apply_data->trainer;
+    const dr_matrix_kernels* kernels = dr_matrix_kernels_get();
+    dr_matrix W                      = trainer->neural_network.connections[apply_data->connection];
+    const size_t offset              = begin * W.width;
+    const size_t elements_count      = (end - begin) * W.width;
+    for (size_t stride = 1; stride < trainer->threads_count; stride *= 2) {
+        for (size_t i = 0; i + stride < trainer->threads_count; i += 2 * stride) {
+            DR_FLOAT_TYPE* gradient = trainer->gradients[i][apply_data->connection].elements + offset;
+            const DR_FLOAT_TYPE* other_gradient =
+                trainer->gradients[i + stride][apply_data->connection].elements + offset;
+            kernels->addition(gradient, other_gradient, gradient, elements_count);
+        }
+    }
+    const DR_FLOAT_TYPE* gradient = trainer->gradients[0][apply_data->connection].elements + offset;
+    const DR_FLOAT_TYPE alpha = trainer->learning_rate / trainer->train_count;
+    kernels->axpy(alpha, gradient, W.elements + offset, elements_count);
+}
+
+static void dr_trainer_details_work_synchronous(dr_trainer* trainer) {
+    dr_parallel_scheduler* scheduler = dr_parallel_scheduler_get_default();
+    dr_parallel_unchecked_for(scheduler, 0, trainer->threads_count, 1, dr_trainer_details_gradients, trainer);
+
+    for (size_t i = 1; i < trainer->threads_count; ++i) {
+        trainer->errors[0] += trainer->errors[i];
+    }
+    for (size_t i = 0; i < trainer->neural_network.connections_count; ++i) {
+        const dr_matrix W = trainer->neural_network.connections[i];
+        dr_trainer_details_apply_data apply_data = { trainer, i };
+        const size_t grain_size = (DR_TRAINER_APPLY_MIN_ELEMENTS + W.width - 1) / W.width;
+        dr_parallel_unchecked_for(scheduler, 0, W.height, grain_size, dr_trainer_details_apply, &apply_data);
+    }
+}
+
+static void dr_trainer_details_hogwild(void* data, const size_t begin, const size_t end) {
+    dr_trainer* trainer = (dr_trainer*)data;
+    for (size_t index = begin; index < end; ++index) {
+        const size_t sample_begin = trainer->train_count * index / trainer->threads_count;
+        const size_t sample_end   = trainer->train_count * (index + 1) / trainer->threads_count;
+        // the workspace of the part holds its own activations, only the connections are shared
+        DR_FLOAT_TYPE error_sum = 0;
+        for (size_t sample = sample_begin; sample < sample_end; ++sample) {
+            error_sum += dr_neural_network_unchecked_train_batch(trainer->neural_network, trainer->workspaces[index],
+                trainer->learning_rate, trainer->train_inputs + sample, trainer->train_outputs + sample, 1);
+        }
+        trainer->errors[index] = error_sum;
+    }
+}
+
+static dr_trainer* dr_trainer_details_create(const dr_neural_network neural_network,
+    const size_t batch_size, const size_t threads_count, const dr_trainer_mode mode) {
+    dr_trainer* trainer = (dr_trainer*)DR_MALLOC(sizeof(dr_trainer));
+    DR_ASSERT_MSG(trainer, "alloc trainer error");
+    trainer->neural_network = neural_network;
+    trainer->mode           = mode;
+    trainer->threads_count  = threads_count;
+    trainer->batch_size     = batch_size;
+    trainer->learning_rate  = 0;
+    trainer->train_inputs   = NULL;
+    trainer->train_outputs  = NULL;
+    trainer->train_count    = 0;
+
+    trainer->workspaces = (dr_batch_workspace*)DR_MALLOC(sizeof(dr_batch_workspace) * threads_count);
+    DR_ASSERT_MSG(trainer->workspaces, "alloc trainer workspaces error");
+    trainer->gradients = NULL;
+    if (mode == dr_trainer_mode_synchronous) {
+        trainer->gradients = (dr_matrix**)DR_MALLOC(sizeof(dr_matrix*) * threads_count);
+        DR_ASSERT_MSG(trainer->gradients, "alloc trainer gradients error");
+    }
+    trainer->errors = (DR_FLOAT_TYPE*)DR_MALLOC(sizeof(DR_FLOAT_TYPE) * threads_count);
+    DR_ASSERT_MSG(trainer->errors, "alloc trainer errors error");
+
+    // every part gets an equal share of the batch, rounded up, the hogwild parts take a single sample at once
+    const size_t part_batch_size =
+        mode == dr_trainer_mode_hogwild ? 1 : (batch_size + threads_count - 1) / threads_count;
+    for (size_t i = 0; i < threads_count; ++i) {
+        trainer->workspaces[i] = dr_batch_workspace_unchecked_create(neural_network, part_batch_size);
+        if (trainer->gradients) {
+            trainer->gradients[i] = (dr_matrix*)DR_MALLOC(sizeof(dr_matrix) * neural_network.connections_count);
+            DR_ASSERT_MSG(trainer->gradients[i], "alloc trainer gradients error");
+            for (size_t j = 0; j < neural_network.connections_count; ++j) {
+                const dr_matrix connection = neural_network.connections[j];
+                trainer->gradients[i][j]   = dr_matrix_create_filled(connection.width, connection.height, 0);
+            }
+        }
+        trainer->errors[i] = 0;
+    }
+
+    return trainer;
+}
+
+dr_trainer* dr_trainer_unchecked_create(
+    const dr_neural_network neural_network, const size_t batch_size, const size_t threads_count) {
+    return dr_trainer_details_create(neural_network, batch_size, threads_count, dr_trainer_mode_synchronous);
+}
+
+dr_trainer* dr_trainer_create(
+    const dr_neural_network neural_network, const size_t batch_size, const size_t threads_count) {
+    DR_ASSERT_MSG(dr_neural_network_valid(neural_network),
+        "attempt to create a trainer for a not valid neural network");
+    DR_ASSERT_MSG(batch_size > 0, "attempt to create a trainer with zero batch size");
+    DR_ASSERT_MSG(threads_count > 0, "attempt to create a trainer with zero threads");
+    return dr_trainer_unchecked_create(neural_network, batch_size, threads_count);
+}
+
+dr_trainer* dr_trainer_unchecked_create_hogwild(
+    const dr_neural_network neural_network, const size_t batch_size, const size_t threads_count) {
+    return dr_trainer_details_create(neural_network, batch_size, threads_count, dr_trainer_mode_hogwild);
+}
+
+dr_trainer* dr_trainer_create_hogwild(
+    const dr_neural_network neural_network, const size_t batch_size, const size_t threads_count) {
+    DR_ASSERT_MSG(dr_neural_network_valid(neural_network),
+        "attempt to create a hogwild trainer for a not valid neural network");
+    DR_ASSERT_MSG(batch_size > 0, "attempt to create a hogwild trainer with zero batch size");
+    DR_ASSERT_MSG(threads_count > 0, "attempt to create a hogwild trainer with zero threads");
+    return dr_trainer_unchecked_create_hogwild(neural_network, batch_size, threads_count);
+}
+
+void dr_trainer_free(dr_trainer* trainer) {
+    if (!trainer) {
+        return;
+    }
+
+    for (size_t i = 0; i < trainer->threads_count; ++i) {
+        dr_batch_workspace_free(trainer->workspaces + i);
+        if (trainer->gradients) {
+            for (size_t j = 0; j < trainer->neural_network.connections_count; ++j) {
+                dr_matrix_free(trainer->gradients[i] + j);
+            }
+            DR_FREE(trainer->gradients[i]);
+        }
+    }
+    DR_FREE(trainer->workspaces);
+    DR_FREE(trainer->gradients);
+    DR_FREE(trainer->errors);
+    DR_FREE(trainer);
+}
+
+DR_FLOAT_TYPE dr_trainer_unchecked_train_batch(dr_trainer* trainer, const DR_FLOAT_TYPE learning_rate,
+    const DR_FLOAT_TYPE** train_inputs, const DR_FLOAT_TYPE** train_outputs, const size_t train_count) {
+    trainer->learning_rate = learning_rate;
+    trainer->train_inputs  = train_inputs;
+    trainer->train_outputs = train_outputs;
+    trainer->train_count   = train_count;
+
+    if (trainer->mode == dr_trainer_mode_synchronous) {
+        dr_trainer_details_work_synchronous(trainer);
+        return trainer->errors[0];
+    }
+
+    dr_parallel_unchecked_for(
+        dr_parallel_scheduler_get_default(), 0, trainer->threads_count, 1, dr_trainer_details_hogwild, trainer);
+    DR_FLOAT_TYPE error_sum = 0;
+    for (size_t i = 0; i < trainer->threads_count; ++i) {
+        error_sum += trainer->errors[i];
+    }
+    return error_sum;
+}
+
+DR_FLOAT_TYPE dr_trainer_train_batch(dr_trainer* trainer, const DR_FLOAT_TYPE learning_rate,
+    const DR_FLOAT_TYPE** train_inputs, const DR_FLOAT_TYPE** train_outputs, const size_t train_count) {
+    DR_ASSERT_MSG(trainer, "attempt to train with a NULL trainer");
+    DR_ASSERT_MSG(train_inputs, "attempt to train a neural network with a null train_inputs");
+    DR_ASSERT_MSG(train_outputs, "attempt to train a neural network with a null train_outputs");
+    DR_ASSERT_MSG(train_count > 0 && train_count <= trainer->batch_size,
+        "the number of samples to train should be in the range from 1 to the batch size of the trainer");
+    return dr_trainer_unchecked_train_batch(trainer, learning_rate, train_inputs, train_outputs, train_count);
+}
+
+void dr_trainer_unchecked_train(dr_trainer* trainer, const DR_FLOAT_TYPE learning_rate, const size_t epochs,
+    const DR_FLOAT_TYPE** train_inputs, const DR_FLOAT_TYPE** train_outputs, const size_t train_count) {
+    for (size_t epoch = 0; epoch < epochs; ++epoch) {
+        for (size_t data_index = 0; data_index < train_count; data_index += trainer->batch_size) {
+            const size_t rest  = train_count - data_index;
+            const size_t count = rest < trainer->batch_size ? rest : trainer->batch_size;
+            dr_trainer_unchecked_train_batch(
+                trainer, learning_rate, train_inputs + data_index, train_outputs + data_index, count);
+        }
+    }
+}
+
+void dr_trainer_train(dr_trainer* trainer, const DR_FLOAT_TYPE learning_rate, const size_t epochs,
+    const DR_FLOAT_TYPE** train_inputs, const DR_FLOAT_TYPE** train_outputs, const size_t train_count) {
+    DR_ASSERT_MSG(trainer, "attempt to train with a NULL trainer");
+    DR_ASSERT_MSG(train_inputs, "attempt to train a neural network with a null train_inputs");
+    DR_ASSERT_MSG(train_outputs, "attempt to train a neural network with a null train_outputs");
+    DR_ASSERT_MSG(epochs > 0, "attempt to train a neural network with zero epochs");
+    DR_ASSERT_MSG(train_count > 0, "attempt to train a neural network with empty train data");
+    dr_trainer_unchecked_train(trainer, learning_rate, epochs, train_inputs, train_outputs, train_count);
+}
\ No newline at end of file
@@ -0,0 +1,372 @@
+#include <dataset/dr_dataset_loader.h>
+#include <dataset/dr_idx.h>
+#include <general/dr_parallel.h>
+#include <general/dr_time.h>
+#include <neural_network/dr_neural_network.h>
+#include <neural_network/dr_trainer.h>
+#include <neural_network/dr_matrix_kernels.h>
+#include <ctype.h>
+#include <errno.h>
+#include <time.h>
+
+#define DR_TRAIN_IMAGE_SIZE       (28 * 28)
+#define DR_TRAIN_PIXEL_SCALE      ((DR_FLOAT_TYPE)(1.0 / 255.0))
+#define DR_TRAIN_MAX_HIDDEN_LAYERS 64
+#define DR_TRAIN_MAX_THREADS_COUNT 64 // <- the same as the limit of the graphical interface
+#define DR_TRAIN_HOGWILD_CHUNK_SIZE 1024
+
+typedef struct {
+    const char* images_file_path;
+    const char* labels_file_path;
+    size_t count;
+    const char* test_images_file_path;
+    const char* test_labels_file_path;
+    size_t test_count;
+    const char* hidden_layers;
+    DR_FLOAT_TYPE learning_rate;
+    size_t epochs_count;
+    size_t batch_size;
+    size_t threads_count;
+    bool hogwild;
+    dr_dataset_order order;
+    uint64_t seed;
+    const char* output_file_path;
+} dr_train_options;
+
+static void dr_train_print_usage(const char* program) {
+    printf("Usage: %s --images FILE --labels FILE [options]\n"
+        "Trains a neural network on the IDX (MNIST) files without the graphical interface.\n\n"
+        "  --images FILE         IDX images to train on%s\n"
+        "  --labels FILE         IDX labels of the images\n"
+        "  --count N             the number of images to load (60000)\n"
+        "  --test-images FILE    IDX images to measure the accuracy after every epoch\n"
+        "  --test-labels FILE    IDX labels of the test images\n"
+        "  --test-count N        the number of test images to load (10000)\n"
+        "  --hidden LAYERS       hidden layers, SIZE:FUNCTION separated by commas,\n"
+        "                        FUNCTION is sigmoid, tanh or relu (784:sigmoid,784:sigmoid)\n"
+        "  --learning-rate RATE  (0.01)\n"
+        "  --epochs N            (1)\n"
+        "  --batch N             the mini-batch size, not used with --hogwild (1)\n"
+        "  --threads N           the number of threads, the main one included, up to 64 (1)\n"
+        "  --hogwild             lock-free updates of the shared weights by every thread\n"
+        "  --order ORDER         sequential, shuffle or blocks (shuffle)\n"
+        "  --seed N              the seed of the shuffles (the current time)\n"
+        "  --output FILE         the trained model, the text format if FILE ends with .txt (model.bin)\n",
+        program, dr_idx_gzip_supported() ? ", can be gzip compressed" : "");
+}
+
+static bool dr_train_parse_size(const char* string, size_t* value) {
+    // strtoull accepts a minus sign and negates the result
+    const char* digits = string;
+    while (isspace((unsigned char)*digits)) {
+        ++digits;
+    }
+    if (*digits == '-') {
+        return false;
+    }
+    char* end = NULL;
+    errno = 0;
+    const unsigned long long parsed = strtoull(string, &end, 10);
+    if (end == string || *end != '\0' || errno == ERANGE || parsed > SIZE_MAX) {
+        return false;
+    }
+    *value = (size_t)parsed;
+    return true;
+}
+
+static bool dr_train_parse_learning_rate(const char* string, DR_FLOAT_TYPE* value) {
+    char* end = NULL;
+    errno = 0;
+    const DR_FLOAT_TYPE parsed = (DR_FLOAT_TYPE)strtod(string, &end);
+    // NaN fails the comparison too, the rate must also fit DR_FLOAT_TYPE
+    if (end == string || *end != '\0' || errno == ERANGE || !(parsed > 0) || !isfinite(parsed)) {
+        return false;
+    }
+    *value = parsed;
+    return true;
+}
+
+static bool dr_train_parse_options(const int argc, char** argv, dr_train_options* options) {
+    options->images_file_path      = NULL;
+    options->labels_file_path      = NULL;
+    options->count                 = 60000;
+    options->test_images_file_path = NULL;
+    options->test_labels_file_path = NULL;
+    options->test_count            = 10000;
+    options->hidden_layers         = "784:sigmoid,784:sigmoid";
+    options->learning_rate         = 0.01;
+    options->epochs_count          = 1;
+    options->batch_size            = 1;
+    options->threads_count         = 1;
+    options->hogwild               = false;
+    options->order                 = dr_dataset_order_shuffle;
+    options->seed                  = (uint64_t)time(NULL);
+    options->output_file_path      = "model.bin";
+
+    for (int i = 1; i < argc; ++i) {
+        const char* option = argv[i];
+        if (strcmp(option, "--hogwild") == 0) {
+            options->hogwild = true;
+            continue;
+        }
+        if (i + 1 == argc) {
+            dr_print_error("Unknown option or no value for %s\n", option);
+            return false;
+        }
+        const char* value = argv[++i];
+        size_t size_value = 0;
+        bool valid = true;
+        if (strcmp(option, "--images") == 0) {
+            options->images_file_path = value;
+        } else if (strcmp(option, "--labels") == 0) {
+            options->labels_file_path = value;
+        } else if (strcmp(option, "--count") == 0) {
+            valid = dr_train_parse_size(value, &options->count);
+        } else if (strcmp(option, "--test-images") == 0) {
+            options->test_images_file_path = value;
+        } else if (strcmp(option, "--test-labels") == 0) {
+            options->test_labels_file_path = value;
+        } else if (strcmp(option, "--test-count") == 0) {
+            valid = dr_train_parse_size(value, &options->test_count);
+        } else if (strcmp(option, "--hidden") == 0) {
+            options->hidden_layers = value;
+        } else if (strcmp(option, "--learning-rate") == 0) {
+            valid = dr_train_parse_learning_rate(value, &options->learning_rate);
+        } else if (strcmp(option, "--epochs") == 0) {
+            valid = dr_train_parse_size(value, &options->epochs_count) && options->epochs_count > 0;
+        } else if (strcmp(option, "--batch") == 0) {
+            valid = dr_train_parse_size(value, &options->batch_size) && options->batch_size > 0;
+        } else if (strcmp(option, "--threads") == 0) {
+            valid = dr_train_parse_size(value, &options->threads_count) && options->threads_count > 0 &&
+                options->threads_count <= DR_TRAIN_MAX_THREADS_COUNT;
+        } else if (strcmp(option, "--order") == 0) {
+            if (strcmp(value, "sequential") == 0) {
+                options->order = dr_dataset_order_sequential;
+            } else if (strcmp(value, "shuffle") == 0) {
+                options->order = dr_dataset_order_shuffle;
+            } else if (strcmp(value, "blocks") == 0) {
+                options->order = dr_dataset_order_shuffle_blocks;
+            } else {
+                valid = false;
+            }
+        } else if (strcmp(option, "--seed") == 0) {
+            valid = dr_train_parse_size(value, &size_value);
+            options->seed = size_value;
+        } else if (strcmp(option, "--output") == 0) {
+            options->output_file_path = value;
+        } else {
+            dr_print_error("Unknown option %s\n", option);
+            return false;
+        }
+        if (!valid) {
+            dr_print_error("Not correct value %s of %s\n", value, option);
+            return false;
+        }
+    }
+
+    if (!options->images_file_path || !options->labels_file_path) {
+        dr_print_error("The images and the labels to train on are required\n");
+        return false;
+    }
+    if (!options->test_images_file_path != !options->test_labels_file_path) {
+        dr_print_error("Both the test images and the test labels are required\n");
+        return false;
+    }
+    return true;
+}
+
+// "SIZE:FUNCTION,SIZE:FUNCTION", the output layer is always sigmoid
+static dr_neural_network dr_train_create_neural_network(const char* hidden_layers) {
+    size_t layers_sizes[DR_TRAIN_MAX_HIDDEN_LAYERS + 2] = { 0 };
+    dr_activation_function activation_functions[DR_TRAIN_MAX_HIDDEN_LAYERS + 1] = { 0 };
+    dr_activation_function activation_functions_derivatives[DR_TRAIN_MAX_HIDDEN_LAYERS + 1] = { 0 };
+
+    size_t layers_count = 1;
+    layers_sizes[0] = DR_TRAIN_IMAGE_SIZE;
+    const char* layer = hidden_layers;
+    while (*layer) {
+        if (layers_count > DR_TRAIN_MAX_HIDDEN_LAYERS) {
+            dr_print_error("Too many hidden layers\n");
+            return (dr_neural_network) { 0 };
+        }
+        char function[DR_STR_BUFFER_SIZE] = { 0 };
+        unsigned long long size = 0;
+        int length = 0;
+        if (sscanf(layer, "%llu:%31[a-zA-Z]%n", &size, function, &length) != 2 || size == 0) {
+            dr_print_error("Not correct hidden layer %s\n", layer);
+            return (dr_neural_network) { 0 };
+        }
+        const size_t connection = layers_count - 1;
+        if (strcmp(function, "sigmoid") == 0) {
+            activation_functions[connection]             = dr_sigmoid;
+            activation_functions_derivatives[connection] = dr_sigmoid_derivative;
+        } else if (strcmp(function, "tanh") == 0) {
+            activation_functions[connection]             = dr_tanh;
+            activation_functions_derivatives[connection] = dr_tanh_derivative;
+        } else if (strcmp(function, "relu") == 0) {
+            activation_functions[connection]             = dr_relu;
+            activation_functions_derivatives[connection] = dr_relu_derivative;
+        } else {
+            dr_print_error("Unknown activation function %s\n", function);
+            return (dr_neural_network) { 0 };
+        }
+        layers_sizes[layers_count++] = (size_t)size;
+
+        layer += length;
+        if (*layer == ',') {
+            ++layer;
+        } else if (*layer) {
+            dr_print_error("Not correct hidden layers %s\n", hidden_layers);
+            return (dr_neural_network) { 0 };
+        }
+    }
+    layers_sizes[layers_count] = DR_DATASET_LABELS_COUNT;
+    activation_functions[layers_count - 1]             = dr_sigmoid;
+    activation_functions_derivatives[layers_count - 1] = dr_sigmoid_derivative;
+    ++layers_count;
+
+    dr_neural_network neural_network = dr_neural_network_create(
+        layers_sizes, layers_count, activation_functions, activation_functions_derivatives);
+    dr_neural_network_randomize_weights(neural_network, -1, 1);
+    return neural_network;
+}
+
+// the share of the test images whose most probable digit is their label
+static double dr_train_accuracy(const dr_neural_network neural_network, const dr_dataset test_dataset,
+    DR_FLOAT_TYPE* inputs, DR_FLOAT_TYPE* outputs, const size_t threads_count) {
+    dr_matrix_kernels_get()->bytes_to_floats(
+        test_dataset.pixels, DR_TRAIN_PIXEL_SCALE, inputs, test_dataset.count * test_dataset.image_size);
+    dr_neural_network_predict_batch_parallel(
+        neural_network, inputs, test_dataset.count, outputs, threads_count, NULL);
+
+    size_t correct_count = 0;
+    for (size_t i = 0; i < test_dataset.count; ++i) {
+        const DR_FLOAT_TYPE* output = outputs + i * DR_DATASET_LABELS_COUNT;
+        size_t digit = 0;
+        for (size_t j = 1; j < DR_DATASET_LABELS_COUNT; ++j) {
+            if (output[j] > output[digit]) {
+                digit = j;
+            }
+        }
+        correct_count += digit == test_dataset.labels[i];
+    }
+    return test_dataset.count ? (double)correct_count / test_dataset.count : 0;
+}
+
+static bool dr_train_save(const dr_neural_network neural_network, const char* file_path) {
+    const size_t length = strlen(file_path);
+    if (length >= 4 && strcmp(file_path + length - 4, ".txt") == 0) {
+        return dr_neural_network_save_to_file(neural_network, file_path);
+    }
+    return dr_neural_network_save_to_binary_file(neural_network, file_path);
+}
+
+int main(int argc, char** argv) {
+    dr_train_options options;
+    if (!dr_train_parse_options(argc, argv, &options)) {
+        dr_train_print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    dr_dataset dataset = dr_dataset_create(DR_TRAIN_IMAGE_SIZE);
+    if (!dr_dataset_load_idx(&dataset, options.images_file_path, options.labels_file_path, options.count)) {
+        dr_print_error("Error to load the images to train on\n");
+        return EXIT_FAILURE;
+    }
+    dr_dataset test_dataset = dr_dataset_create(DR_TRAIN_IMAGE_SIZE);
+    if (options.test_images_file_path && !dr_dataset_load_idx(&test_dataset,
+        options.test_images_file_path, options.test_labels_file_path, options.test_count)) {
+        dr_print_error("Error to load the test images\n");
+        dr_dataset_free(&dataset);
+        return EXIT_FAILURE;
+    }
+
+    dr_neural_network neural_network = dr_train_create_neural_network(options.hidden_layers);
+    if (!dr_neural_network_valid(neural_network)) {
+        dr_dataset_free(&test_dataset);
+        dr_dataset_free(&dataset);
+        return EXIT_FAILURE;
+    }
+
+    // the parts of the batches and the GEMMs inside them share the workers of the default scheduler
+    dr_parallel_scheduler* scheduler = dr_parallel_scheduler_create(options.threads_count - 1);
+    dr_parallel_scheduler_set_default(scheduler);
+
+    // a single thread trains the mini-batches itself, the trainer splits them between the threads.
+    // The hogwild workers train sample by sample, so they get chunks big enough to keep them all busy
+    const size_t batch_capacity = options.hogwild ? DR_TRAIN_HOGWILD_CHUNK_SIZE : options.batch_size;
+    dr_trainer* trainer = NULL;
+    dr_batch_workspace batch_workspace = { 0 };
+    if (options.hogwild) {
+        trainer = dr_trainer_create_hogwild(neural_network, batch_capacity, options.threads_count);
+    } else if (options.threads_count > 1) {
+        trainer = dr_trainer_create(neural_network, batch_capacity, options.threads_count);
+    } else {
+        batch_workspace = dr_batch_workspace_create(neural_network, batch_capacity);
+    }
+    DR_FLOAT_TYPE* test_inputs  = NULL;
+    DR_FLOAT_TYPE* test_outputs = NULL;
+    if (test_dataset.count > 0) {
+        test_inputs = (DR_FLOAT_TYPE*)DR_MALLOC(sizeof(DR_FLOAT_TYPE) * test_dataset.count * DR_TRAIN_IMAGE_SIZE);
+        test_outputs =
+            (DR_FLOAT_TYPE*)DR_MALLOC(sizeof(DR_FLOAT_TYPE) * test_dataset.count * DR_DATASET_LABELS_COUNT);
+    }
+
+    printf("%zu images, %zu test images, the %s kernels, the seed %llu\n", dataset.count, test_dataset.count,
+        dr_matrix_kernels_isa_to_string(dr_matrix_kernels_get()->isa), (unsigned long long)options.seed);
+
+    dr_dataset_loader* loader = dr_dataset_loader_create(dataset, batch_capacity, DR_TRAIN_PIXEL_SCALE,
+        options.epochs_count, options.order, options.seed);
+    const double start_seconds = dr_time_seconds();
+    double epoch_start_seconds = start_seconds;
+    size_t epoch_images_count  = 0;
+    double epoch_error_sum     = 0;
+    const dr_dataset_batch* batch = NULL;
+    while ((batch = dr_dataset_loader_acquire(loader))) {
+        epoch_error_sum += trainer ?
+            dr_trainer_train_batch(trainer, options.learning_rate, batch->inputs, batch->outputs, batch->count) :
+            dr_neural_network_train_batch(neural_network, batch_workspace,
+                options.learning_rate, batch->inputs, batch->outputs, batch->count);
+        epoch_images_count += batch->count;
+        const size_t epoch = batch->epoch;
+        dr_dataset_loader_release(loader);
+
+        if (epoch_images_count < dataset.count) {
+            continue;
+        }
+        const double seconds = dr_time_seconds() - epoch_start_seconds;
+        printf("epoch %zu/%zu: error %f, %.2f s, %.0f images/s", epoch + 1, options.epochs_count,
+            fabs(epoch_error_sum) / dataset.count, seconds, dataset.count / seconds);
+        if (test_dataset.count > 0) {
+            printf(", accuracy %.2f%%", 100 * dr_train_accuracy(
+                neural_network, test_dataset, test_inputs, test_outputs, options.threads_count));
+        }
+        printf("\n");
+        fflush(stdout);
+        epoch_images_count  = 0;
+        epoch_error_sum     = 0;
+        epoch_start_seconds = dr_time_seconds();
+    }
+    printf("trained in %.2f s\n", dr_time_seconds() - start_seconds);
+
+    dr_dataset_loader_free(loader);
+    const bool saved = dr_train_save(neural_network, options.output_file_path);
+    if (!saved) {
+        dr_print_error("Error to save the model to %s\n", options.output_file_path);
+    }
+
+    DR_FREE(test_outputs);
+    DR_FREE(test_inputs);
+    if (trainer) {
+        dr_trainer_free(trainer);
+    } else {
+        dr_batch_workspace_free(&batch_workspace);
+    }
+    dr_neural_network_free(&neural_network);
+    dr_dataset_free(&test_dataset);
+    dr_dataset_free(&dataset);
+    dr_parallel_scheduler_set_default(NULL);
+    dr_parallel_scheduler_free(scheduler);
+
+    return saved ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file
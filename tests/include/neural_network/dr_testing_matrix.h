@@ -42,4 +42,18 @@ static bool dr_testing_matrix_array_equals(const size_t size, const DR_FLOAT_TYP
     return true;
 }
 
+static dr_matrix dr_testing_matrix_dot_reference_create(const dr_matrix left, const dr_matrix right) {
+    dr_matrix result = dr_matrix_create_filled(right.width, left.height, 0);
+    for (size_t row = 0; row < left.height; ++row) {
+        for (size_t column = 0; column < right.width; ++column) {
+            double sum = 0;
+            for (size_t k = 0; k < left.width; ++k) {
+                sum += (double)left.elements[row * left.width + k] * right.elements[k * right.width + column];
+            }
+            result.elements[row * result.width + column] = (DR_FLOAT_TYPE)sum;
+        }
+    }
+    return result;
+}
+
 #endif // DR_TESTING_H
\ No newline at end of file
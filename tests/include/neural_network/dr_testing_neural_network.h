@@ -40,7 +40,7 @@ static DR_FLOAT_TYPE dr_testing_neural_network_func_triple(const DR_FLOAT_TYPE v
     return val * 3;
 }
 
-bool dr_testing_neural_network_equals(
+static bool dr_testing_neural_network_equals(
     const dr_neural_network left, const dr_neural_network right, const DR_FLOAT_TYPE epsilon) {
     DR_ASSERT_MSG(dr_neural_network_valid(left) && dr_neural_network_valid(right),
         "attempt to compat a not valid neural network");
@@ -66,4 +66,24 @@ bool dr_testing_neural_network_equals(
     return true;
 }
 
+// a binary file of two layers of 2^31 neurons: the size of its connection wraps around to 0 in 64 bits,
+// so without the overflow checks the file would look complete
+static void dr_testing_neural_network_write_overflowing_binary_file(const char* file_path) {
+    const uint32_t values[] = {
+        DR_NEURAL_NETWORK_BINARY_VERSION, sizeof(DR_FLOAT_TYPE), 2, (uint32_t)1 << 31, (uint32_t)1 << 31,
+        dr_activation_function_id_sigmoid, dr_activation_function_id_sigmoid_derivative
+    };
+    unsigned char bytes[DR_NEURAL_NETWORK_BINARY_ALIGNMENT] = { 0 };
+    memcpy(bytes, DR_NEURAL_NETWORK_BINARY_MAGIC, 4);
+    for (size_t i = 0; i < DR_ARRAY_LENGTH(values); ++i) {
+        for (size_t j = 0; j < 4; ++j) {
+            bytes[4 + 4 * i + j] = (unsigned char)(values[i] >> (8 * j));
+        }
+    }
+    FILE* file = fopen(file_path, "wb");
+    DR_ASSERT_MSG(file, "can't open the file to write the overflowing neural network");
+    fwrite(bytes, 1, sizeof(bytes), file);
+    fclose(file);
+}
+
 #endif // DR_TESTING_NEURAL_NETWORK_H
\ No newline at end of file
@@ -0,0 +1,106 @@
+#include <utest.h>
+#include <dataset/dr_dataset.h>
+#include <stdint.h>
+
+#define DR_TESTING_DATASET_IMAGE_SIZE 6
+
+UTEST(dr_dataset, add) {
+    dr_dataset dataset = dr_dataset_create(DR_TESTING_DATASET_IMAGE_SIZE);
+    EXPECT_EQ(dataset.count, 0);
+    EXPECT_EQ(dataset.capacity, 0);
+
+    size_t reallocations = 0;
+    const unsigned char* previous_pixels = NULL;
+    for (size_t i = 0; i < 1000; ++i) {
+        unsigned char pixels[DR_TESTING_DATASET_IMAGE_SIZE] = { 0 };
+        for (size_t j = 0; j < DR_TESTING_DATASET_IMAGE_SIZE; ++j) {
+            pixels[j] = (unsigned char)(i + j);
+        }
+        dr_dataset_add(&dataset, pixels, (unsigned char)(i % DR_DATASET_LABELS_COUNT));
+        if (dataset.pixels != previous_pixels) {
+            ++reallocations;
+            previous_pixels = dataset.pixels;
+        }
+    }
+    // the capacity doubles
+    EXPECT_EQ(dataset.count, 1000);
+    EXPECT_TRUE(dataset.capacity >= 1000 && dataset.capacity < 2000);
+    EXPECT_TRUE(reallocations <= 7);
+
+    for (size_t i = 0; i < dataset.count; ++i) {
+        const unsigned char* image = dr_dataset_image(dataset, i);
+        for (size_t j = 0; j < DR_TESTING_DATASET_IMAGE_SIZE; ++j) {
+            EXPECT_EQ(image[j], (unsigned char)(i + j));
+        }
+        const size_t label = i % DR_DATASET_LABELS_COUNT;
+        EXPECT_EQ(dataset.labels[i], label);
+    }
+    for (size_t label = 0; label < DR_DATASET_LABELS_COUNT; ++label) {
+        EXPECT_EQ(dataset.labels_counts[label], 100);
+    }
+
+    // clear keeps the memory
+    const size_t capacity = dataset.capacity;
+    dr_dataset_clear(&dataset);
+    EXPECT_EQ(dataset.count, 0);
+    EXPECT_EQ(dataset.capacity, capacity);
+    EXPECT_EQ(dataset.labels_counts[3], 0);
+
+    dr_dataset_reserve(&dataset, capacity * 3);
+    EXPECT_EQ(dataset.capacity, capacity * 3);
+    dr_dataset_reserve(&dataset, 1);
+    EXPECT_EQ(dataset.capacity, capacity * 3);
+
+    dr_dataset_free(&dataset);
+    EXPECT_TRUE(dataset.pixels == NULL);
+    EXPECT_EQ(dataset.capacity, 0);
+    EXPECT_EQ(dataset.image_size, DR_TESTING_DATASET_IMAGE_SIZE);
+}
+
+UTEST(dr_dataset, load_mnist) {
+    const char* file_path = "test_dataset_load_mnist.bin";
+    const uint32_t images_count = 5;
+    const uint32_t header[3] = { images_count, 2, 3 };
+
+    FILE* file = fopen(file_path, "wb");
+    ASSERT_TRUE(file);
+    fwrite(header, sizeof(header), 1, file);
+    for (uint32_t i = 0; i < images_count * DR_TESTING_DATASET_IMAGE_SIZE; ++i) {
+        const unsigned char pixel = (unsigned char)(i * 3);
+        fwrite(&pixel, 1, 1, file);
+    }
+    for (uint32_t i = 0; i < images_count; ++i) {
+        const unsigned char label = (unsigned char)(9 - i);
+        fwrite(&label, 1, 1, file);
+    }
+    fclose(file);
+
+    dr_dataset dataset = dr_dataset_create(DR_TESTING_DATASET_IMAGE_SIZE);
+    const unsigned char drawn_pixels[DR_TESTING_DATASET_IMAGE_SIZE] = { 1, 2, 3, 4, 5, 6 };
+    dr_dataset_add(&dataset, drawn_pixels, 7);
+
+    // the images are appended after the existing ones
+    EXPECT_TRUE(dr_dataset_load_mnist(&dataset, file_path, 3));
+    EXPECT_EQ(dataset.count, 4);
+    EXPECT_EQ(dr_dataset_image(dataset, 0)[5], 6);
+    for (size_t i = 0; i < 3; ++i) {
+        const unsigned char* image = dr_dataset_image(dataset, i + 1);
+        for (size_t j = 0; j < DR_TESTING_DATASET_IMAGE_SIZE; ++j) {
+            EXPECT_EQ(image[j], (unsigned char)((i * DR_TESTING_DATASET_IMAGE_SIZE + j) * 3));
+        }
+        EXPECT_EQ(dataset.labels[i + 1], 9 - i);
+    }
+    EXPECT_EQ(dataset.labels_counts[7], 2);
+    EXPECT_EQ(dataset.labels_counts[9], 1);
+
+    EXPECT_FALSE(dr_dataset_load_mnist(&dataset, file_path, images_count + 1));
+    EXPECT_FALSE(dr_dataset_load_mnist(&dataset, "test_dataset_load_mnist_missing.bin", 1));
+    EXPECT_EQ(dataset.count, 4);
+
+    // another image size
+    dr_dataset other_dataset = dr_dataset_create(DR_TESTING_DATASET_IMAGE_SIZE + 1);
+    EXPECT_FALSE(dr_dataset_load_mnist(&other_dataset, file_path, 1));
+    dr_dataset_free(&other_dataset);
+
+    dr_dataset_free(&dataset);
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include <utest.h>
+#include <dataset/dr_dataset_loader.h>
+
+#define DR_TESTING_DATASET_LOADER_IMAGE_SIZE   5
+#define DR_TESTING_DATASET_LOADER_IMAGES_COUNT 23
+
+static dr_dataset dr_testing_dataset_loader_dataset() {
+    dr_dataset dataset = dr_dataset_create(DR_TESTING_DATASET_LOADER_IMAGE_SIZE);
+    for (size_t i = 0; i < DR_TESTING_DATASET_LOADER_IMAGES_COUNT; ++i) {
+        unsigned char pixels[DR_TESTING_DATASET_LOADER_IMAGE_SIZE];
+        for (size_t j = 0; j < DR_TESTING_DATASET_LOADER_IMAGE_SIZE; ++j) {
+            pixels[j] = (unsigned char)(i * DR_TESTING_DATASET_LOADER_IMAGE_SIZE + j);
+        }
+        dr_dataset_add(&dataset, pixels, (unsigned char)(i % DR_DATASET_LABELS_COUNT));
+    }
+    return dataset;
+}
+
+UTEST(dr_dataset_loader, batches) {
+    dr_dataset dataset = dr_testing_dataset_loader_dataset();
+    const size_t batch_size   = 4;
+    const size_t epochs_count = 3;
+    dr_dataset_loader* loader = dr_dataset_loader_create(
+        dataset, batch_size, 0.5, epochs_count, dr_dataset_order_sequential, 0);
+
+    // the consumer gets every image of every epoch in order
+    size_t batches_count = 0;
+    size_t image_index   = 0;
+    size_t epoch         = 0;
+    const dr_dataset_batch* batch = NULL;
+    while ((batch = dr_dataset_loader_acquire(loader))) {
+        EXPECT_EQ(batch->epoch, epoch);
+        const size_t pixels_misalignment = (uintptr_t)batch->pixels % DR_DATASET_LOADER_ALIGNMENT;
+        EXPECT_EQ(pixels_misalignment, 0);
+        EXPECT_TRUE(batch->count > 0 && batch->count <= batch_size);
+        for (size_t i = 0; i < batch->count; ++i, ++image_index) {
+            for (size_t j = 0; j < DR_TESTING_DATASET_LOADER_IMAGE_SIZE; ++j) {
+                const size_t pixel = image_index * DR_TESTING_DATASET_LOADER_IMAGE_SIZE + j;
+                EXPECT_EQ(batch->inputs[i][j], (DR_FLOAT_TYPE)pixel * (DR_FLOAT_TYPE)0.5);
+            }
+            const size_t image_label = image_index % DR_DATASET_LABELS_COUNT;
+            for (size_t label = 0; label < DR_DATASET_LABELS_COUNT; ++label) {
+                EXPECT_EQ(batch->outputs[i][label], label == image_label ? 1 : 0);
+            }
+        }
+        if (image_index == DR_TESTING_DATASET_LOADER_IMAGES_COUNT) {
+            image_index = 0;
+            ++epoch;
+        }
+        ++batches_count;
+        dr_dataset_loader_release(loader);
+    }
+    EXPECT_EQ(epoch, epochs_count);
+    EXPECT_EQ(batches_count, epochs_count * ((DR_TESTING_DATASET_LOADER_IMAGES_COUNT + batch_size - 1) / batch_size));
+    EXPECT_TRUE(dr_dataset_loader_acquire(loader) == NULL);
+    dr_dataset_loader_free(loader);
+
+    // the producer waiting for a free batch is stopped
+    loader = dr_dataset_loader_create(dataset, batch_size, 1, epochs_count, dr_dataset_order_shuffle, 0);
+    batch  = dr_dataset_loader_acquire(loader);
+    ASSERT_TRUE(batch);
+    EXPECT_EQ(batch->count, batch_size);
+    dr_dataset_loader_free(loader);
+
+    // nothing to load
+    dr_dataset empty_dataset = dr_dataset_create(DR_TESTING_DATASET_LOADER_IMAGE_SIZE);
+    loader = dr_dataset_loader_create(
+        empty_dataset, batch_size, 1, epochs_count, dr_dataset_order_shuffle_blocks, 0);
+    EXPECT_TRUE(dr_dataset_loader_acquire(loader) == NULL);
+    dr_dataset_loader_free(loader);
+
+    dr_dataset_free(&dataset);
+}
+
+UTEST(dr_dataset_loader, shuffle) {
+    dr_dataset dataset = dr_testing_dataset_loader_dataset();
+    const size_t batch_size   = 3;
+    const size_t epochs_count = 4;
+    const dr_dataset_order orders[] = { dr_dataset_order_shuffle, dr_dataset_order_shuffle_blocks };
+
+    for (size_t order_index = 0; order_index < DR_ARRAY_LENGTH(orders); ++order_index) {
+        dr_dataset_loader* loader =
+            dr_dataset_loader_create(dataset, batch_size, 1, epochs_count, orders[order_index], 123);
+
+        // every epoch has all the images once, the orders of the epochs differ
+        size_t orders_indices[4][DR_TESTING_DATASET_LOADER_IMAGES_COUNT] = { { 0 } };
+        size_t epoch_images_count[4] = { 0 };
+        const dr_dataset_batch* batch = NULL;
+        while ((batch = dr_dataset_loader_acquire(loader))) {
+            ASSERT_TRUE(batch->epoch < epochs_count);
+            for (size_t i = 0; i < batch->count; ++i) {
+                const size_t index = (size_t)batch->inputs[i][0] / DR_TESTING_DATASET_LOADER_IMAGE_SIZE;
+                EXPECT_EQ(batch->inputs[i][1], (DR_FLOAT_TYPE)(index * DR_TESTING_DATASET_LOADER_IMAGE_SIZE + 1));
+                const size_t label = index % DR_DATASET_LABELS_COUNT;
+                EXPECT_EQ(batch->outputs[i][label], 1);
+                orders_indices[batch->epoch][epoch_images_count[batch->epoch]++] = index;
+            }
+            dr_dataset_loader_release(loader);
+        }
+        dr_dataset_loader_free(loader);
+
+        bool orders_differ = false;
+        for (size_t epoch = 0; epoch < epochs_count; ++epoch) {
+            ASSERT_EQ(epoch_images_count[epoch], DR_TESTING_DATASET_LOADER_IMAGES_COUNT);
+            bool found[DR_TESTING_DATASET_LOADER_IMAGES_COUNT] = { false };
+            for (size_t i = 0; i < DR_TESTING_DATASET_LOADER_IMAGES_COUNT; ++i) {
+                EXPECT_FALSE(found[orders_indices[epoch][i]]);
+                found[orders_indices[epoch][i]] = true;
+                orders_differ |= orders_indices[epoch][i] != orders_indices[0][i];
+            }
+        }
+        EXPECT_TRUE(orders_differ);
+    }
+
+    dr_dataset_free(&dataset);
+}
\ No newline at end of file
@@ -0,0 +1,122 @@
+#include <utest.h>
+#include <dataset/dr_idx.h>
+
+#ifdef DR_USE_ZLIB
+  #include <zlib.h>
+#endif // DR_USE_ZLIB
+
+#define DR_TESTING_IDX_ROWS         3
+#define DR_TESTING_IDX_COLUMNS      4
+#define DR_TESTING_IDX_IMAGE_SIZE   (DR_TESTING_IDX_ROWS * DR_TESTING_IDX_COLUMNS)
+#define DR_TESTING_IDX_IMAGES_COUNT 7
+
+static size_t dr_testing_idx_write_u32(unsigned char* bytes, const uint32_t value) {
+    bytes[0] = (unsigned char)(value >> 24);
+    bytes[1] = (unsigned char)(value >> 16);
+    bytes[2] = (unsigned char)(value >> 8);
+    bytes[3] = (unsigned char)value;
+    return 4;
+}
+
+// the images file, then the labels file
+static size_t dr_testing_idx_files(unsigned char* images, unsigned char* labels, const uint32_t labels_count) {
+    size_t images_size = 0;
+    images_size += dr_testing_idx_write_u32(images + images_size, DR_IDX_IMAGES_MAGIC);
+    images_size += dr_testing_idx_write_u32(images + images_size, DR_TESTING_IDX_IMAGES_COUNT);
+    images_size += dr_testing_idx_write_u32(images + images_size, DR_TESTING_IDX_ROWS);
+    images_size += dr_testing_idx_write_u32(images + images_size, DR_TESTING_IDX_COLUMNS);
+    for (size_t i = 0; i < DR_TESTING_IDX_IMAGES_COUNT * DR_TESTING_IDX_IMAGE_SIZE; ++i) {
+        images[images_size++] = (unsigned char)(i * 5);
+    }
+
+    size_t labels_size = 0;
+    labels_size += dr_testing_idx_write_u32(labels + labels_size, DR_IDX_LABELS_MAGIC);
+    labels_size += dr_testing_idx_write_u32(labels + labels_size, labels_count);
+    for (size_t i = 0; i < labels_count; ++i) {
+        labels[labels_size++] = (unsigned char)((i * 3) % DR_DATASET_LABELS_COUNT);
+    }
+    return images_size;
+}
+
+static void dr_testing_idx_write_file(const char* file_path, const unsigned char* bytes, const size_t size) {
+    FILE* file = fopen(file_path, "wb");
+    fwrite(bytes, 1, size, file);
+    fclose(file);
+}
+
+static bool dr_testing_idx_check_dataset(const dr_dataset dataset, const size_t first, const size_t count) {
+    bool result = dataset.count == first + count;
+    for (size_t i = 0; result && i < count; ++i) {
+        const unsigned char* image = dr_dataset_image(dataset, first + i);
+        for (size_t j = 0; j < DR_TESTING_IDX_IMAGE_SIZE; ++j) {
+            result &= image[j] == (unsigned char)((i * DR_TESTING_IDX_IMAGE_SIZE + j) * 5);
+        }
+        result &= dataset.labels[first + i] == (i * 3) % DR_DATASET_LABELS_COUNT;
+    }
+    return result;
+}
+
+UTEST(dr_idx, load) {
+    const char* images_file_path = "test_idx_images";
+    const char* labels_file_path = "test_idx_labels";
+    unsigned char images[16 + DR_TESTING_IDX_IMAGES_COUNT * DR_TESTING_IDX_IMAGE_SIZE] = { 0 };
+    unsigned char labels[8 + DR_TESTING_IDX_IMAGES_COUNT] = { 0 };
+    const size_t images_size = dr_testing_idx_files(images, labels, DR_TESTING_IDX_IMAGES_COUNT);
+    dr_testing_idx_write_file(images_file_path, images, images_size);
+    dr_testing_idx_write_file(labels_file_path, labels, sizeof(labels));
+
+    dr_dataset dataset = dr_dataset_create(DR_TESTING_IDX_IMAGE_SIZE);
+    EXPECT_TRUE(dr_dataset_load_idx(&dataset, images_file_path, labels_file_path, 5));
+    EXPECT_TRUE(dr_testing_idx_check_dataset(dataset, 0, 5));
+    EXPECT_EQ(dataset.labels_counts[3], 1);
+    EXPECT_TRUE(dr_dataset_load_idx(&dataset, images_file_path, labels_file_path, DR_TESTING_IDX_IMAGES_COUNT));
+    EXPECT_TRUE(dr_testing_idx_check_dataset(dataset, 5, DR_TESTING_IDX_IMAGES_COUNT));
+
+    // the dataset stays the same on errors
+    dr_dataset_clear(&dataset);
+    EXPECT_FALSE(
+        dr_dataset_load_idx(&dataset, images_file_path, labels_file_path, DR_TESTING_IDX_IMAGES_COUNT + 1));
+    EXPECT_FALSE(dr_dataset_load_idx(&dataset, labels_file_path, images_file_path, 1));
+    EXPECT_FALSE(dr_dataset_load_idx(&dataset, images_file_path, "test_idx_missing", 1));
+
+    dr_testing_idx_write_file(images_file_path, images, images_size - 1);
+    EXPECT_FALSE(dr_dataset_load_idx(&dataset, images_file_path, labels_file_path, DR_TESTING_IDX_IMAGES_COUNT));
+
+    dr_testing_idx_write_file(images_file_path, images, images_size);
+    dr_testing_idx_files(images, labels, DR_TESTING_IDX_IMAGES_COUNT - 1);
+    dr_testing_idx_write_file(labels_file_path, labels, sizeof(labels) - 1);
+    EXPECT_FALSE(dr_dataset_load_idx(&dataset, images_file_path, labels_file_path, 1));
+    EXPECT_EQ(dataset.count, 0);
+    EXPECT_EQ(dataset.labels_counts[0], 0);
+
+    dr_dataset other_dataset = dr_dataset_create(DR_TESTING_IDX_IMAGE_SIZE + 1);
+    EXPECT_FALSE(dr_dataset_load_idx(&other_dataset, images_file_path, labels_file_path, 1));
+    dr_dataset_free(&other_dataset);
+
+    dr_dataset_free(&dataset);
+}
+
+#ifdef DR_USE_ZLIB
+UTEST(dr_idx, load_gzip) {
+    const char* images_file_path = "test_idx_images.gz";
+    const char* labels_file_path = "test_idx_labels.gz";
+    unsigned char images[16 + DR_TESTING_IDX_IMAGES_COUNT * DR_TESTING_IDX_IMAGE_SIZE] = { 0 };
+    unsigned char labels[8 + DR_TESTING_IDX_IMAGES_COUNT] = { 0 };
+    const size_t images_size = dr_testing_idx_files(images, labels, DR_TESTING_IDX_IMAGES_COUNT);
+
+    gzFile file = gzopen(images_file_path, "wb");
+    ASSERT_TRUE(file);
+    gzwrite(file, images, (unsigned int)images_size);
+    gzclose(file);
+    file = gzopen(labels_file_path, "wb");
+    ASSERT_TRUE(file);
+    gzwrite(file, labels, (unsigned int)sizeof(labels));
+    gzclose(file);
+
+    EXPECT_TRUE(dr_idx_gzip_supported());
+    dr_dataset dataset = dr_dataset_create(DR_TESTING_IDX_IMAGE_SIZE);
+    EXPECT_TRUE(dr_dataset_load_idx(&dataset, images_file_path, labels_file_path, DR_TESTING_IDX_IMAGES_COUNT));
+    EXPECT_TRUE(dr_testing_idx_check_dataset(dataset, 0, DR_TESTING_IDX_IMAGES_COUNT));
+    dr_dataset_free(&dataset);
+}
+#endif // DR_USE_ZLIB
\ No newline at end of file
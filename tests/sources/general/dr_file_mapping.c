@@ -0,0 +1,29 @@
+#include <utest.h>
+#include <general/dr_file_mapping.h>
+#include <general/dr_utils.h>
+
+UTEST(dr_file_mapping, open_close) {
+    const char* file_path = "test_file_mapping.bin";
+    const char content[]  = "digit recognizer";
+
+    FILE* file = fopen(file_path, "wb");
+    ASSERT_TRUE(file);
+    fwrite(content, 1, sizeof(content), file);
+    fclose(file);
+
+    dr_file_mapping mapping;
+    ASSERT_TRUE(dr_file_mapping_open(&mapping, file_path));
+    EXPECT_EQ(mapping.size, sizeof(content));
+    EXPECT_EQ(memcmp(mapping.data, content, sizeof(content)), 0);
+    dr_file_mapping_close(&mapping);
+    EXPECT_TRUE(mapping.data == NULL);
+    EXPECT_EQ(mapping.size, 0);
+
+    // an empty file has nothing to map
+    file = fopen(file_path, "wb");
+    ASSERT_TRUE(file);
+    fclose(file);
+    EXPECT_FALSE(dr_file_mapping_open(&mapping, file_path));
+
+    EXPECT_FALSE(dr_file_mapping_open(&mapping, "test_file_mapping_missing.bin"));
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+#include <utest.h>
+#include <general/dr_metrics.h>
+
+#define DR_TESTING_METRICS_PUBLICATIONS_COUNT 100000
+
+static dr_training_metrics dr_testing_metrics_create(const size_t value) {
+    dr_training_metrics metrics;
+    metrics.epoch             = value;
+    metrics.epochs_count      = value * 2;
+    metrics.images_count      = value * 3;
+    metrics.error             = value * 0.5;
+    metrics.images_per_second = value * 0.25;
+    return metrics;
+}
+
+static bool dr_testing_metrics_consistent(const dr_training_metrics metrics) {
+    const dr_training_metrics expected = dr_testing_metrics_create(metrics.epoch);
+    return metrics.epochs_count == expected.epochs_count && metrics.images_count == expected.images_count &&
+        metrics.error == expected.error && metrics.images_per_second == expected.images_per_second;
+}
+
+static dr_thread_function_result_t DR_WINAPI dr_testing_metrics_writer(void* data) {
+    dr_metrics_channel* channel = (dr_metrics_channel*)data;
+    for (size_t i = 1; i <= DR_TESTING_METRICS_PUBLICATIONS_COUNT; ++i) {
+        const dr_training_metrics metrics = dr_testing_metrics_create(i);
+        dr_metrics_channel_publish(channel, &metrics);
+    }
+    return 0;
+}
+
+UTEST(dr_metrics, publish_read) {
+    dr_metrics_channel channel;
+    dr_metrics_channel_init(&channel, 0);
+
+    dr_training_metrics metrics = dr_testing_metrics_create(7);
+    dr_metrics_channel_read(&channel, &metrics);
+    EXPECT_EQ(metrics.epoch, 0);
+    EXPECT_EQ(metrics.error, 0);
+
+    const dr_training_metrics published_metrics = dr_testing_metrics_create(5);
+    dr_metrics_channel_publish(&channel, &published_metrics);
+    dr_metrics_channel_read(&channel, &metrics);
+    EXPECT_EQ(metrics.epoch, 5);
+    EXPECT_TRUE(dr_testing_metrics_consistent(metrics));
+}
+
+UTEST(dr_metrics, publish_throttled) {
+    dr_metrics_channel channel;
+    dr_metrics_channel_init(&channel, 1000);
+
+    // the first snapshot is published at once, the next ones wait for the interval
+    dr_training_metrics metrics = dr_testing_metrics_create(1);
+    EXPECT_TRUE(dr_metrics_channel_publish_throttled(&channel, &metrics));
+    metrics = dr_testing_metrics_create(2);
+    EXPECT_FALSE(dr_metrics_channel_publish_throttled(&channel, &metrics));
+    dr_metrics_channel_read(&channel, &metrics);
+    EXPECT_EQ(metrics.epoch, 1);
+
+    metrics = dr_testing_metrics_create(3);
+    dr_metrics_channel_publish(&channel, &metrics);
+    dr_metrics_channel_read(&channel, &metrics);
+    EXPECT_EQ(metrics.epoch, 3);
+}
+
+UTEST(dr_metrics, concurrent_read) {
+    dr_metrics_channel channel;
+    dr_metrics_channel_init(&channel, 0);
+
+    dr_thread_id_t thread_id;
+    dr_thread_handle_t thread_handle = dr_thread_create_with_data(&thread_id, dr_testing_metrics_writer, &channel);
+    ASSERT_TRUE(dr_check_thread_handle(thread_handle));
+
+    // every snapshot is whole and they never go back
+    size_t last_epoch = 0;
+    dr_training_metrics metrics;
+    do {
+        dr_metrics_channel_read(&channel, &metrics);
+        ASSERT_TRUE(dr_testing_metrics_consistent(metrics));
+        ASSERT_TRUE(metrics.epoch >= last_epoch);
+        last_epoch = metrics.epoch;
+    } while (metrics.epoch < DR_TESTING_METRICS_PUBLICATIONS_COUNT);
+
+    EXPECT_TRUE(dr_thread_join(thread_handle, thread_id));
+    EXPECT_TRUE(dr_thread_close(thread_handle));
+}
\ No newline at end of file
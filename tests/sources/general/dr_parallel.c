@@ -0,0 +1,145 @@
+#include <utest.h>
+#include <general/dr_parallel.h>
+#include <general/dr_utils.h>
+
+#define DR_TESTING_PARALLEL_RANGE_SIZE 1000
+#define DR_TESTING_PARALLEL_FORKS_COUNT (2 * DR_PARALLEL_DEQUE_CAPACITY + 1)
+
+static const size_t dr_testing_parallel_workers_counts[] = { 0, 1, 3 };
+
+static void dr_testing_parallel_mark(void* data, const size_t begin, const size_t end) {
+    size_t* marks = (size_t*)data;
+    for (size_t i = begin; i < end; ++i) {
+        ++marks[i];
+    }
+}
+
+static void dr_testing_parallel_increment(void* data) {
+    ++*(size_t*)data;
+}
+
+typedef struct {
+    dr_parallel_scheduler* scheduler;
+    size_t n;
+    size_t result;
+} dr_testing_parallel_fibonacci_data;
+
+static void dr_testing_parallel_fibonacci(void* data) {
+    dr_testing_parallel_fibonacci_data* fibonacci_data = (dr_testing_parallel_fibonacci_data*)data;
+    if (fibonacci_data->n < 2) {
+        fibonacci_data->result = fibonacci_data->n;
+        return;
+    }
+
+    dr_testing_parallel_fibonacci_data first  = { fibonacci_data->scheduler, fibonacci_data->n - 1, 0 };
+    dr_testing_parallel_fibonacci_data second = { fibonacci_data->scheduler, fibonacci_data->n - 2, 0 };
+    dr_parallel_task task;
+    dr_parallel_task_init(&task, dr_testing_parallel_fibonacci, &first);
+    dr_parallel_fork(fibonacci_data->scheduler, &task);
+    dr_testing_parallel_fibonacci(&second);
+    dr_parallel_join(fibonacci_data->scheduler, &task);
+    fibonacci_data->result = first.result + second.result;
+}
+
+typedef struct {
+    dr_parallel_scheduler* scheduler;
+    size_t* counters;
+} dr_testing_parallel_forks_data;
+
+// more forks than a deque holds, the rest runs at once
+static void dr_testing_parallel_many_forks(void* data) {
+    dr_testing_parallel_forks_data* forks_data = (dr_testing_parallel_forks_data*)data;
+    dr_parallel_task* tasks = (dr_parallel_task*)malloc(sizeof(dr_parallel_task) * DR_TESTING_PARALLEL_FORKS_COUNT);
+    for (size_t i = 0; i < DR_TESTING_PARALLEL_FORKS_COUNT; ++i) {
+        dr_parallel_task_init(tasks + i, dr_testing_parallel_increment, forks_data->counters + i);
+        dr_parallel_fork(forks_data->scheduler, tasks + i);
+    }
+    for (size_t i = DR_TESTING_PARALLEL_FORKS_COUNT; i > 0; --i) {
+        dr_parallel_join(forks_data->scheduler, tasks + i - 1);
+    }
+    free(tasks);
+}
+
+typedef struct {
+    dr_parallel_scheduler* scheduler;
+    size_t* marks;
+} dr_testing_parallel_nested_data;
+
+static void dr_testing_parallel_nested(void* data, const size_t begin, const size_t end) {
+    dr_testing_parallel_nested_data* nested_data = (dr_testing_parallel_nested_data*)data;
+    for (size_t i = begin; i < end; ++i) {
+        dr_parallel_for(nested_data->scheduler, 0, DR_TESTING_PARALLEL_RANGE_SIZE, 3,
+            dr_testing_parallel_mark, nested_data->marks + i * DR_TESTING_PARALLEL_RANGE_SIZE);
+    }
+}
+
+UTEST(dr_parallel, fork_join) {
+    for (size_t i = 0; i < DR_ARRAY_LENGTH(dr_testing_parallel_workers_counts); ++i) {
+        dr_parallel_scheduler* scheduler = dr_parallel_scheduler_create(dr_testing_parallel_workers_counts[i]);
+        ASSERT_TRUE(scheduler);
+
+        dr_testing_parallel_fibonacci_data fibonacci_data = { scheduler, 20, 0 };
+        dr_parallel_task task;
+        dr_parallel_task_init(&task, dr_testing_parallel_fibonacci, &fibonacci_data);
+        EXPECT_FALSE(dr_parallel_task_done(&task));
+        dr_parallel_fork(scheduler, &task);
+        dr_parallel_join(scheduler, &task);
+        EXPECT_TRUE(dr_parallel_task_done(&task));
+        EXPECT_EQ(fibonacci_data.result, 6765);
+
+        size_t* counters = (size_t*)calloc(DR_TESTING_PARALLEL_FORKS_COUNT, sizeof(size_t));
+        ASSERT_TRUE(counters);
+        dr_testing_parallel_forks_data forks_data = { scheduler, counters };
+        dr_parallel_task_init(&task, dr_testing_parallel_many_forks, &forks_data);
+        dr_parallel_fork(scheduler, &task);
+        dr_parallel_join(scheduler, &task);
+        for (size_t j = 0; j < DR_TESTING_PARALLEL_FORKS_COUNT; ++j) {
+            EXPECT_EQ(counters[j], 1);
+        }
+        free(counters);
+
+        dr_parallel_scheduler_free(scheduler);
+    }
+}
+
+UTEST(dr_parallel, parallel_for) {
+    for (size_t i = 0; i < DR_ARRAY_LENGTH(dr_testing_parallel_workers_counts); ++i) {
+        dr_parallel_scheduler* scheduler = dr_parallel_scheduler_create(dr_testing_parallel_workers_counts[i]);
+        size_t marks[DR_TESTING_PARALLEL_RANGE_SIZE] = { 0 };
+
+        const size_t grain_sizes[] = { 1, 7, DR_TESTING_PARALLEL_RANGE_SIZE, 2 * DR_TESTING_PARALLEL_RANGE_SIZE };
+        for (size_t j = 0; j < DR_ARRAY_LENGTH(grain_sizes); ++j) {
+            dr_parallel_for(scheduler, 10, DR_TESTING_PARALLEL_RANGE_SIZE - 10, grain_sizes[j],
+                dr_testing_parallel_mark, marks);
+        }
+        dr_parallel_for(scheduler, 5, 5, 1, dr_testing_parallel_mark, marks);
+        for (size_t j = 0; j < DR_TESTING_PARALLEL_RANGE_SIZE; ++j) {
+            const bool inside = j >= 10 && j < DR_TESTING_PARALLEL_RANGE_SIZE - 10;
+            EXPECT_EQ(marks[j], inside ? DR_ARRAY_LENGTH(grain_sizes) : 0);
+        }
+
+        dr_parallel_scheduler_free(scheduler);
+    }
+}
+
+UTEST(dr_parallel, nested_parallel_for) {
+    const size_t rows_count = 16;
+    size_t* marks = (size_t*)calloc(rows_count * DR_TESTING_PARALLEL_RANGE_SIZE, sizeof(size_t));
+    ASSERT_TRUE(marks);
+
+    dr_parallel_scheduler* scheduler = dr_parallel_scheduler_create(3);
+    dr_testing_parallel_nested_data nested_data = { scheduler, marks };
+    dr_parallel_for(scheduler, 0, rows_count, 1, dr_testing_parallel_nested, &nested_data);
+    for (size_t i = 0; i < rows_count * DR_TESTING_PARALLEL_RANGE_SIZE; ++i) {
+        EXPECT_EQ(marks[i], 1);
+    }
+    dr_parallel_scheduler_free(scheduler);
+    free(marks);
+}
+
+UTEST(dr_parallel, get_default) {
+    dr_parallel_scheduler* scheduler = dr_parallel_scheduler_get_default();
+    ASSERT_TRUE(scheduler);
+    EXPECT_TRUE(scheduler == dr_parallel_scheduler_get_default());
+    EXPECT_EQ(scheduler->workers_count + 1, dr_thread_hardware_concurrency());
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+#include <utest.h>
+#include <general/dr_random.h>
+#include <stdbool.h>
+
+#define DR_TESTING_RANDOM_COUNT      1000
+#define DR_TESTING_RANDOM_BLOCK_SIZE 64
+
+static bool dr_testing_random_is_permutation(const size_t* indices, const size_t count) {
+    bool found[DR_TESTING_RANDOM_COUNT] = { false };
+    for (size_t i = 0; i < count; ++i) {
+        if (indices[i] >= count || found[indices[i]]) {
+            return false;
+        }
+        found[indices[i]] = true;
+    }
+    return true;
+}
+
+UTEST(dr_random, sequence) {
+    dr_random first  = dr_random_create(42);
+    dr_random second = dr_random_create(42);
+    dr_random other  = dr_random_create(43);
+    size_t differences = 0;
+    for (size_t i = 0; i < DR_TESTING_RANDOM_COUNT; ++i) {
+        const uint64_t value = dr_random_next(&first);
+        EXPECT_EQ(value, dr_random_next(&second));
+        differences += value != dr_random_next(&other);
+    }
+    EXPECT_TRUE(differences > DR_TESTING_RANDOM_COUNT / 2);
+
+    size_t counts[7] = { 0 };
+    for (size_t i = 0; i < 7 * DR_TESTING_RANDOM_COUNT; ++i) {
+        const size_t value = dr_random_below(&first, 7);
+        ASSERT_TRUE(value < 7);
+        ++counts[value];
+    }
+    for (size_t i = 0; i < 7; ++i) {
+        EXPECT_TRUE(counts[i] > DR_TESTING_RANDOM_COUNT * 8 / 10 && counts[i] < DR_TESTING_RANDOM_COUNT * 12 / 10);
+    }
+    EXPECT_EQ(dr_random_below(&first, 1), 0);
+}
+
+UTEST(dr_random, shuffle) {
+    dr_random random = dr_random_create(7);
+    size_t indices[DR_TESTING_RANDOM_COUNT];
+    for (size_t i = 0; i < DR_TESTING_RANDOM_COUNT; ++i) {
+        indices[i] = i;
+    }
+
+    dr_random_shuffle(&random, indices, DR_TESTING_RANDOM_COUNT);
+    EXPECT_TRUE(dr_testing_random_is_permutation(indices, DR_TESTING_RANDOM_COUNT));
+    size_t fixed_points = 0;
+    for (size_t i = 0; i < DR_TESTING_RANDOM_COUNT; ++i) {
+        fixed_points += indices[i] == i;
+    }
+    EXPECT_TRUE(fixed_points < 10);
+
+    dr_random_shuffle(&random, indices, 0);
+    dr_random_shuffle(&random, indices, 1);
+    EXPECT_TRUE(dr_testing_random_is_permutation(indices, DR_TESTING_RANDOM_COUNT));
+}
+
+UTEST(dr_random, shuffle_blocks) {
+    dr_random random = dr_random_create(7);
+    size_t indices[DR_TESTING_RANDOM_COUNT];
+    for (size_t i = 0; i < DR_TESTING_RANDOM_COUNT; ++i) {
+        indices[i] = i;
+    }
+
+    for (size_t epoch = 0; epoch < 3; ++epoch) {
+        dr_random_shuffle_blocks(&random, indices, DR_TESTING_RANDOM_COUNT, DR_TESTING_RANDOM_BLOCK_SIZE);
+        EXPECT_TRUE(dr_testing_random_is_permutation(indices, DR_TESTING_RANDOM_COUNT));
+        // every block holds the indices of a single block of the start order
+        for (size_t begin = 0; begin < DR_TESTING_RANDOM_COUNT; begin += DR_TESTING_RANDOM_BLOCK_SIZE) {
+            const size_t block = indices[begin] / DR_TESTING_RANDOM_BLOCK_SIZE;
+            for (size_t i = begin; i < begin + DR_TESTING_RANDOM_BLOCK_SIZE && i < DR_TESTING_RANDOM_COUNT; ++i) {
+                EXPECT_EQ(indices[i] / DR_TESTING_RANDOM_BLOCK_SIZE, block);
+            }
+        }
+        // the short block stays the last one
+        EXPECT_EQ(indices[DR_TESTING_RANDOM_COUNT - 1] / DR_TESTING_RANDOM_BLOCK_SIZE,
+            (DR_TESTING_RANDOM_COUNT - 1) / DR_TESTING_RANDOM_BLOCK_SIZE);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,100 @@
+#include <utest.h>
+#include <general/dr_thread.h>
+
+#define DR_TESTING_THREAD_COUNT  4
+#define DR_TESTING_THREAD_ROUNDS 100
+
+typedef struct {
+    dr_barrier_t* barrier;
+    size_t* counters;
+    size_t index;
+    bool consistent;
+} dr_testing_thread_data;
+
+static dr_thread_function_result_t DR_WINAPI dr_testing_thread_barrier_function(void* data) {
+    dr_testing_thread_data* thread_data = (dr_testing_thread_data*)data;
+    for (size_t round = 0; round < DR_TESTING_THREAD_ROUNDS; ++round) {
+        thread_data->counters[thread_data->index] = round + 1;
+        dr_barrier_wait(thread_data->barrier);
+        // every thread has finished the round before anyone goes further
+        for (size_t i = 0; i < DR_TESTING_THREAD_COUNT; ++i) {
+            if (thread_data->counters[i] != round + 1) {
+                thread_data->consistent = false;
+            }
+        }
+        dr_barrier_wait(thread_data->barrier);
+    }
+    return 0;
+}
+
+UTEST(dr_thread, barrier) {
+    dr_barrier_t barrier;
+    ASSERT_TRUE(dr_barrier_create(&barrier, DR_TESTING_THREAD_COUNT));
+
+    size_t counters[DR_TESTING_THREAD_COUNT] = { 0 };
+    dr_testing_thread_data threads_data[DR_TESTING_THREAD_COUNT];
+    dr_thread_id_t threads_ids[DR_TESTING_THREAD_COUNT];
+    dr_thread_handle_t threads_handles[DR_TESTING_THREAD_COUNT];
+    for (size_t i = 0; i < DR_TESTING_THREAD_COUNT; ++i) {
+        threads_data[i].barrier    = &barrier;
+        threads_data[i].counters   = counters;
+        threads_data[i].index      = i;
+        threads_data[i].consistent = true;
+        threads_handles[i] = dr_thread_create_with_data(
+            threads_ids + i, dr_testing_thread_barrier_function, threads_data + i);
+        EXPECT_TRUE(dr_check_thread_handle(threads_handles[i]));
+    }
+
+    for (size_t i = 0; i < DR_TESTING_THREAD_COUNT; ++i) {
+        EXPECT_TRUE(dr_thread_join(threads_handles[i], threads_ids[i]));
+        EXPECT_TRUE(dr_thread_close(threads_handles[i]));
+        EXPECT_TRUE(threads_data[i].consistent);
+        EXPECT_EQ(counters[i], DR_TESTING_THREAD_ROUNDS);
+    }
+
+    EXPECT_TRUE(dr_barrier_close(&barrier));
+}
+
+typedef struct {
+    dr_semaphore_t* semaphore;
+    dr_atomic_size_t* passed_count;
+} dr_testing_thread_semaphore_data;
+
+static dr_thread_function_result_t DR_WINAPI dr_testing_thread_semaphore_function(void* data) {
+    dr_testing_thread_semaphore_data* thread_data = (dr_testing_thread_semaphore_data*)data;
+    dr_semaphore_wait(thread_data->semaphore);
+    dr_atomic_fetch_add(thread_data->passed_count, 1);
+    return 0;
+}
+
+UTEST(dr_thread, semaphore) {
+    EXPECT_TRUE(dr_thread_hardware_concurrency() >= 1);
+
+    dr_semaphore_t semaphore;
+    ASSERT_TRUE(dr_semaphore_create(&semaphore, 1));
+    EXPECT_TRUE(dr_semaphore_wait(&semaphore));
+
+    dr_atomic_size_t passed_count = 0;
+    dr_testing_thread_semaphore_data thread_data = { &semaphore, &passed_count };
+    dr_thread_id_t threads_ids[DR_TESTING_THREAD_COUNT];
+    dr_thread_handle_t threads_handles[DR_TESTING_THREAD_COUNT];
+    for (size_t i = 0; i < DR_TESTING_THREAD_COUNT; ++i) {
+        threads_handles[i] = dr_thread_create_with_data(
+            threads_ids + i, dr_testing_thread_semaphore_function, &thread_data);
+        EXPECT_TRUE(dr_check_thread_handle(threads_handles[i]));
+    }
+
+    // nobody passes until the semaphore is posted
+    for (size_t i = 0; i < 100; ++i) {
+        dr_thread_yield();
+    }
+    EXPECT_EQ(dr_atomic_load_acquire(&passed_count), 0);
+    EXPECT_TRUE(dr_semaphore_post(&semaphore, DR_TESTING_THREAD_COUNT));
+
+    for (size_t i = 0; i < DR_TESTING_THREAD_COUNT; ++i) {
+        EXPECT_TRUE(dr_thread_join(threads_handles[i], threads_ids[i]));
+        EXPECT_TRUE(dr_thread_close(threads_handles[i]));
+    }
+    EXPECT_EQ(dr_atomic_load_acquire(&passed_count), DR_TESTING_THREAD_COUNT);
+    EXPECT_TRUE(dr_semaphore_close(&semaphore));
+}
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include <utest.h>
+#include <general/dr_thread_pool.h>
+#include <general/dr_utils.h>
+
+#define DR_TESTING_THREAD_POOL_TASKS_COUNT 200
+#define DR_TESTING_THREAD_POOL_RANGE_SIZE  1000
+
+static void dr_testing_thread_pool_increment(void* data) {
+    ++*(size_t*)data;
+}
+
+static void dr_testing_thread_pool_mark(void* data, const size_t begin, const size_t end) {
+    size_t* marks = (size_t*)data;
+    for (size_t i = begin; i < end; ++i) {
+        ++marks[i];
+    }
+}
+
+typedef struct {
+    dr_thread_pool* pool;
+    size_t* marks;
+} dr_testing_thread_pool_nested_data;
+
+// every outer index runs its own parallel for over a row of the marks
+static void dr_testing_thread_pool_nested(void* data, const size_t begin, const size_t end) {
+    dr_testing_thread_pool_nested_data* nested_data = (dr_testing_thread_pool_nested_data*)data;
+    for (size_t i = begin; i < end; ++i) {
+        dr_thread_pool_parallel_for(nested_data->pool, 0, DR_TESTING_THREAD_POOL_RANGE_SIZE, 7,
+            dr_testing_thread_pool_mark, nested_data->marks + i * DR_TESTING_THREAD_POOL_RANGE_SIZE);
+    }
+}
+
+UTEST(dr_thread_pool, submit) {
+    const size_t threads_counts[] = { 0, 1, 3 };
+    for (size_t pool_index = 0; pool_index < DR_ARRAY_LENGTH(threads_counts); ++pool_index) {
+        dr_thread_pool* pool = dr_thread_pool_create(threads_counts[pool_index]);
+        ASSERT_TRUE(pool);
+
+        // more tasks than the initial capacity of the queue
+        size_t counters[DR_TESTING_THREAD_POOL_TASKS_COUNT] = { 0 };
+        dr_future futures[DR_TESTING_THREAD_POOL_TASKS_COUNT];
+        for (size_t i = 0; i < DR_TESTING_THREAD_POOL_TASKS_COUNT; ++i) {
+            dr_thread_pool_submit(pool, dr_testing_thread_pool_increment, counters + i, futures + i);
+        }
+        for (size_t i = 0; i < DR_TESTING_THREAD_POOL_TASKS_COUNT; ++i) {
+            dr_future_wait(futures + i, pool);
+            EXPECT_TRUE(dr_future_ready(futures + i));
+            EXPECT_EQ(counters[i], 1);
+        }
+
+        // the tasks without futures are finished by free
+        size_t counter = 0;
+        dr_thread_pool_submit(pool, dr_testing_thread_pool_increment, &counter, NULL);
+        dr_thread_pool_free(pool);
+        EXPECT_EQ(counter, 1);
+    }
+}
+
+UTEST(dr_thread_pool, parallel_for) {
+    dr_thread_pool* pool = dr_thread_pool_create(3);
+    size_t marks[DR_TESTING_THREAD_POOL_RANGE_SIZE] = { 0 };
+
+    const size_t grain_sizes[] = { 1, 7, DR_TESTING_THREAD_POOL_RANGE_SIZE, 2 * DR_TESTING_THREAD_POOL_RANGE_SIZE };
+    for (size_t i = 0; i < DR_ARRAY_LENGTH(grain_sizes); ++i) {
+        dr_thread_pool_parallel_for(pool, 10, DR_TESTING_THREAD_POOL_RANGE_SIZE - 10, grain_sizes[i],
+            dr_testing_thread_pool_mark, marks);
+    }
+    dr_thread_pool_parallel_for(pool, 5, 5, 1, dr_testing_thread_pool_mark, marks);
+    for (size_t i = 0; i < DR_TESTING_THREAD_POOL_RANGE_SIZE; ++i) {
+        const bool inside = i >= 10 && i < DR_TESTING_THREAD_POOL_RANGE_SIZE - 10;
+        EXPECT_EQ(marks[i], inside ? DR_ARRAY_LENGTH(grain_sizes) : 0);
+    }
+
+    dr_thread_pool_free(pool);
+}
+
+UTEST(dr_thread_pool, nested_parallel_for) {
+    const size_t rows_count = 16;
+    size_t* marks = (size_t*)calloc(rows_count * DR_TESTING_THREAD_POOL_RANGE_SIZE, sizeof(size_t));
+    ASSERT_TRUE(marks);
+
+    // the waiting threads run the inner chunks themselves, so the nested loops don't deadlock
+    dr_thread_pool* pool = dr_thread_pool_create(2);
+    dr_testing_thread_pool_nested_data nested_data = { pool, marks };
+    dr_thread_pool_parallel_for(pool, 0, rows_count, 1, dr_testing_thread_pool_nested, &nested_data);
+    for (size_t i = 0; i < rows_count * DR_TESTING_THREAD_POOL_RANGE_SIZE; ++i) {
+        EXPECT_EQ(marks[i], 1);
+    }
+    dr_thread_pool_free(pool);
+    free(marks);
+}
+
+UTEST(dr_thread_pool, get_default) {
+    dr_thread_pool* pool = dr_thread_pool_get_default();
+    ASSERT_TRUE(pool);
+    EXPECT_TRUE(pool == dr_thread_pool_get_default());
+    EXPECT_EQ(pool->threads_count + 1, dr_thread_hardware_concurrency());
+}
\ No newline at end of file
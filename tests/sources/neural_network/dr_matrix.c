@@ -1,5 +1,6 @@
 #include <utest.h>
 #include <dr_testing_matrix.h>
+#include <general/dr_parallel.h>
 
 UTEST(dr_matrix, dr_matrix_correct_sizes) {
     EXPECT_TRUE(dr_matrix_correct_sizes(1, 1));
@@ -783,6 +784,231 @@ UTEST(dr_matrix, dot_create) {
     }
 }
 
+UTEST(dr_matrix, dot_write_blocked) {
+    // sizes are chosen to cross the cache blocks and to leave partial register tiles
+    const size_t sizes[][3] = {
+        { 33, 47, 29 },
+        { 131, 517, 70 },
+        { 5, 40, 2100 },
+        { 257, 300, 9 }
+    };
+
+    for (size_t i = 0; i < DR_ARRAY_LENGTH(sizes); ++i) {
+        const size_t M = sizes[i][0];
+        const size_t K = sizes[i][1];
+        const size_t N = sizes[i][2];
+
+        dr_matrix left  = dr_matrix_alloc(K, M);
+        dr_matrix right = dr_matrix_alloc(N, K);
+        dr_matrix_fill_random(left, -1, 1);
+        dr_matrix_fill_random(right, -1, 1);
+
+        dr_matrix expected_result = dr_testing_matrix_dot_reference_create(left, right);
+        dr_matrix result          = dr_matrix_alloc(N, M);
+        dr_matrix_fill(result, 100);
+
+        dr_matrix_dot_write(left, right, result);
+        EXPECT_TRUE(dr_matrix_equals(result, expected_result, DR_TESTING_MATRIX_EQUALS_EPSILON));
+
+        dr_matrix_free(&left);
+        dr_matrix_free(&right);
+        dr_matrix_free(&expected_result);
+        dr_matrix_free(&result);
+    }
+}
+
+UTEST(dr_matrix, dot_write_ex) {
+    // M, K, N: the vector, the rank-1, the naive and the blocked paths
+    const size_t sizes[][3] = {
+        { 7, 5, 1 },
+        { 9, 1, 12 },
+        { 4, 3, 6 },
+        { 33, 47, 29 },
+        { 131, 70, 40 }
+    };
+    const DR_FLOAT_TYPE coefficients[][2] = {
+        { 1, 0 },
+        { 0.5, 2 },
+        { -1, 1 }
+    };
+
+    for (size_t i = 0; i < DR_ARRAY_LENGTH(sizes); ++i) {
+        const size_t M = sizes[i][0];
+        const size_t K = sizes[i][1];
+        const size_t N = sizes[i][2];
+
+        dr_matrix left  = dr_matrix_alloc(K, M);
+        dr_matrix right = dr_matrix_alloc(N, K);
+        dr_matrix_fill_random(left, -1, 1);
+        dr_matrix_fill_random(right, -1, 1);
+        dr_matrix left_transposed  = dr_matrix_transpose_create(left);
+        dr_matrix right_transposed = dr_matrix_transpose_create(right);
+        dr_matrix product          = dr_testing_matrix_dot_reference_create(left, right);
+        dr_matrix initial          = dr_matrix_alloc(N, M);
+        dr_matrix_fill_random(initial, -1, 1);
+
+        for (size_t coefficient = 0; coefficient < DR_ARRAY_LENGTH(coefficients); ++coefficient) {
+            const DR_FLOAT_TYPE alpha = coefficients[coefficient][0];
+            const DR_FLOAT_TYPE beta  = coefficients[coefficient][1];
+
+            dr_matrix expected_result = dr_matrix_alloc(N, M);
+            for (size_t element = 0; element < N * M; ++element) {
+                expected_result.elements[element] =
+                    alpha * product.elements[element] + beta * initial.elements[element];
+            }
+
+            for (size_t transposition = 0; transposition < 4; ++transposition) {
+                const bool transpose_left  = transposition & 1;
+                const bool transpose_right = transposition & 2;
+
+                dr_matrix result = dr_matrix_copy_create(initial);
+                dr_matrix_dot_write_ex(transpose_left ? left_transposed : left, transpose_left,
+                    transpose_right ? right_transposed : right, transpose_right, alpha, beta, result);
+                EXPECT_TRUE(dr_matrix_equals(result, expected_result, DR_TESTING_MATRIX_EQUALS_EPSILON));
+                dr_matrix_free(&result);
+            }
+
+            dr_matrix_free(&expected_result);
+        }
+
+        dr_matrix_free(&left);
+        dr_matrix_free(&right);
+        dr_matrix_free(&left_transposed);
+        dr_matrix_free(&right_transposed);
+        dr_matrix_free(&product);
+        dr_matrix_free(&initial);
+    }
+}
+
+UTEST(dr_matrix, dot_write_parallel) {
+    // M, K, N: the rows and the columns of the result are split between the workers
+    const size_t sizes[][3] = {
+        { 300, 100, 200 },
+        { 40, 300, 517 }
+    };
+
+    dr_parallel_scheduler* scheduler          = dr_parallel_scheduler_create(3);
+    dr_parallel_scheduler* previous_scheduler = dr_parallel_scheduler_set_default(scheduler);
+    for (size_t i = 0; i < DR_ARRAY_LENGTH(sizes); ++i) {
+        const size_t M = sizes[i][0];
+        const size_t K = sizes[i][1];
+        const size_t N = sizes[i][2];
+
+        dr_matrix left  = dr_matrix_alloc(K, M);
+        dr_matrix right = dr_matrix_alloc(N, K);
+        dr_matrix_fill_random(left, -1, 1);
+        dr_matrix_fill_random(right, -1, 1);
+        dr_matrix left_transposed = dr_matrix_transpose_create(left);
+
+        dr_matrix expected_result = dr_testing_matrix_dot_reference_create(left, right);
+        dr_matrix result          = dr_matrix_alloc(N, M);
+        dr_matrix_fill(result, 100);
+        dr_matrix_dot_write(left, right, result);
+        EXPECT_TRUE(dr_matrix_equals(result, expected_result, DR_TESTING_MATRIX_EQUALS_EPSILON));
+
+        // result = 2 * left * right - result = left * right
+        dr_matrix_dot_write_ex(left_transposed, true, right, false, 2, -1, result);
+        EXPECT_TRUE(dr_matrix_equals(result, expected_result, DR_TESTING_MATRIX_EQUALS_EPSILON));
+
+        dr_matrix_free(&left);
+        dr_matrix_free(&right);
+        dr_matrix_free(&left_transposed);
+        dr_matrix_free(&expected_result);
+        dr_matrix_free(&result);
+    }
+    dr_parallel_scheduler_set_default(previous_scheduler);
+    dr_parallel_scheduler_free(scheduler);
+}
+
+UTEST(dr_matrix, gemv_write) {
+    {
+        const DR_FLOAT_TYPE matrix_arr[] = {
+            1, 2, 3,
+            4, 5, 6
+        };
+
+        const DR_FLOAT_TYPE vector_arr[] = {
+            1,
+            0,
+            -1
+        };
+
+        const DR_FLOAT_TYPE expected_result_arr[] = {
+            -2,
+            -2
+        };
+
+        dr_matrix matrix          = dr_matrix_create_from_array(matrix_arr, 3, 2);
+        dr_matrix vector          = dr_matrix_create_from_array(vector_arr, 1, 3);
+        dr_matrix expected_result = dr_matrix_create_from_array(expected_result_arr, 1, 2);
+        dr_matrix result          = dr_matrix_alloc(1, 2);
+
+        dr_matrix_gemv_write(matrix, vector, result);
+        EXPECT_TRUE(dr_matrix_equals(result, expected_result, DR_TESTING_MATRIX_EQUALS_EPSILON));
+
+        dr_matrix_free(&matrix);
+        dr_matrix_free(&vector);
+        dr_matrix_free(&expected_result);
+        dr_matrix_free(&result);
+    }
+
+    {
+        // the size of a hidden layer of the application network plus a tail for the vector loop
+        const size_t width  = 787;
+        const size_t height = 13;
+
+        dr_matrix matrix = dr_matrix_alloc(width, height);
+        dr_matrix vector = dr_matrix_alloc(1, width);
+        dr_matrix_fill_random(matrix, -1, 1);
+        dr_matrix_fill_random(vector, -1, 1);
+
+        dr_matrix expected_result = dr_testing_matrix_dot_reference_create(matrix, vector);
+        dr_matrix result          = dr_matrix_alloc(1, height);
+
+        dr_matrix_gemv_write(matrix, vector, result);
+        EXPECT_TRUE(dr_matrix_equals(result, expected_result, DR_TESTING_MATRIX_EQUALS_EPSILON));
+
+        dr_matrix_dot_write(matrix, vector, result);
+        EXPECT_TRUE(dr_matrix_equals(result, expected_result, DR_TESTING_MATRIX_EQUALS_EPSILON));
+
+        dr_matrix_free(&matrix);
+        dr_matrix_free(&vector);
+        dr_matrix_free(&expected_result);
+        dr_matrix_free(&result);
+    }
+}
+
+UTEST(dr_matrix, gemv_create) {
+    const DR_FLOAT_TYPE matrix_arr[] = {
+        1, 2,
+        3, 4,
+        5, 6
+    };
+
+    const DR_FLOAT_TYPE vector_arr[] = {
+        2,
+        1
+    };
+
+    const DR_FLOAT_TYPE expected_result_arr[] = {
+        4,
+        10,
+        16
+    };
+
+    dr_matrix matrix          = dr_matrix_create_from_array(matrix_arr, 2, 3);
+    dr_matrix vector          = dr_matrix_create_from_array(vector_arr, 1, 2);
+    dr_matrix expected_result = dr_matrix_create_from_array(expected_result_arr, 1, 3);
+    dr_matrix result          = dr_matrix_gemv_create(matrix, vector);
+
+    EXPECT_TRUE(dr_matrix_equals(result, expected_result, DR_TESTING_MATRIX_EQUALS_EPSILON));
+
+    dr_matrix_free(&matrix);
+    dr_matrix_free(&vector);
+    dr_matrix_free(&expected_result);
+    dr_matrix_free(&result);
+}
+
 UTEST(dr_matrix, scale_write) {
     {
         const DR_FLOAT_TYPE matrix_arr[] = {
@@ -0,0 +1,213 @@
+#include <utest.h>
+#include <dr_testing_matrix.h>
+#include <neural_network/dr_matrix_kernels.h>
+#include <math.h>
+
+#define DR_TESTING_MATRIX_KERNELS_MAX_SIZE 67
+
+static const dr_matrix_kernels_isa dr_testing_matrix_kernels_isas[] = {
+    dr_matrix_kernels_isa_scalar,
+    dr_matrix_kernels_isa_sse2,
+    dr_matrix_kernels_isa_avx2,
+    dr_matrix_kernels_isa_avx512
+};
+
+UTEST(dr_matrix_kernels, detect_select) {
+    const dr_matrix_kernels_isa detected_isa = dr_matrix_kernels_detect_isa();
+    EXPECT_TRUE(dr_matrix_kernels_isa_supported(detected_isa));
+    EXPECT_TRUE(dr_matrix_kernels_isa_supported(dr_matrix_kernels_isa_scalar));
+
+    EXPECT_TRUE(dr_matrix_kernels_select(dr_matrix_kernels_isa_scalar));
+    EXPECT_EQ(dr_matrix_kernels_get()->isa, dr_matrix_kernels_isa_scalar);
+
+    EXPECT_TRUE(dr_matrix_kernels_select(detected_isa));
+    EXPECT_EQ(dr_matrix_kernels_get()->isa, detected_isa);
+    EXPECT_TRUE(strlen(dr_matrix_kernels_isa_to_string(detected_isa)) > 0);
+}
+
+UTEST(dr_matrix_kernels, element_wise) {
+    DR_FLOAT_TYPE left[DR_TESTING_MATRIX_KERNELS_MAX_SIZE]   = { 0 };
+    DR_FLOAT_TYPE right[DR_TESTING_MATRIX_KERNELS_MAX_SIZE]  = { 0 };
+    DR_FLOAT_TYPE result[DR_TESTING_MATRIX_KERNELS_MAX_SIZE] = { 0 };
+    unsigned char bytes[DR_TESTING_MATRIX_KERNELS_MAX_SIZE]  = { 0 };
+    for (size_t i = 0; i < DR_TESTING_MATRIX_KERNELS_MAX_SIZE; ++i) {
+        left[i]  = dr_random_float(-10, 10);
+        right[i] = dr_random_float(-10, 10);
+        bytes[i] = (unsigned char)(i * 37 + 200);
+    }
+
+    for (size_t isa_index = 0; isa_index < DR_ARRAY_LENGTH(dr_testing_matrix_kernels_isas); ++isa_index) {
+        if (!dr_matrix_kernels_select(dr_testing_matrix_kernels_isas[isa_index])) {
+            continue;
+        }
+        const dr_matrix_kernels* kernels = dr_matrix_kernels_get();
+
+        // every size checks a different split between the vector loop and the scalar tail
+        for (size_t size = 0; size <= DR_TESTING_MATRIX_KERNELS_MAX_SIZE; ++size) {
+            kernels->fill(result, 3, size);
+            for (size_t i = 0; i < size; ++i) {
+                EXPECT_EQ(result[i], 3);
+            }
+
+            kernels->multiplication(left, right, result, size);
+            for (size_t i = 0; i < size; ++i) {
+                EXPECT_EQ(result[i], left[i] * right[i]);
+            }
+
+            kernels->addition(left, right, result, size);
+            for (size_t i = 0; i < size; ++i) {
+                EXPECT_EQ(result[i], left[i] + right[i]);
+            }
+
+            kernels->subtraction(left, right, result, size);
+            for (size_t i = 0; i < size; ++i) {
+                EXPECT_EQ(result[i], left[i] - right[i]);
+            }
+
+            kernels->scale(left, 0.5, result, size);
+            for (size_t i = 0; i < size; ++i) {
+                EXPECT_EQ(result[i], left[i] * (DR_FLOAT_TYPE)0.5);
+            }
+
+            double expected_dot = 0;
+            for (size_t i = 0; i < size; ++i) {
+                expected_dot += (double)left[i] * right[i];
+            }
+            EXPECT_NEAR(kernels->dot(left, right, size), expected_dot, DR_TESTING_MATRIX_EQUALS_EPSILON);
+
+            for (size_t i = 0; i < size; ++i) {
+                result[i] = right[i];
+            }
+            kernels->axpy(2, left, result, size);
+            for (size_t i = 0; i < size; ++i) {
+                EXPECT_NEAR(result[i], right[i] + 2 * left[i], DR_TESTING_MATRIX_EQUALS_EPSILON);
+            }
+
+            kernels->bytes_to_floats(bytes, (DR_FLOAT_TYPE)(1.0 / 255.0), result, size);
+            for (size_t i = 0; i < size; ++i) {
+                EXPECT_EQ(result[i], bytes[i] * (DR_FLOAT_TYPE)(1.0 / 255.0));
+            }
+        }
+    }
+
+    dr_matrix_kernels_select(dr_matrix_kernels_detect_isa());
+}
+
+UTEST(dr_matrix_kernels, activations) {
+    // the sweep covers the clamped range of the exp approximation and beyond
+    DR_FLOAT_TYPE values[DR_TESTING_MATRIX_KERNELS_MAX_SIZE * 16] = { 0 };
+    DR_FLOAT_TYPE result[DR_TESTING_MATRIX_KERNELS_MAX_SIZE * 16] = { 0 };
+    const size_t values_count = DR_ARRAY_LENGTH(values);
+    for (size_t i = 0; i < values_count; ++i) {
+        values[i] = -120 + 240 * (DR_FLOAT_TYPE)i / (values_count - 1);
+    }
+    values[1] = 0;
+    values[2] = (DR_FLOAT_TYPE)1e-4;
+    values[3] = (DR_FLOAT_TYPE)-1e-4;
+
+    for (size_t isa_index = 0; isa_index < DR_ARRAY_LENGTH(dr_testing_matrix_kernels_isas); ++isa_index) {
+        if (!dr_matrix_kernels_select(dr_testing_matrix_kernels_isas[isa_index])) {
+            continue;
+        }
+        const dr_matrix_kernels* kernels = dr_matrix_kernels_get();
+
+        kernels->sigmoid(values, result, values_count);
+        for (size_t i = 0; i < values_count; ++i) {
+            EXPECT_NEAR(result[i], 1.0 / (1.0 + exp(-(double)values[i])), 0.000001);
+        }
+
+        kernels->tanh(values, result, values_count);
+        for (size_t i = 0; i < values_count; ++i) {
+            EXPECT_NEAR(result[i], tanh((double)values[i]), 0.000001);
+        }
+
+        // the derivatives take the outputs of the activation functions
+        for (size_t size = 0; size <= DR_TESTING_MATRIX_KERNELS_MAX_SIZE; ++size) {
+            kernels->sigmoid_derivative(values, result, size);
+            for (size_t i = 0; i < size; ++i) {
+                EXPECT_NEAR(result[i], values[i] * (1 - values[i]), DR_TESTING_MATRIX_EQUALS_EPSILON);
+            }
+
+            kernels->tanh_derivative(values, result, size);
+            for (size_t i = 0; i < size; ++i) {
+                EXPECT_NEAR(result[i], 1 - values[i] * values[i], DR_TESTING_MATRIX_EQUALS_EPSILON);
+            }
+
+            kernels->relu(values, result, size);
+            for (size_t i = 0; i < size; ++i) {
+                EXPECT_EQ(result[i], values[i] < 0 ? 0 : values[i]);
+            }
+
+            kernels->relu_derivative(values, result, size);
+            for (size_t i = 0; i < size; ++i) {
+                EXPECT_EQ(result[i], values[i] > 0 ? 1 : 0);
+            }
+        }
+
+        // in place
+        for (size_t i = 0; i < DR_TESTING_MATRIX_KERNELS_MAX_SIZE; ++i) {
+            result[i] = values[i];
+        }
+        kernels->relu(result, result, DR_TESTING_MATRIX_KERNELS_MAX_SIZE);
+        for (size_t i = 0; i < DR_TESTING_MATRIX_KERNELS_MAX_SIZE; ++i) {
+            EXPECT_EQ(result[i], values[i] < 0 ? 0 : values[i]);
+        }
+
+        // NaN isn't clamped away by the vector loops or the scalar tails
+        DR_FLOAT_TYPE nans[DR_TESTING_MATRIX_KERNELS_MAX_SIZE] = { 0 };
+        for (size_t i = 0; i < DR_TESTING_MATRIX_KERNELS_MAX_SIZE; ++i) {
+            nans[i] = (DR_FLOAT_TYPE)NAN;
+        }
+        kernels->sigmoid(nans, result, DR_TESTING_MATRIX_KERNELS_MAX_SIZE);
+        for (size_t i = 0; i < DR_TESTING_MATRIX_KERNELS_MAX_SIZE; ++i) {
+            EXPECT_TRUE(isnan(result[i]));
+        }
+        kernels->tanh(nans, result, DR_TESTING_MATRIX_KERNELS_MAX_SIZE);
+        for (size_t i = 0; i < DR_TESTING_MATRIX_KERNELS_MAX_SIZE; ++i) {
+            EXPECT_TRUE(isnan(result[i]));
+        }
+        kernels->relu(nans, result, DR_TESTING_MATRIX_KERNELS_MAX_SIZE);
+        for (size_t i = 0; i < DR_TESTING_MATRIX_KERNELS_MAX_SIZE; ++i) {
+            EXPECT_TRUE(isnan(result[i]));
+        }
+    }
+
+    dr_matrix_kernels_select(dr_matrix_kernels_detect_isa());
+}
+
+UTEST(dr_matrix_kernels, gemm_tile) {
+    const size_t tile_size = DR_MATRIX_KERNELS_GEMM_MR * DR_MATRIX_KERNELS_GEMM_NR;
+    DR_FLOAT_TYPE packed_A[DR_TESTING_MATRIX_KERNELS_MAX_SIZE * DR_MATRIX_KERNELS_GEMM_MR] = { 0 };
+    DR_FLOAT_TYPE packed_B[DR_TESTING_MATRIX_KERNELS_MAX_SIZE * DR_MATRIX_KERNELS_GEMM_NR] = { 0 };
+    DR_FLOAT_TYPE tile[DR_MATRIX_KERNELS_GEMM_MR * DR_MATRIX_KERNELS_GEMM_NR] = { 0 };
+    for (size_t i = 0; i < DR_ARRAY_LENGTH(packed_A); ++i) {
+        packed_A[i] = dr_random_float(-10, 10);
+    }
+    for (size_t i = 0; i < DR_ARRAY_LENGTH(packed_B); ++i) {
+        packed_B[i] = dr_random_float(-10, 10);
+    }
+
+    for (size_t isa_index = 0; isa_index < DR_ARRAY_LENGTH(dr_testing_matrix_kernels_isas); ++isa_index) {
+        if (!dr_matrix_kernels_select(dr_testing_matrix_kernels_isas[isa_index])) {
+            continue;
+        }
+        const dr_matrix_kernels* kernels = dr_matrix_kernels_get();
+
+        // odd and even depths check the unrolled loops and their tails
+        for (size_t kc = 0; kc <= DR_TESTING_MATRIX_KERNELS_MAX_SIZE; ++kc) {
+            kernels->gemm_tile(kc, packed_A, packed_B, tile);
+            for (size_t i = 0; i < tile_size; ++i) {
+                const size_t row    = i / DR_MATRIX_KERNELS_GEMM_NR;
+                const size_t column = i % DR_MATRIX_KERNELS_GEMM_NR;
+                double expected = 0;
+                for (size_t p = 0; p < kc; ++p) {
+                    expected += (double)packed_A[p * DR_MATRIX_KERNELS_GEMM_MR + row] *
+                        packed_B[p * DR_MATRIX_KERNELS_GEMM_NR + column];
+                }
+                EXPECT_NEAR(tile[i], expected, 0.05);
+            }
+        }
+    }
+
+    dr_matrix_kernels_select(dr_matrix_kernels_detect_isa());
+}
\ No newline at end of file
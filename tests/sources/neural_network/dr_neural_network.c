@@ -1,4 +1,5 @@
 #include <dr_testing_neural_network.h>
+#include <general/dr_thread.h>
 
 UTEST(dr_neural_network, dr_sigmoid) {
     EXPECT_NEAR(dr_sigmoid(-10), 0.00004539786870227497, 0.0000001);
@@ -36,6 +37,33 @@ UTEST(dr_neural_network, dr_relu_derivative) {
     EXPECT_NEAR(dr_relu_derivative(10), 1, 0.001);
 }
 
+static DR_FLOAT_TYPE dr_testing_neural_network_identity(const DR_FLOAT_TYPE value) {
+    return value;
+}
+
+UTEST(dr_neural_network, activation_function_arrays) {
+    const dr_activation_function functions[] = {
+        &dr_sigmoid, &dr_sigmoid_derivative, &dr_tanh, &dr_tanh_derivative, &dr_relu, &dr_relu_derivative
+    };
+    DR_FLOAT_TYPE values[37] = { 0 };
+    DR_FLOAT_TYPE result[DR_ARRAY_LENGTH(values)] = { 0 };
+    for (size_t i = 0; i < DR_ARRAY_LENGTH(values); ++i) {
+        values[i] = dr_random_float(-10, 10);
+    }
+
+    for (size_t function_index = 0; function_index < DR_ARRAY_LENGTH(functions); ++function_index) {
+        const dr_activation_function function             = functions[function_index];
+        const dr_activation_function_array function_array = dr_default_activation_function_to_array(function);
+        ASSERT_TRUE(function_array);
+        function_array(values, result, DR_ARRAY_LENGTH(values));
+        for (size_t i = 0; i < DR_ARRAY_LENGTH(values); ++i) {
+            EXPECT_NEAR(result[i], function(values[i]), 0.00001);
+        }
+    }
+
+    EXPECT_FALSE(dr_default_activation_function_to_array(&dr_testing_neural_network_identity));
+}
+
 
 UTEST(dr_neural_network, valid) {
     {
@@ -732,6 +760,57 @@ UTEST(dr_neural_network, back_propagation) {
     }
 }
 
+UTEST(dr_neural_network, back_propagation_workspace) {
+    const size_t layers[]     = { 5, 4, 3, 2 };
+    const size_t layers_count = DR_ARRAY_LENGTH(layers);
+    dr_activation_function activation_functions[]   = { &dr_tanh, &dr_relu, &dr_sigmoid };
+    dr_activation_function activation_functions_d[] = {
+        &dr_tanh_derivative, &dr_relu_derivative, &dr_sigmoid_derivative };
+    dr_neural_network nn = dr_neural_network_create(layers, layers_count, activation_functions, activation_functions_d);
+    dr_neural_network_randomize_weights(nn, -1, 1);
+    dr_neural_network expected_nn = dr_neural_network_copy_create(nn);
+
+    const size_t other_layers[] = { 5, 3, 2 };
+    dr_neural_network other_nn  = dr_neural_network_create(
+        other_layers, DR_ARRAY_LENGTH(other_layers), activation_functions, activation_functions_d);
+
+    dr_training_workspace training_workspace = dr_training_workspace_create(nn);
+    EXPECT_TRUE(dr_training_workspace_compatible(training_workspace, nn));
+    EXPECT_FALSE(dr_training_workspace_compatible(training_workspace, other_nn));
+
+    const DR_FLOAT_TYPE input[]         = { 0.1, -0.2, 0.3, 0.4, -0.5 };
+    const DR_FLOAT_TYPE target_output[] = { 1, 0 };
+    DR_FLOAT_TYPE errors[2]             = { 0 };
+
+    // the same workspace is reused for every step
+    for (size_t step = 0; step < 3; ++step) {
+        dr_neural_network_set_input(expected_nn, input);
+        dr_neural_network_forward_propagation(expected_nn);
+        for (size_t i = 0; i < DR_ARRAY_LENGTH(errors); ++i) {
+            errors[i] = target_output[i] - expected_nn.layers[layers_count - 1].elements[i];
+        }
+        dr_neural_network_back_propagation(expected_nn, 0.1, errors);
+
+        const DR_FLOAT_TYPE error_sum =
+            dr_neural_network_train_sample(nn, training_workspace, 0.1, input, target_output);
+        EXPECT_NEAR(error_sum, errors[0] + errors[1], DR_TESTING_MATRIX_EQUALS_EPSILON);
+
+        for (size_t i = 0; i < nn.connections_count; ++i) {
+            EXPECT_TRUE(dr_matrix_equals(nn.connections[i], expected_nn.connections[i],
+                DR_TESTING_MATRIX_EQUALS_EPSILON));
+        }
+    }
+
+    dr_training_workspace_free(&training_workspace);
+    EXPECT_TRUE(training_workspace.errors == NULL);
+    EXPECT_TRUE(training_workspace.output == NULL);
+    EXPECT_EQ(training_workspace.layers_count, 0);
+
+    dr_neural_network_free(&nn);
+    dr_neural_network_free(&expected_nn);
+    dr_neural_network_free(&other_nn);
+}
+
 UTEST(dr_neural_network, prediction_write) {
     {
         const size_t layers[]     = { 1, 1 };
@@ -817,6 +896,150 @@ UTEST(dr_neural_network, prediction_write) {
     }
 }
 
+typedef struct {
+    const dr_neural_network* neural_network;
+    const DR_FLOAT_TYPE* inputs;
+    DR_FLOAT_TYPE* predictions;
+    size_t count;
+} dr_testing_neural_network_inference_data;
+
+static dr_thread_function_result_t DR_WINAPI dr_testing_neural_network_inference_thread(void* data) {
+    dr_testing_neural_network_inference_data* inference_data = (dr_testing_neural_network_inference_data*)data;
+    const dr_neural_network neural_network = *inference_data->neural_network;
+    const size_t input_size  = dr_neural_network_input_size(neural_network);
+    const size_t output_size = dr_neural_network_output_size(neural_network);
+    dr_inference_context inference_context = dr_inference_context_create(neural_network);
+    for (size_t i = 0; i < inference_data->count; ++i) {
+        dr_neural_network_prediction_write_context(neural_network, inference_context,
+            inference_data->inputs + i * input_size, inference_data->predictions + i * output_size);
+    }
+    dr_inference_context_free(&inference_context);
+    return 0;
+}
+
+UTEST(dr_neural_network, prediction_write_context) {
+    enum { input_size = 5, output_size = 3, threads_count = 4, samples_count = 50 };
+    const size_t layers[]     = { input_size, 7, output_size };
+    const size_t layers_count = DR_ARRAY_LENGTH(layers);
+    dr_neural_network nn = dr_neural_network_create(
+        layers, layers_count, DR_TESTING_NN_AF_PLUG, DR_TESTING_NN_AFD_PLUG);
+    dr_neural_network_randomize_weights(nn, -1, 1);
+    dr_neural_network expected_nn = dr_neural_network_copy_create(nn);
+
+    DR_FLOAT_TYPE inputs[samples_count * input_size];
+    DR_FLOAT_TYPE expected_predictions[samples_count * output_size];
+    for (size_t i = 0; i < DR_ARRAY_LENGTH(inputs); ++i) {
+        inputs[i] = dr_random_float(-1, 1);
+    }
+    dr_neural_network reference_nn = dr_neural_network_copy_create(nn);
+    for (size_t i = 0; i < samples_count; ++i) {
+        dr_neural_network_prediction_write(
+            reference_nn, inputs + i * input_size, expected_predictions + i * output_size);
+    }
+
+    // every thread predicts all samples with the same network and its own context
+    DR_FLOAT_TYPE predictions[threads_count][samples_count * output_size];
+    dr_testing_neural_network_inference_data threads_data[threads_count];
+    dr_thread_id_t threads_ids[threads_count];
+    dr_thread_handle_t threads_handles[threads_count];
+    for (size_t i = 0; i < threads_count; ++i) {
+        threads_data[i].neural_network = &nn;
+        threads_data[i].inputs         = inputs;
+        threads_data[i].predictions    = predictions[i];
+        threads_data[i].count          = samples_count;
+        threads_handles[i] = dr_thread_create_with_data(
+            threads_ids + i, dr_testing_neural_network_inference_thread, threads_data + i);
+        EXPECT_TRUE(dr_check_thread_handle(threads_handles[i]));
+    }
+    for (size_t i = 0; i < threads_count; ++i) {
+        EXPECT_TRUE(dr_thread_join(threads_handles[i], threads_ids[i]));
+        dr_thread_close(threads_handles[i]);
+        for (size_t j = 0; j < DR_ARRAY_LENGTH(expected_predictions); ++j) {
+            EXPECT_NEAR(predictions[i][j], expected_predictions[j], DR_TESTING_MATRIX_EQUALS_EPSILON);
+        }
+    }
+
+    // the layers of the network stay untouched
+    EXPECT_TRUE(dr_testing_neural_network_equals(nn, expected_nn, 0));
+
+    dr_neural_network_free(&nn);
+    dr_neural_network_free(&expected_nn);
+    dr_neural_network_free(&reference_nn);
+}
+
+UTEST(dr_neural_network, predict_batch) {
+    // the count crosses the chunks of the batch prediction
+    enum { input_size = 13, output_size = 4, samples_count = 601 };
+    const size_t layers[]     = { input_size, 20, 9, output_size };
+    const size_t layers_count = DR_ARRAY_LENGTH(layers);
+    dr_neural_network nn = dr_neural_network_create(
+        layers, layers_count, DR_TESTING_NN_AF_PLUG, DR_TESTING_NN_AFD_PLUG);
+    dr_neural_network_randomize_weights(nn, -1, 1);
+
+    const size_t outputs_size           = sizeof(DR_FLOAT_TYPE) * samples_count * output_size;
+    DR_FLOAT_TYPE* inputs               = (DR_FLOAT_TYPE*)DR_MALLOC(sizeof(DR_FLOAT_TYPE) * samples_count * input_size);
+    DR_FLOAT_TYPE* expected_predictions = (DR_FLOAT_TYPE*)DR_MALLOC(outputs_size);
+    DR_FLOAT_TYPE* predictions          = (DR_FLOAT_TYPE*)DR_MALLOC(outputs_size);
+    for (size_t i = 0; i < samples_count * input_size; ++i) {
+        inputs[i] = dr_random_float(-1, 1);
+    }
+    for (size_t i = 0; i < samples_count; ++i) {
+        dr_neural_network_prediction_write(nn, inputs + i * input_size, expected_predictions + i * output_size);
+    }
+
+    dr_neural_network_predict_batch(nn, inputs, samples_count, predictions);
+    for (size_t i = 0; i < samples_count * output_size; ++i) {
+        EXPECT_NEAR(predictions[i], expected_predictions[i], DR_TESTING_MATRIX_EQUALS_EPSILON);
+    }
+
+    // an empty batch and the empty parts of a batch smaller than the number of threads write nothing
+    memset(predictions, 0, outputs_size);
+    dr_neural_network_predict_batch(nn, inputs, 0, predictions);
+    dr_neural_network_predict_batch_parallel(nn, inputs, 0, predictions, 3, NULL);
+    for (size_t i = 0; i < samples_count * output_size; ++i) {
+        EXPECT_EQ(predictions[i], 0);
+    }
+    dr_neural_network_predict_batch_parallel(nn, inputs, 2, predictions, 5, NULL);
+    for (size_t i = 0; i < 2 * output_size; ++i) {
+        EXPECT_NEAR(predictions[i], expected_predictions[i], DR_TESTING_MATRIX_EQUALS_EPSILON);
+    }
+
+    const size_t threads_count[] = { 1, 3, 8 };
+    for (size_t t = 0; t < DR_ARRAY_LENGTH(threads_count); ++t) {
+        memset(predictions, 0, outputs_size);
+        dr_prediction_stats stats = { 0 };
+        dr_neural_network_predict_batch_parallel(nn, inputs, samples_count, predictions, threads_count[t], &stats);
+        EXPECT_EQ(stats.images_count, samples_count);
+        EXPECT_EQ(stats.threads_count, threads_count[t]);
+        EXPECT_TRUE(stats.seconds >= 0);
+        for (size_t i = 0; i < samples_count * output_size; ++i) {
+            EXPECT_NEAR(predictions[i], expected_predictions[i], DR_TESTING_MATRIX_EQUALS_EPSILON);
+        }
+    }
+
+    // a single layer and a batch smaller than the number of threads
+    {
+        const size_t single_layers[] = { input_size, output_size };
+        dr_neural_network single_nn  = dr_neural_network_create(
+            single_layers, DR_ARRAY_LENGTH(single_layers), DR_TESTING_NN_AF_PLUG, DR_TESTING_NN_AFD_PLUG);
+        dr_neural_network_randomize_weights(single_nn, -1, 1);
+        for (size_t i = 0; i < 2; ++i) {
+            dr_neural_network_prediction_write(
+                single_nn, inputs + i * input_size, expected_predictions + i * output_size);
+        }
+        dr_neural_network_predict_batch_parallel(single_nn, inputs, 2, predictions, 4, NULL);
+        for (size_t i = 0; i < 2 * output_size; ++i) {
+            EXPECT_NEAR(predictions[i], expected_predictions[i], DR_TESTING_MATRIX_EQUALS_EPSILON);
+        }
+        dr_neural_network_free(&single_nn);
+    }
+
+    dr_neural_network_free(&nn);
+    DR_FREE(inputs);
+    DR_FREE(expected_predictions);
+    DR_FREE(predictions);
+}
+
 UTEST(dr_neural_network, prediction_create) {
     {
         const size_t layers[]     = { 1, 1 };
@@ -952,6 +1175,136 @@ UTEST(dr_neural_network, train) {
     DR_FREE(prediction_4);
 }
 
+UTEST(dr_neural_network, train_batch) {
+    const size_t layers[]     = { 6, 5, 4, 3 };
+    const size_t layers_count = DR_ARRAY_LENGTH(layers);
+    dr_activation_function activation_functions[]   = { &dr_tanh, &dr_relu, &dr_sigmoid };
+    dr_activation_function activation_functions_d[] = {
+        &dr_tanh_derivative, &dr_relu_derivative, &dr_sigmoid_derivative };
+    dr_neural_network nn = dr_neural_network_create(layers, layers_count, activation_functions, activation_functions_d);
+    dr_neural_network_randomize_weights(nn, -1, 1);
+
+    const size_t train_data_size = 7;
+    DR_FLOAT_TYPE** inputs       = dr_array_2d_float_alloc(layers[0], train_data_size);
+    DR_FLOAT_TYPE** outputs      = dr_array_2d_float_alloc(layers[layers_count - 1], train_data_size);
+    for (size_t i = 0; i < train_data_size; ++i) {
+        for (size_t j = 0; j < layers[0]; ++j) {
+            inputs[i][j] = dr_random_float(-1, 1);
+        }
+        for (size_t j = 0; j < layers[layers_count - 1]; ++j) {
+            outputs[i][j] = dr_random_float(0, 1);
+        }
+    }
+
+    // the update of a batch is the average of the updates of its samples computed with the same weights
+    dr_neural_network expected_nn = dr_neural_network_copy_create(nn);
+    dr_training_workspace training_workspace = dr_training_workspace_create(nn);
+    DR_FLOAT_TYPE expected_error_sum = 0;
+    for (size_t i = 0; i < train_data_size; ++i) {
+        dr_neural_network sample_nn = dr_neural_network_copy_create(nn);
+        expected_error_sum += dr_neural_network_train_sample(sample_nn, training_workspace, 0.1, inputs[i], outputs[i]);
+        for (size_t c = 0; c < nn.connections_count; ++c) {
+            const size_t size = dr_matrix_size(nn.connections[c]);
+            for (size_t e = 0; e < size; ++e) {
+                expected_nn.connections[c].elements[e] +=
+                    (sample_nn.connections[c].elements[e] - nn.connections[c].elements[e]) / train_data_size;
+            }
+        }
+        dr_neural_network_free(&sample_nn);
+    }
+
+    dr_batch_workspace batch_workspace = dr_batch_workspace_create(nn, 8);
+    EXPECT_TRUE(dr_batch_workspace_compatible(batch_workspace, nn));
+    const DR_FLOAT_TYPE error_sum = dr_neural_network_train_batch(nn, batch_workspace, 0.1,
+        (const DR_FLOAT_TYPE**)inputs, (const DR_FLOAT_TYPE**)outputs, train_data_size);
+    EXPECT_NEAR(error_sum, expected_error_sum, DR_TESTING_MATRIX_EQUALS_EPSILON);
+    for (size_t c = 0; c < nn.connections_count; ++c) {
+        EXPECT_TRUE(dr_matrix_equals(nn.connections[c], expected_nn.connections[c], DR_TESTING_MATRIX_EQUALS_EPSILON));
+    }
+
+    dr_batch_workspace_free(&batch_workspace);
+    EXPECT_TRUE(batch_workspace.layers == NULL);
+    EXPECT_TRUE(batch_workspace.errors == NULL);
+    dr_training_workspace_free(&training_workspace);
+    dr_neural_network_free(&nn);
+    dr_neural_network_free(&expected_nn);
+    dr_array_2d_float_free(inputs, train_data_size);
+    dr_array_2d_float_free(outputs, train_data_size);
+}
+
+// applies the average of the SGD updates of the samples, each computed from the current weights
+static void dr_testing_neural_network_train_batch_reference(dr_neural_network nn, const DR_FLOAT_TYPE learning_rate,
+    DR_FLOAT_TYPE** inputs, DR_FLOAT_TYPE** outputs, const size_t count) {
+    dr_neural_network batch_nn = dr_neural_network_copy_create(nn);
+    dr_training_workspace training_workspace = dr_training_workspace_create(nn);
+    for (size_t i = 0; i < count; ++i) {
+        dr_neural_network sample_nn = dr_neural_network_copy_create(nn);
+        dr_neural_network_train_sample(sample_nn, training_workspace, learning_rate, inputs[i], outputs[i]);
+        for (size_t c = 0; c < nn.connections_count; ++c) {
+            const size_t size = dr_matrix_size(nn.connections[c]);
+            for (size_t e = 0; e < size; ++e) {
+                batch_nn.connections[c].elements[e] +=
+                    (sample_nn.connections[c].elements[e] - nn.connections[c].elements[e]) / count;
+            }
+        }
+        dr_neural_network_free(&sample_nn);
+    }
+    for (size_t c = 0; c < nn.connections_count; ++c) {
+        dr_matrix_copy_write(batch_nn.connections[c], nn.connections[c]);
+    }
+    dr_training_workspace_free(&training_workspace);
+    dr_neural_network_free(&batch_nn);
+}
+
+UTEST(dr_neural_network, train_batched) {
+    const size_t layers[]     = { 2, 3, 1 };
+    const size_t layers_count = DR_ARRAY_LENGTH(layers);
+    dr_activation_function activation_functions[]   = { &dr_tanh, &dr_tanh };
+    dr_activation_function activation_functions_d[] = { &dr_tanh_derivative, &dr_tanh_derivative };
+    dr_neural_network nn = dr_neural_network_create(layers, layers_count, activation_functions, activation_functions_d);
+    dr_neural_network_randomize_weights(nn, -1, 1);
+    dr_neural_network expected_nn = dr_neural_network_copy_create(nn);
+
+    const size_t train_data_size = 4;
+    DR_FLOAT_TYPE** inputs       = dr_array_2d_float_alloc(2, train_data_size);
+    DR_FLOAT_TYPE** outputs      = dr_array_2d_float_alloc(1, train_data_size);
+
+    inputs[0][0] = 1; inputs[0][1] = 1;
+    inputs[1][0] = 0; inputs[1][1] = 0;
+    inputs[2][0] = 1; inputs[2][1] = 0;
+    inputs[3][0] = 0; inputs[3][1] = 1;
+
+    outputs[0][0] = 0;
+    outputs[1][0] = 0;
+    outputs[2][0] = 1;
+    outputs[3][0] = 1;
+
+    // the batch of a single sample is the plain SGD
+    dr_neural_network_train(expected_nn, 0.3, 10,
+        (const DR_FLOAT_TYPE**)inputs, (const DR_FLOAT_TYPE**)outputs, train_data_size);
+    dr_neural_network_train_batched(nn, 0.3, 10, 1,
+        (const DR_FLOAT_TYPE**)inputs, (const DR_FLOAT_TYPE**)outputs, train_data_size);
+    for (size_t c = 0; c < nn.connections_count; ++c) {
+        EXPECT_TRUE(dr_matrix_equals(nn.connections[c], expected_nn.connections[c], DR_TESTING_MATRIX_EQUALS_EPSILON));
+    }
+
+    // the last batch is smaller than the others: batches of 3 and 1 samples in every epoch
+    for (size_t epoch = 0; epoch < 2; ++epoch) {
+        dr_testing_neural_network_train_batch_reference(expected_nn, 0.3, inputs, outputs, 3);
+        dr_testing_neural_network_train_batch_reference(expected_nn, 0.3, inputs + 3, outputs + 3, 1);
+    }
+    dr_neural_network_train_batched(nn, 0.3, 2, 3,
+        (const DR_FLOAT_TYPE**)inputs, (const DR_FLOAT_TYPE**)outputs, train_data_size);
+    for (size_t c = 0; c < nn.connections_count; ++c) {
+        EXPECT_TRUE(dr_matrix_equals(nn.connections[c], expected_nn.connections[c], DR_TESTING_MATRIX_EQUALS_EPSILON));
+    }
+
+    dr_neural_network_free(&nn);
+    dr_neural_network_free(&expected_nn);
+    dr_array_2d_float_free(inputs, train_data_size);
+    dr_array_2d_float_free(outputs, train_data_size);
+}
+
 UTEST(dr_neural_network, dr_default_activation_function_to_string) {
     {
         char* str = dr_default_activation_function_to_string(&dr_sigmoid);
@@ -1275,4 +1628,205 @@ UTEST(dr_neural_network, load_from_file) {
         dr_neural_network_free(&nn);
         dr_neural_network_free(&copy_nn);
     }
+}
+
+UTEST(dr_neural_network, activation_function_id) {
+    dr_activation_function functions[] = {
+        &dr_sigmoid, &dr_sigmoid_derivative, &dr_tanh, &dr_tanh_derivative, &dr_relu, &dr_relu_derivative
+    };
+    for (size_t i = 0; i < DR_ARRAY_LENGTH(functions); ++i) {
+        const dr_activation_function_id id = dr_default_activation_function_to_id(functions[i]);
+        EXPECT_NE(id, dr_activation_function_id_none);
+        EXPECT_TRUE(dr_default_activation_function_from_id(id) == functions[i]);
+    }
+    EXPECT_EQ(dr_default_activation_function_to_id(&dr_testing_neural_network_func_double),
+        dr_activation_function_id_none);
+    EXPECT_TRUE(dr_default_activation_function_from_id(dr_activation_function_id_none) == NULL);
+}
+
+UTEST(dr_neural_network, binary_file) {
+    const char* file_path      = "test_binary_file.bin";
+    const char* text_file_path = "test_binary_file.txt";
+
+    const size_t layers[]     = { 5, 3, 7, 2 };
+    const size_t layers_count = DR_ARRAY_LENGTH(layers);
+    dr_activation_function activation_functions[]   = { &dr_sigmoid, &dr_relu, &dr_tanh };
+    dr_activation_function activation_functions_d[] =
+        { &dr_sigmoid_derivative, &dr_relu_derivative, &dr_tanh_derivative };
+    dr_neural_network nn = dr_neural_network_create(layers, layers_count, activation_functions, activation_functions_d);
+    dr_neural_network_randomize_weights(nn, -1, 1);
+
+    // the weights are stored bit for bit
+    EXPECT_TRUE(dr_neural_network_save_to_binary_file(nn, file_path));
+    dr_neural_network loaded_nn = dr_neural_network_load_from_binary_file(file_path);
+    EXPECT_TRUE(dr_neural_network_valid(loaded_nn));
+    EXPECT_TRUE(dr_testing_neural_network_equals(nn, loaded_nn, 0));
+    dr_neural_network_free(&loaded_nn);
+
+    // every connection starts at an aligned offset
+    FILE* file = fopen(file_path, "rb");
+    ASSERT_TRUE(file);
+    unsigned char bytes[1024] = { 0 };
+    const size_t file_size = fread(bytes, 1, sizeof(bytes), file);
+    fclose(file);
+    EXPECT_EQ(memcmp(bytes, DR_NEURAL_NETWORK_BINARY_MAGIC, 4), 0);
+    EXPECT_EQ(bytes[4], DR_NEURAL_NETWORK_BINARY_VERSION);
+    EXPECT_EQ(bytes[12], layers_count);
+    size_t offset = 16 + 4 * layers_count + 8 * (layers_count - 1);
+    for (size_t i = 0; i < nn.connections_count; ++i) {
+        offset = (offset + DR_NEURAL_NETWORK_BINARY_ALIGNMENT - 1) / DR_NEURAL_NETWORK_BINARY_ALIGNMENT *
+            DR_NEURAL_NETWORK_BINARY_ALIGNMENT;
+        EXPECT_EQ(memcmp(bytes + offset, nn.connections[i].elements,
+            sizeof(DR_FLOAT_TYPE) * dr_matrix_size(nn.connections[i])), 0);
+        offset += sizeof(DR_FLOAT_TYPE) * dr_matrix_size(nn.connections[i]);
+    }
+    EXPECT_EQ(file_size, offset);
+
+    // a truncated file is rejected
+    file = fopen(file_path, "wb");
+    ASSERT_TRUE(file);
+    fwrite(bytes, 1, file_size - 1, file);
+    fclose(file);
+    loaded_nn = dr_neural_network_load_from_binary_file(file_path);
+    EXPECT_FALSE(dr_neural_network_valid(loaded_nn));
+
+    // so is another version
+    bytes[4] = DR_NEURAL_NETWORK_BINARY_VERSION + 1;
+    file = fopen(file_path, "wb");
+    ASSERT_TRUE(file);
+    fwrite(bytes, 1, file_size, file);
+    fclose(file);
+    loaded_nn = dr_neural_network_load_from_binary_file(file_path);
+    EXPECT_FALSE(dr_neural_network_valid(loaded_nn));
+
+    loaded_nn = dr_neural_network_load_from_binary_file("test_binary_file_missing.bin");
+    EXPECT_FALSE(dr_neural_network_valid(loaded_nn));
+
+    // and a header whose sizes overflow, nothing is allocated for it
+    dr_testing_neural_network_write_overflowing_binary_file(file_path);
+    loaded_nn = dr_neural_network_load_from_binary_file(file_path);
+    EXPECT_FALSE(dr_neural_network_valid(loaded_nn));
+
+    // the converter keeps what the text format stores
+    EXPECT_TRUE(dr_neural_network_save_to_file(nn, text_file_path));
+    EXPECT_TRUE(dr_neural_network_convert_text_file_to_binary_file(text_file_path, file_path));
+    loaded_nn = dr_neural_network_load_from_binary_file(file_path);
+    EXPECT_TRUE(dr_neural_network_valid(loaded_nn));
+    EXPECT_TRUE(dr_testing_neural_network_equals(nn, loaded_nn, 0.001));
+    dr_neural_network_free(&loaded_nn);
+
+    // activation functions without an id can't be saved
+    nn.activation_functions[1] = &dr_testing_neural_network_func_double;
+    EXPECT_FALSE(dr_neural_network_save_to_binary_file(nn, file_path));
+
+    dr_neural_network_free(&nn);
+}
+
+UTEST(dr_neural_network, load_mmap) {
+    const char* file_path = "test_load_mmap.bin";
+
+    const size_t layers[]     = { 9, 17, 4 };
+    const size_t layers_count = DR_ARRAY_LENGTH(layers);
+    dr_activation_function activation_functions[]   = { &dr_relu, &dr_sigmoid };
+    dr_activation_function activation_functions_d[] = { &dr_relu_derivative, &dr_sigmoid_derivative };
+    dr_neural_network nn = dr_neural_network_create(layers, layers_count, activation_functions, activation_functions_d);
+    dr_neural_network_randomize_weights(nn, -1, 1);
+    ASSERT_TRUE(dr_neural_network_save_to_binary_file(nn, file_path));
+
+    dr_neural_network mapped_nn = dr_neural_network_load_mmap(file_path);
+    ASSERT_TRUE(dr_neural_network_valid(mapped_nn));
+    EXPECT_TRUE(dr_testing_neural_network_equals(nn, mapped_nn, 0));
+
+    // the connections are aligned views of the mapping
+    ASSERT_TRUE(mapped_nn.mapping != NULL);
+    const char* mapping_begin = (const char*)mapped_nn.mapping->data;
+    const char* mapping_end   = mapping_begin + mapped_nn.mapping->size;
+    for (size_t i = 0; i < mapped_nn.connections_count; ++i) {
+        const char* elements = (const char*)mapped_nn.connections[i].elements;
+        EXPECT_TRUE(elements >= mapping_begin);
+        EXPECT_TRUE(elements + sizeof(DR_FLOAT_TYPE) * dr_matrix_size(mapped_nn.connections[i]) <= mapping_end);
+        const size_t elements_misalignment = (size_t)(elements - mapping_begin) % DR_NEURAL_NETWORK_BINARY_ALIGNMENT;
+        EXPECT_EQ(elements_misalignment, 0);
+    }
+
+    DR_FLOAT_TYPE input[9] = { 0 };
+    for (size_t i = 0; i < DR_ARRAY_LENGTH(input); ++i) {
+        input[i] = dr_random_float(0, 1);
+    }
+    DR_FLOAT_TYPE expected_prediction[4] = { 0 };
+    DR_FLOAT_TYPE prediction[4]          = { 0 };
+    dr_neural_network_prediction_write(nn, input, expected_prediction);
+    dr_neural_network_prediction_write(mapped_nn, input, prediction);
+    EXPECT_TRUE(dr_testing_matrix_array_equals(DR_ARRAY_LENGTH(prediction), expected_prediction, prediction));
+
+    // a copy owns its weights
+    dr_neural_network copy_nn = dr_neural_network_copy_create(mapped_nn);
+    EXPECT_TRUE(copy_nn.mapping == NULL);
+    EXPECT_TRUE(dr_testing_neural_network_equals(nn, copy_nn, 0));
+    dr_neural_network_free(&copy_nn);
+
+    dr_neural_network_free(&mapped_nn);
+    EXPECT_TRUE(mapped_nn.mapping == NULL);
+    EXPECT_FALSE(dr_neural_network_valid(mapped_nn));
+
+    // a truncated file is rejected
+    FILE* file = fopen(file_path, "rb");
+    ASSERT_TRUE(file);
+    unsigned char bytes[1024] = { 0 };
+    const size_t file_size = fread(bytes, 1, sizeof(bytes), file);
+    fclose(file);
+    file = fopen(file_path, "wb");
+    ASSERT_TRUE(file);
+    fwrite(bytes, 1, file_size - 1, file);
+    fclose(file);
+    mapped_nn = dr_neural_network_load_mmap(file_path);
+    EXPECT_FALSE(dr_neural_network_valid(mapped_nn));
+
+    mapped_nn = dr_neural_network_load_mmap("test_load_mmap_missing.bin");
+    EXPECT_FALSE(dr_neural_network_valid(mapped_nn));
+
+    // so is a header whose sizes overflow: 2^31 * 2^31 * 4 bytes wrap around to 0 in 64 bits
+    dr_testing_neural_network_write_overflowing_binary_file(file_path);
+    mapped_nn = dr_neural_network_load_mmap(file_path);
+    EXPECT_FALSE(dr_neural_network_valid(mapped_nn));
+
+    dr_neural_network_free(&nn);
+}
+
+UTEST(dr_neural_network, train_sample_bytes) {
+    const size_t layers[]     = { 19, 6, 3 };
+    const size_t layers_count = DR_ARRAY_LENGTH(layers);
+    dr_activation_function activation_functions[]   = { &dr_sigmoid, &dr_sigmoid };
+    dr_activation_function activation_functions_d[] = { &dr_sigmoid_derivative, &dr_sigmoid_derivative };
+    dr_neural_network nn = dr_neural_network_create(layers, layers_count, activation_functions, activation_functions_d);
+    dr_neural_network_randomize_weights(nn, -1, 1);
+    dr_neural_network bytes_nn = dr_neural_network_copy_create(nn);
+    dr_training_workspace workspace       = dr_training_workspace_create(nn);
+    dr_training_workspace bytes_workspace = dr_training_workspace_create(bytes_nn);
+
+    const DR_FLOAT_TYPE scale = (DR_FLOAT_TYPE)(1.0 / 255.0);
+    unsigned char input_bytes[19] = { 0 };
+    DR_FLOAT_TYPE input[19]       = { 0 };
+    for (size_t i = 0; i < DR_ARRAY_LENGTH(input_bytes); ++i) {
+        input_bytes[i] = (unsigned char)(rand() % 256);
+        input[i]       = input_bytes[i] * scale;
+    }
+
+    dr_neural_network_set_input_bytes(bytes_nn, input_bytes, scale);
+    EXPECT_TRUE(dr_testing_matrix_array_equals(DR_ARRAY_LENGTH(input), input, bytes_nn.layers[0].elements));
+
+    // the converted input gives exactly the same step
+    const DR_FLOAT_TYPE output[3] = { 0, 1, 0 };
+    for (size_t step = 0; step < 5; ++step) {
+        const DR_FLOAT_TYPE error_sum = dr_neural_network_train_sample(nn, workspace, 0.1, input, output);
+        const DR_FLOAT_TYPE bytes_error_sum =
+            dr_neural_network_train_sample_bytes(bytes_nn, bytes_workspace, 0.1, input_bytes, scale, output);
+        EXPECT_EQ(error_sum, bytes_error_sum);
+    }
+    EXPECT_TRUE(dr_testing_neural_network_equals(nn, bytes_nn, 0));
+
+    dr_training_workspace_free(&workspace);
+    dr_training_workspace_free(&bytes_workspace);
+    dr_neural_network_free(&nn);
+    dr_neural_network_free(&bytes_nn);
 }
\ No newline at end of file
@@ -0,0 +1,112 @@
+#include <dr_testing_neural_network.h>
+#include <neural_network/dr_neural_network_snapshots.h>
+
+#define DR_TESTING_SNAPSHOTS_PUBLICATIONS_COUNT 2000
+
+static const size_t dr_testing_snapshots_layers[] = { 6, 5, 4, 3 };
+
+static dr_neural_network dr_testing_snapshots_neural_network_create() {
+    return dr_neural_network_create(dr_testing_snapshots_layers, DR_ARRAY_LENGTH(dr_testing_snapshots_layers),
+        DR_TESTING_NN_AF_PLUG, DR_TESTING_NN_AFD_PLUG);
+}
+
+static void dr_testing_snapshots_fill(const dr_neural_network neural_network, const DR_FLOAT_TYPE value) {
+    for (size_t i = 0; i < neural_network.connections_count; ++i) {
+        dr_matrix_fill(neural_network.connections[i], value);
+    }
+}
+
+// returns the value every connection is filled with, -1 if the connections differ
+static DR_FLOAT_TYPE dr_testing_snapshots_filled_value(const dr_neural_network neural_network) {
+    const DR_FLOAT_TYPE value = neural_network.connections[0].elements[0];
+    for (size_t i = 0; i < neural_network.connections_count; ++i) {
+        const dr_matrix connection = neural_network.connections[i];
+        for (size_t j = 0; j < dr_matrix_size(connection); ++j) {
+            if (connection.elements[j] != value) {
+                return -1;
+            }
+        }
+    }
+    return value;
+}
+
+static dr_thread_function_result_t DR_WINAPI dr_testing_snapshots_writer(void* data) {
+    dr_neural_network_snapshots* snapshots = (dr_neural_network_snapshots*)data;
+    dr_neural_network neural_network = dr_testing_snapshots_neural_network_create();
+    for (size_t i = 1; i <= DR_TESTING_SNAPSHOTS_PUBLICATIONS_COUNT; ++i) {
+        dr_testing_snapshots_fill(neural_network, (DR_FLOAT_TYPE)i);
+        dr_neural_network_snapshots_publish(snapshots, neural_network);
+    }
+    dr_neural_network_free(&neural_network);
+    return 0;
+}
+
+UTEST(dr_neural_network_snapshots, publish_acquire) {
+    dr_neural_network neural_network = dr_testing_snapshots_neural_network_create();
+    dr_testing_snapshots_fill(neural_network, 1);
+    dr_neural_network_snapshots* snapshots = dr_neural_network_snapshots_create(neural_network, 0);
+    ASSERT_TRUE(snapshots);
+
+    dr_neural_network snapshot = dr_neural_network_snapshots_acquire(snapshots);
+    EXPECT_TRUE(dr_neural_network_valid(snapshot));
+    EXPECT_TRUE(snapshot.connections != neural_network.connections);
+    EXPECT_EQ(dr_testing_snapshots_filled_value(snapshot), 1);
+
+    // the training goes on, the snapshot doesn't change until the weights are published
+    dr_testing_snapshots_fill(neural_network, 2);
+    EXPECT_EQ(dr_testing_snapshots_filled_value(dr_neural_network_snapshots_acquire(snapshots)), 1);
+    dr_neural_network_snapshots_publish(snapshots, neural_network);
+    dr_testing_snapshots_fill(neural_network, 3);
+    snapshot = dr_neural_network_snapshots_acquire(snapshots);
+    EXPECT_EQ(dr_testing_snapshots_filled_value(snapshot), 2);
+
+    // the latest of several publications is taken
+    dr_neural_network_snapshots_publish(snapshots, neural_network);
+    dr_testing_snapshots_fill(neural_network, 4);
+    dr_neural_network_snapshots_publish(snapshots, neural_network);
+    EXPECT_EQ(dr_testing_snapshots_filled_value(snapshot), 2);
+    EXPECT_EQ(dr_testing_snapshots_filled_value(dr_neural_network_snapshots_acquire(snapshots)), 4);
+    EXPECT_EQ(dr_testing_snapshots_filled_value(dr_neural_network_snapshots_acquire(snapshots)), 4);
+
+    dr_neural_network_snapshots_free(snapshots);
+    dr_neural_network_free(&neural_network);
+}
+
+UTEST(dr_neural_network_snapshots, publish_throttled) {
+    dr_neural_network neural_network = dr_testing_snapshots_neural_network_create();
+    dr_testing_snapshots_fill(neural_network, 1);
+    dr_neural_network_snapshots* snapshots = dr_neural_network_snapshots_create(neural_network, 1000);
+
+    dr_testing_snapshots_fill(neural_network, 2);
+    EXPECT_TRUE(dr_neural_network_snapshots_publish_throttled(snapshots, neural_network));
+    dr_testing_snapshots_fill(neural_network, 3);
+    EXPECT_FALSE(dr_neural_network_snapshots_publish_throttled(snapshots, neural_network));
+    EXPECT_EQ(dr_testing_snapshots_filled_value(dr_neural_network_snapshots_acquire(snapshots)), 2);
+
+    dr_neural_network_snapshots_free(snapshots);
+    dr_neural_network_free(&neural_network);
+}
+
+UTEST(dr_neural_network_snapshots, concurrent_acquire) {
+    dr_neural_network neural_network = dr_testing_snapshots_neural_network_create();
+    dr_testing_snapshots_fill(neural_network, 0);
+    dr_neural_network_snapshots* snapshots = dr_neural_network_snapshots_create(neural_network, 0);
+
+    dr_thread_id_t thread_id;
+    dr_thread_handle_t thread_handle = dr_thread_create_with_data(&thread_id, dr_testing_snapshots_writer, snapshots);
+    ASSERT_TRUE(dr_check_thread_handle(thread_handle));
+
+    // every snapshot holds the weights of a single publication and they never go back
+    DR_FLOAT_TYPE last_value = 0;
+    DR_FLOAT_TYPE value      = 0;
+    do {
+        value = dr_testing_snapshots_filled_value(dr_neural_network_snapshots_acquire(snapshots));
+        ASSERT_TRUE(value >= last_value);
+        last_value = value;
+    } while (value < DR_TESTING_SNAPSHOTS_PUBLICATIONS_COUNT);
+
+    EXPECT_TRUE(dr_thread_join(thread_handle, thread_id));
+    EXPECT_TRUE(dr_thread_close(thread_handle));
+    dr_neural_network_snapshots_free(snapshots);
+    dr_neural_network_free(&neural_network);
+}
\ No newline at end of file
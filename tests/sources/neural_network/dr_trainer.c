@@ -0,0 +1,156 @@
+#include <dr_testing_neural_network.h>
+#include <neural_network/dr_trainer.h>
+
+UTEST(dr_trainer, train) {
+    const size_t layers[]     = { 6, 5, 4, 3 };
+    const size_t layers_count = DR_ARRAY_LENGTH(layers);
+    dr_neural_network initial_nn = dr_neural_network_create(
+        layers, layers_count, DR_TESTING_NN_AF_PLUG, DR_TESTING_NN_AFD_PLUG);
+    dr_neural_network_randomize_weights(initial_nn, -1, 1);
+
+    const size_t train_data_size = 23;
+    DR_FLOAT_TYPE** inputs       = dr_array_2d_float_alloc(layers[0], train_data_size);
+    DR_FLOAT_TYPE** outputs      = dr_array_2d_float_alloc(layers[layers_count - 1], train_data_size);
+    for (size_t i = 0; i < train_data_size; ++i) {
+        for (size_t j = 0; j < layers[0]; ++j) {
+            inputs[i][j] = dr_random_float(-1, 1);
+        }
+        for (size_t j = 0; j < layers[layers_count - 1]; ++j) {
+            outputs[i][j] = dr_random_float(0, 1);
+        }
+    }
+
+    // the batch is split between the threads, the result should be the same as of the batched training
+    const size_t batch_sizes[]   = { 1, 2, 5, 8 };
+    const size_t threads_count[] = { 1, 2, 3, 4 };
+    for (size_t b = 0; b < DR_ARRAY_LENGTH(batch_sizes); ++b) {
+        dr_neural_network expected_nn = dr_neural_network_copy_create(initial_nn);
+        dr_neural_network_train_batched(expected_nn, 0.05, 2, batch_sizes[b],
+            (const DR_FLOAT_TYPE**)inputs, (const DR_FLOAT_TYPE**)outputs, train_data_size);
+
+        for (size_t t = 0; t < DR_ARRAY_LENGTH(threads_count); ++t) {
+            dr_neural_network nn = dr_neural_network_copy_create(initial_nn);
+            dr_trainer* trainer  = dr_trainer_create(nn, batch_sizes[b], threads_count[t]);
+            EXPECT_EQ(trainer->threads_count, threads_count[t]);
+            dr_trainer_train(trainer, 0.05, 2,
+                (const DR_FLOAT_TYPE**)inputs, (const DR_FLOAT_TYPE**)outputs, train_data_size);
+            dr_trainer_free(trainer);
+
+            for (size_t c = 0; c < nn.connections_count; ++c) {
+                EXPECT_TRUE(dr_matrix_equals(nn.connections[c], expected_nn.connections[c],
+                    DR_TESTING_MATRIX_EQUALS_EPSILON));
+            }
+            dr_neural_network_free(&nn);
+        }
+
+        dr_neural_network_free(&expected_nn);
+    }
+
+    dr_neural_network_free(&initial_nn);
+    dr_array_2d_float_free(inputs, train_data_size);
+    dr_array_2d_float_free(outputs, train_data_size);
+}
+
+UTEST(dr_trainer, train_batch_error) {
+    const size_t layers[]     = { 3, 4, 2 };
+    const size_t layers_count = DR_ARRAY_LENGTH(layers);
+    dr_neural_network nn = dr_neural_network_create(
+        layers, layers_count, DR_TESTING_NN_AF_PLUG, DR_TESTING_NN_AFD_PLUG);
+    dr_neural_network_randomize_weights(nn, -1, 1);
+    dr_neural_network expected_nn = dr_neural_network_copy_create(nn);
+
+    const size_t train_data_size = 6;
+    DR_FLOAT_TYPE** inputs       = dr_array_2d_float_alloc(layers[0], train_data_size);
+    DR_FLOAT_TYPE** outputs      = dr_array_2d_float_alloc(layers[layers_count - 1], train_data_size);
+    for (size_t i = 0; i < train_data_size; ++i) {
+        for (size_t j = 0; j < layers[0]; ++j) {
+            inputs[i][j] = dr_random_float(-1, 1);
+        }
+        for (size_t j = 0; j < layers[layers_count - 1]; ++j) {
+            outputs[i][j] = dr_random_float(0, 1);
+        }
+    }
+
+    dr_batch_workspace batch_workspace = dr_batch_workspace_create(expected_nn, train_data_size);
+    const DR_FLOAT_TYPE expected_error = dr_neural_network_train_batch(expected_nn, batch_workspace, 0.1,
+        (const DR_FLOAT_TYPE**)inputs, (const DR_FLOAT_TYPE**)outputs, train_data_size);
+
+    dr_trainer* trainer = dr_trainer_create(nn, train_data_size, 4);
+    const DR_FLOAT_TYPE error = dr_trainer_train_batch(trainer, 0.1,
+        (const DR_FLOAT_TYPE**)inputs, (const DR_FLOAT_TYPE**)outputs, train_data_size);
+    EXPECT_NEAR(error, expected_error, DR_TESTING_MATRIX_EQUALS_EPSILON);
+    dr_trainer_free(trainer);
+
+    for (size_t c = 0; c < nn.connections_count; ++c) {
+        EXPECT_TRUE(dr_matrix_equals(nn.connections[c], expected_nn.connections[c], DR_TESTING_MATRIX_EQUALS_EPSILON));
+    }
+
+    dr_batch_workspace_free(&batch_workspace);
+    dr_neural_network_free(&nn);
+    dr_neural_network_free(&expected_nn);
+    dr_array_2d_float_free(inputs, train_data_size);
+    dr_array_2d_float_free(outputs, train_data_size);
+}
+
+UTEST(dr_trainer, train_hogwild) {
+    const size_t layers[]     = { 2, 8, 1 };
+    const size_t layers_count = DR_ARRAY_LENGTH(layers);
+    dr_activation_function activation_functions[]   = { &dr_tanh, &dr_tanh };
+    dr_activation_function activation_functions_d[] = { &dr_tanh_derivative, &dr_tanh_derivative };
+    dr_neural_network initial_nn = dr_neural_network_create(
+        layers, layers_count, activation_functions, activation_functions_d);
+    dr_neural_network_randomize_weights(initial_nn, -1, 1);
+
+    const size_t train_data_size = 64;
+    DR_FLOAT_TYPE** inputs       = dr_array_2d_float_alloc(2, train_data_size);
+    DR_FLOAT_TYPE** outputs      = dr_array_2d_float_alloc(1, train_data_size);
+    for (size_t i = 0; i < train_data_size; ++i) {
+        inputs[i][0]  = i & 1;
+        inputs[i][1]  = (i >> 1) & 1;
+        outputs[i][0] = (i & 1) != ((i >> 1) & 1);
+    }
+
+    // a single worker is the plain SGD
+    {
+        dr_neural_network expected_nn = dr_neural_network_copy_create(initial_nn);
+        dr_neural_network_train(expected_nn, 0.1, 3,
+            (const DR_FLOAT_TYPE**)inputs, (const DR_FLOAT_TYPE**)outputs, train_data_size);
+
+        dr_neural_network nn = dr_neural_network_copy_create(initial_nn);
+        dr_trainer* trainer  = dr_trainer_create_hogwild(nn, 16, 1);
+        EXPECT_EQ(trainer->mode, dr_trainer_mode_hogwild);
+        dr_trainer_train(trainer, 0.1, 3,
+            (const DR_FLOAT_TYPE**)inputs, (const DR_FLOAT_TYPE**)outputs, train_data_size);
+        dr_trainer_free(trainer);
+
+        for (size_t c = 0; c < nn.connections_count; ++c) {
+            EXPECT_TRUE(dr_matrix_equals(nn.connections[c], expected_nn.connections[c],
+                DR_TESTING_MATRIX_EQUALS_EPSILON));
+        }
+        dr_neural_network_free(&nn);
+        dr_neural_network_free(&expected_nn);
+    }
+
+    // the order of the updates of several workers is not defined, but the network still learns
+    {
+        dr_neural_network nn = dr_neural_network_copy_create(initial_nn);
+        dr_trainer* trainer  = dr_trainer_create_hogwild(nn, train_data_size, 4);
+        const DR_FLOAT_TYPE** train_inputs  = (const DR_FLOAT_TYPE**)inputs;
+        const DR_FLOAT_TYPE** train_outputs = (const DR_FLOAT_TYPE**)outputs;
+        for (size_t epoch = 0; epoch < 300; ++epoch) {
+            dr_trainer_train_batch(trainer, 0.1, train_inputs, train_outputs, train_data_size);
+        }
+        dr_trainer_free(trainer);
+
+        for (size_t i = 0; i < 4; ++i) {
+            DR_FLOAT_TYPE prediction = 0;
+            dr_neural_network_prediction_write(nn, inputs[i], &prediction);
+            EXPECT_NEAR(roundf(prediction), outputs[i][0], 0.001);
+        }
+        dr_neural_network_free(&nn);
+    }
+
+    dr_neural_network_free(&initial_nn);
+    dr_array_2d_float_free(inputs, train_data_size);
+    dr_array_2d_float_free(outputs, train_data_size);
+}
\ No newline at end of file